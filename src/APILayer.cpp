@@ -3,17 +3,92 @@
 
 #include "APILayer.hpp"
 
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <unordered_map>
+
 #include "APILayerStore.hpp"
 
 namespace FredEmmott::OpenXRLayers {
+
+namespace {
+class KeyTable final {
+ public:
+  static KeyTable& Get() {
+    static KeyTable sInstance;
+    return sInstance;
+  }
+
+  uint32_t Intern(const std::string_view value) {
+    {
+      const std::shared_lock lock(mMutex);
+      if (const auto it = mIDs.find(value); it != mIDs.end()) {
+        return it->second;
+      }
+    }
+
+    const std::unique_lock lock(mMutex);
+    // Check again, in case another thread added it while we were unlocked
+    if (const auto it = mIDs.find(value); it != mIDs.end()) {
+      return it->second;
+    }
+    if (mValues.size() == std::numeric_limits<uint32_t>::max()) [[unlikely]] {
+      throw std::length_error("Too many APILayer keys");
+    }
+    const auto id = static_cast<uint32_t>(mValues.size());
+    // std::deque never moves existing elements, so the string_view key in
+    // mIDs stays valid
+    const auto& stored = mValues.emplace_back(value);
+    mIDs.emplace(stored, id);
+    return id;
+  }
+
+  const std::string& GetValue(const uint32_t id) {
+    const std::shared_lock lock(mMutex);
+    return mValues.at(id);
+  }
+
+ private:
+  KeyTable() {
+    // ID 0 is the default-constructed Key
+    Intern({});
+  }
+
+  std::shared_mutex mMutex;
+  std::deque<std::string> mValues;
+  std::unordered_map<std::string_view, uint32_t> mIDs;
+};
+
+std::string ToUTF8(const std::filesystem::path& path) {
+  const auto u8 = path.u8string();
+  return {reinterpret_cast<const char*>(u8.data()), u8.size()};
+}
+}// namespace
+
+APILayer::Key::Key(const std::string_view value)
+  : mID(KeyTable::Get().Intern(value)) {}
+
+const std::string& APILayer::Key::GetValue() const {
+  return KeyTable::Get().GetValue(mID);
+}
+
 APILayer::APILayer(
   const APILayerStore* source,
   const std::filesystem::path& manifestPath,
   const Value value)
   : mSource(source),
-    mManifestPath(manifestPath),
     mValue(value),
-    mKey(manifestPath.string()),
-    mArchitectures(source->GetArchitectures()) {}
+    mArchitectures(source->GetArchitectures()) {
+  this->SetManifestPath(manifestPath);
+  mKey = mDisplayPath;
+}
+
+void APILayer::SetManifestPath(const std::filesystem::path& path) {
+  mManifestPath = path;
+  mDisplayPath = Key {ToUTF8(path)};
+}
 
-}// namespace FredEmmott::OpenXRLayers
\ No newline at end of file
+}// namespace FredEmmott::OpenXRLayers
@@ -4,11 +4,15 @@
 #pragma once
 
 #include <compare>
+#include <cstdint>
 #include <expected>
 #include <filesystem>
+#include <string>
+#include <string_view>
 
 #include "APILayerSignature.hpp"
 #include "Architectures.hpp"
+#include "Version.hpp"
 
 namespace FredEmmott::OpenXRLayers {
 
@@ -22,10 +26,32 @@ class APILayerStore;
  * Manifest data is available via `APILayerDetails`.
  */
 struct APILayer {
-  struct Key {
-    std::string mValue;
-
-    constexpr auto operator<=>(const Key&) const = default;
+  /** An interned string identifying a layer.
+   *
+   * Values are stored once in a global table; keys are 32-bit indices into
+   * that table, so copying, comparing, and hashing them are integer
+   * operations.
+   *
+   * Keys are ordered by when they were first interned, not by value.
+   */
+  class Key {
+   public:
+    Key() = default;
+    explicit Key(std::string_view value);
+
+    [[nodiscard]]
+    const std::string& GetValue() const;
+
+    [[nodiscard]]
+    constexpr uint32_t GetID() const noexcept {
+      return mID;
+    }
+
+    constexpr auto operator<=>(const Key&) const noexcept = default;
+
+   private:
+    // 0 is the empty string
+    uint32_t mID {};
   };
 
   enum class Value {
@@ -49,7 +75,7 @@ struct APILayer {
     const std::string_view name,
     const Value value) {
     APILayer ret {source, {}, value};
-    ret.mKey.mValue = name;
+    ret.mKey = Key {name};
     ret.mArchitectures = {Architecture::Invalid};
     return ret;
   }
@@ -62,8 +88,21 @@ struct APILayer {
   [[nodiscard]]
   Kind GetKind() const noexcept;
 
+  [[nodiscard]]
+  const std::filesystem::path& GetManifestPath() const noexcept {
+    return mManifestPath;
+  }
+
+  /// The manifest path as UTF-8, converted once
+  [[nodiscard]]
+  const std::string& GetDisplayPath() const {
+    return mDisplayPath.GetValue();
+  }
+
+  /// Does not change the key
+  void SetManifestPath(const std::filesystem::path&);
+
   const APILayerStore* mSource {nullptr};
-  std::filesystem::path mManifestPath;
   Value mValue;
   Architectures mArchitectures;
 
@@ -72,7 +111,13 @@ struct APILayer {
     return mValue == Value::Enabled;
   };
 
-  bool operator==(const APILayer&) const noexcept = default;
+  bool operator==(const APILayer& other) const noexcept {
+    // All integer comparisons; the display path is interned, and is derived
+    // from the manifest path, so it can be compared instead
+    return mKey == other.mKey && mDisplayPath == other.mDisplayPath
+      && mSource == other.mSource && mValue == other.mValue
+      && mArchitectures == other.mArchitectures;
+  }
 
   operator Key() const noexcept {
     return GetKey();
@@ -86,6 +131,9 @@ struct APILayer {
   APILayer() = default;
 
   Key mKey;
+  std::filesystem::path mManifestPath;
+  // Not a std::string, so that copying layers does not copy it
+  Key mDisplayPath;
 };
 
 struct Extension {
@@ -121,6 +169,11 @@ struct APILayerDetails {
   std::string mEnableEnvironment;
   std::vector<Extension> mExtensions;
 
+  // Parsed from the strings above; nullopt if missing or invalid
+  std::optional<Version> mParsedFileFormatVersion;
+  std::optional<Version> mParsedAPIVersion;
+  std::optional<Version> mParsedImplementationVersion;
+
   std::filesystem::file_time_type mManifestFilesystemChangeTime;
   std::filesystem::file_time_type mLibraryFilesystemChangeTime;
 
@@ -136,6 +189,6 @@ template <>
 struct std::hash<FredEmmott::OpenXRLayers::APILayer::Key> {
   static auto operator()(
     const FredEmmott::OpenXRLayers::APILayer::Key& key) noexcept {
-    return std::hash<std::string> {}(key.mValue);
+    return std::hash<uint32_t> {}(key.GetID());
   }
 };
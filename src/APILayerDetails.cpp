@@ -32,6 +32,15 @@ static void SetStringOrNumber(
   }
 }
 
+static void SetVersion(
+  std::string& variable,
+  std::optional<Version>& parsed,
+  const nlohmann::json& json,
+  const auto& key) {
+  SetStringOrNumber(variable, json, key);
+  parsed = Version::Parse(variable);
+}
+
 APILayer::Kind APILayer::GetKind() const noexcept {
   if (!mSource) {
     /// If we didn't find it in the registry or manifest locations,
@@ -62,7 +71,8 @@ APILayerDetails::APILayerDetails(const std::filesystem::path& jsonPath) {
     return;
   }
 
-  mFileFormatVersion = json.value("file_format_version", std::string {});
+  SetVersion(
+    mFileFormatVersion, mParsedFileFormatVersion, json, "file_format_version");
   if (!json.contains("api_layer")) {
     mState = State::MissingData;
     return;
@@ -86,7 +96,7 @@ APILayerDetails::APILayerDetails(const std::filesystem::path& jsonPath) {
     }
   }
 
-  mAPIVersion = layer.value("api_version", std::string {});
+  SetVersion(mAPIVersion, mParsedAPIVersion, layer, "api_version");
   mDescription = layer.value("description", std::string {});
 
   if (layer.contains("disable_environment")) {
@@ -112,7 +122,11 @@ APILayerDetails::APILayerDetails(const std::filesystem::path& jsonPath) {
     }
   }
 
-  SetStringOrNumber(mImplementationVersion, layer, "implementation_version");
+  SetVersion(
+    mImplementationVersion,
+    mParsedImplementationVersion,
+    layer,
+    "implementation_version");
 
   auto& platform = Platform::Get();
   try {
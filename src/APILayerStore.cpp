@@ -0,0 +1,30 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "APILayerStore.hpp"
+
+namespace FredEmmott::OpenXRLayers {
+
+std::shared_ptr<const StoreSnapshot> APILayerStore::GetSnapshot() const {
+  if (auto snapshot = mSnapshot.load();
+      snapshot && snapshot->mGeneration == mGeneration.load()) {
+    return snapshot;
+  }
+
+  const std::unique_lock lock(mSnapshotMutex);
+  // Another thread may have rebuilt it while we were waiting for the lock
+  if (auto snapshot = mSnapshot.load();
+      snapshot && snapshot->mGeneration == mGeneration.load()) {
+    return snapshot;
+  }
+
+  // Read the generation first: if the store changes while we are reading it,
+  // this snapshot is already stale, and will be rebuilt by the next caller
+  const auto generation = mGeneration.load();
+  auto snapshot = std::make_shared<const StoreSnapshot>(
+    generation, this->GetAPILayers());
+  mSnapshot.store(snapshot);
+  return snapshot;
+}
+
+}// namespace FredEmmott::OpenXRLayers
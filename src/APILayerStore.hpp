@@ -4,6 +4,10 @@
 #pragma once
 #include <boost/signals2.hpp>
 
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <span>
 #include <vector>
 
@@ -13,6 +17,13 @@
 
 namespace FredEmmott::OpenXRLayers {
 
+/// An immutable copy of a store's layers
+struct StoreSnapshot {
+  /// Increases each time the store changes
+  uint64_t mGeneration {};
+  std::vector<APILayer> mLayers;
+};
+
 class APILayerStore {
  public:
   virtual ~APILayerStore() = default;
@@ -21,7 +32,22 @@ class APILayerStore {
 
   // e.g. "Win64-HKLM"
   virtual std::string GetDisplayName() const noexcept = 0;
+  /// Read the layers from the underlying storage; prefer `GetSnapshot()`
   virtual std::vector<APILayer> GetAPILayers() const noexcept = 0;
+
+  /** The current layers.
+   *
+   * Snapshots are only rebuilt after the store changes, so repeated calls are
+   * cheap, and a snapshot can be shared between threads without copying or
+   * locking.
+   */
+  [[nodiscard]]
+  std::shared_ptr<const StoreSnapshot> GetSnapshot() const;
+
+  [[nodiscard]]
+  uint64_t GetGeneration() const noexcept {
+    return mGeneration.load();
+  }
   virtual Architectures GetArchitectures() const noexcept = 0;
   // e.g. if we're a 64-bit build, we won't see 32-bit layers
   [[nodiscard]]
@@ -38,16 +64,40 @@ class APILayerStore {
 
  protected:
   void NotifyChange() {
+    InvalidateSnapshot();
     mOnChangeSignal();
   }
 
+  /// Rebuild the snapshot on next use, without notifying subscribers
+  void InvalidateSnapshot() const noexcept {
+    ++mGeneration;
+  }
+
  private:
   boost::signals2::signal<void()> mOnChangeSignal;
+
+  mutable std::atomic<uint64_t> mGeneration {1};
+  mutable std::atomic<std::shared_ptr<const StoreSnapshot>> mSnapshot;
+  // Held while rebuilding, so concurrent readers do not all rebuild
+  mutable std::mutex mSnapshotMutex;
 };
 
 class ReadWriteAPILayerStore : public virtual APILayerStore {
  public:
   virtual bool SetAPILayers(const std::vector<APILayer>&) const noexcept = 0;
+
+  /** Replace `before` with `after`, without re-reading the store.
+   *
+   * `before` must be the current contents of the store, e.g. a snapshot that
+   * has been checked against the current generation; use
+   * `LayerStoreTransaction` rather than calling this directly.
+   *
+   * Returns false if any write fails, in which case the store may have been
+   * partially written.
+   */
+  virtual bool WriteAPILayers(
+    const std::vector<APILayer>& before,
+    const std::vector<APILayer>& after) const noexcept = 0;
 };
 
 }// namespace FredEmmott::OpenXRLayers
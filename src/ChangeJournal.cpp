@@ -0,0 +1,708 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "ChangeJournal.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <random>
+#include <ranges>
+#include <sstream>
+#include <utility>
+
+#include "Compression.hpp"
+#include "Config.hpp"
+#include "FileLock.hpp"
+#include "Platform.hpp"
+
+namespace FredEmmott::OpenXRLayers {
+
+namespace {
+
+// Larger `Z` blocks are assumed to be corrupt
+constexpr std::size_t MaxBlockSize = 64 * 1024 * 1024;
+
+std::string ToUTF8(const std::filesystem::path& path) {
+  const auto utf8 = path.u8string();
+  return {reinterpret_cast<const char*>(utf8.data()), utf8.size()};
+}
+
+std::filesystem::path FromUTF8(const std::string_view utf8) {
+  return std::u8string_view {
+    reinterpret_cast<const char8_t*>(utf8.data()), utf8.size()};
+}
+
+template <class T>
+std::optional<T> ParseNumber(const std::string_view value) {
+  T ret {};
+  const auto end = value.data() + value.size();
+  if (const auto [ptr, ec] = std::from_chars(value.data(), end, ret);
+      ec == std::errc {} && ptr == end) {
+    return ret;
+  }
+  return std::nullopt;
+}
+
+std::filesystem::path GetLockPath(const std::filesystem::path& path) {
+  auto ret = path;
+  ret += ".lock";
+  return ret;
+}
+
+uint64_t MakeFileID() {
+  std::mt19937_64 random {std::random_device {}()};
+  // 0 means there is no ID
+  return std::uniform_int_distribution<uint64_t> {1}(random);
+}
+
+/// The ID in the `J` record at the start of the file, or 0 if there is none
+uint64_t ReadFileID(std::istream& f) {
+  std::string line;
+  if (!(std::getline(f, line) && line.starts_with("J\t"))) {
+    return 0;
+  }
+  return ParseNumber<uint64_t>(std::string_view {line}.substr(2)).value_or(0);
+}
+
+bool EndsWithNewline(const std::filesystem::path& path) {
+  std::ifstream f(path, std::ios::binary);
+  f.seekg(-1, std::ios::end);
+  return f.get() == '\n';
+}
+
+/** Read and decompress the data following a `Z` record.
+ *
+ * The stream is left after the block, even if it can not be decompressed.
+ */
+std::optional<std::string> ReadBlock(
+  std::istream& f,
+  const std::span<const std::string_view> fields) {
+  if (fields.size() != 4 || fields[1].size() != 1) {
+    return std::nullopt;
+  }
+  const auto algorithm = static_cast<Compression::Algorithm>(fields[1].front());
+  const auto size = ParseNumber<std::size_t>(fields[2]);
+  const auto decompressedSize = ParseNumber<std::size_t>(fields[3]);
+  if (!(size && decompressedSize)) {
+    return std::nullopt;
+  }
+  if (*size > MaxBlockSize || *decompressedSize > MaxBlockSize) {
+    return std::nullopt;
+  }
+
+  std::string data(*size, '\0');
+  if (!(f.read(data.data(), data.size()) && f.get() == '\n')) {
+    // Truncated, e.g. if a write was interrupted
+    return std::nullopt;
+  }
+  return Compression::Decompress(algorithm, data, *decompressedSize);
+}
+
+std::optional<ChangeJournal::Kind> ParseKind(const char value) {
+  using enum ChangeJournal::Kind;
+  for (auto&& kind: {Edit, External, Checkpoint}) {
+    if (value == static_cast<char>(kind)) {
+      return kind;
+    }
+  }
+  return std::nullopt;
+}
+
+}// namespace
+
+ChangeJournal& ChangeJournal::Get() {
+  static ChangeJournal sInstance {
+    Platform::Get().GetUserDataDirectory() / "Backups" / "journal.tsv"};
+  return sInstance;
+}
+
+ChangeJournal::ChangeJournal(const std::filesystem::path& path)
+  : mPath(path),
+    mLockPath(GetLockPath(path)) {
+  std::error_code ec;
+  std::filesystem::create_directories(mPath.parent_path(), ec);
+
+  const FileLock fileLock {mLockPath};
+  this->Synchronize();
+}
+
+ChangeJournal::~ChangeJournal() = default;
+
+uint64_t ChangeJournal::Record(const std::span<const StoreChange> changes) {
+  const std::unique_lock lock(mMutex);
+  // Another instance may have added entries or strings since, so read them
+  // first; otherwise, the IDs would conflict
+  const FileLock fileLock {mLockPath};
+  this->Synchronize();
+
+  for (auto&& change: changes) {
+    const auto it = mLatest.find(change.mStore);
+    if (it == mLatest.end() || it->second != change.mBefore) {
+      this->AppendCopy(Kind::External, change.mStore, change.mBefore);
+    }
+  }
+
+  Transaction edit {mNextID, Clock::now(), Kind::Edit};
+  std::vector<Entries> afterEdits;
+  afterEdits.reserve(changes.size());
+  for (auto&& change: changes) {
+    const auto store = this->Intern(change.mStore);
+    const auto edits = DiffLayerStore(change.mBefore, change.mAfter);
+    // Values that are not DWORDs are written as DWORDs if they are moved, so
+    // this can differ from `mAfter`
+    MemoryLayerStoreBackend after {change.mBefore};
+    ApplyLayerStoreEdits(after, edits);
+    afterEdits.push_back(after.Read());
+    for (auto&& op: edits) {
+      const auto path = this->Intern(ToUTF8(op.mManifestPath));
+      switch (op.mKind) {
+        case LayerStoreEdit::Kind::Set:
+          edit.mOperations.push_back(
+            {Operation::Kind::Set, store, path, op.mDisabled});
+          break;
+        case LayerStoreEdit::Kind::Delete:
+          edit.mOperations.push_back({Operation::Kind::Delete, store, path});
+          break;
+      }
+    }
+  }
+
+  uint64_t ret = 0;
+  if (!edit.mOperations.empty()) {
+    ret = mNextID++;
+    mTransactions.push_back(std::move(edit));
+
+    for (auto&& [change, after]: std::views::zip(changes, afterEdits)) {
+      mLatest.insert_or_assign(change.mStore, after);
+      auto& count = mEditsSinceCheckpoint[change.mStore];
+      if (++count >= Config::JOURNAL_CHECKPOINT_INTERVAL) {
+        this->AppendCopy(Kind::Checkpoint, change.mStore, after);
+      }
+    }
+  }
+
+  if (mTransactions.size() > Config::JOURNAL_MAX_ENTRIES) {
+    this->Compact();
+  } else {
+    this->Flush();
+  }
+  ++mGeneration;
+  return ret;
+}
+
+void ChangeJournal::AppendCopy(
+  const Kind kind,
+  const std::string_view storeName,
+  const Entries& entries) {
+  const auto store = this->Intern(storeName);
+  Transaction transaction {mNextID++, Clock::now(), kind};
+  transaction.mOperations.reserve(entries.size() + 1);
+  transaction.mOperations.push_back({Operation::Kind::Reset, store});
+  for (auto&& entry: entries) {
+    transaction.mOperations.push_back({
+      Operation::Kind::Set,
+      store,
+      this->Intern(ToUTF8(entry.mManifestPath)),
+      entry.mDisabled,
+    });
+  }
+  mTransactions.push_back(std::move(transaction));
+
+  std::string key {storeName};
+  mLatest.insert_or_assign(key, entries);
+  mEditsSinceCheckpoint.insert_or_assign(std::move(key), 0);
+}
+
+std::optional<ChangeJournal::Entries> ChangeJournal::GetStateAfter(
+  const std::string_view storeName,
+  const uint64_t id) const {
+  const std::unique_lock lock(mMutex);
+  const auto store = this->FindString(storeName);
+  const auto index = this->FindTransaction(id);
+  if (!(store && index)) {
+    return std::nullopt;
+  }
+  return this->Replay(*store, *index + 1);
+}
+
+std::optional<ChangeJournal::Entries> ChangeJournal::GetStateBefore(
+  const std::string_view storeName,
+  const uint64_t id) const {
+  const std::unique_lock lock(mMutex);
+  const auto store = this->FindString(storeName);
+  const auto index = this->FindTransaction(id);
+  if (!(store && index)) {
+    return std::nullopt;
+  }
+  return this->Replay(*store, *index);
+}
+
+std::vector<ChangeJournal::Summary> ChangeJournal::GetHistory(
+  const std::string_view storeName) const {
+  const std::unique_lock lock(mMutex);
+  const auto store = this->FindString(storeName);
+  if (!store) {
+    return {};
+  }
+
+  std::vector<Summary> ret;
+  for (auto&& transaction: mTransactions) {
+    if (transaction.mKind == Kind::Checkpoint) {
+      continue;
+    }
+    const auto& ops = transaction.mOperations;
+    if (!std::ranges::contains(ops, *store, &Operation::mStore)) {
+      continue;
+    }
+    Summary summary {transaction.mID, transaction.mTime, transaction.mKind};
+    for (auto&& op: ops) {
+      const auto& name = mStrings.at(op.mStore);
+      if (!std::ranges::contains(summary.mStores, name)) {
+        summary.mStores.push_back(name);
+      }
+    }
+    ret.push_back(std::move(summary));
+  }
+  return ret;
+}
+
+std::optional<ChangeJournal::Entries> ChangeJournal::Replay(
+  const uint32_t store,
+  const std::size_t end) const {
+  const auto resets = [store](const Transaction& transaction) {
+    return std::ranges::any_of(
+      transaction.mOperations, [store](const Operation& op) {
+        return op.mKind == Operation::Kind::Reset && op.mStore == store;
+      });
+  };
+
+  // Only replay from the last full copy
+  auto begin = end;
+  while (begin > 0 && !resets(mTransactions.at(begin - 1))) {
+    --begin;
+  }
+  if (begin == 0) {
+    return std::nullopt;
+  }
+  --begin;
+
+  // Like `MemoryLayerStoreBackend`, but copies can include values that are
+  // not DWORDs
+  Entries ret;
+  const auto transactions
+    = std::span {mTransactions}.subspan(begin, end - begin);
+  for (auto&& transaction: transactions) {
+    for (auto&& op: transaction.mOperations) {
+      if (op.mStore != store) {
+        continue;
+      }
+      if (op.mKind == Operation::Kind::Reset) {
+        ret.clear();
+        continue;
+      }
+      auto path = FromUTF8(mStrings.at(op.mPath));
+      const auto it = std::ranges::find(
+        ret, path, &LayerStoreBackend::Entry::mManifestPath);
+      if (op.mKind == Operation::Kind::Delete) {
+        if (it != ret.end()) {
+          ret.erase(it);
+        }
+      } else if (it == ret.end()) {
+        ret.push_back({std::move(path), op.mDisabled});
+      } else {
+        it->mDisabled = op.mDisabled;
+      }
+    }
+  }
+  return ret;
+}
+
+std::optional<std::size_t> ChangeJournal::FindTransaction(
+  const uint64_t id) const {
+  // IDs are increasing
+  const auto it
+    = std::ranges::lower_bound(mTransactions, id, {}, &Transaction::mID);
+  if (it == mTransactions.end() || it->mID != id) {
+    return std::nullopt;
+  }
+  return std::distance(mTransactions.begin(), it);
+}
+
+uint32_t ChangeJournal::Intern(const std::string_view value) {
+  if (const auto id = this->FindString(value)) {
+    return *id;
+  }
+  const auto id = static_cast<uint32_t>(mStrings.size());
+  mStrings.emplace_back(value);
+  mStringIDs.emplace(mStrings.back(), id);
+  return id;
+}
+
+std::optional<uint32_t> ChangeJournal::FindString(
+  const std::string_view value) const {
+  const auto it = mStringIDs.find(std::string {value});
+  if (it == mStringIDs.end()) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+void ChangeJournal::Flush() {
+  this->WriteTo(mPath);
+}
+
+bool ChangeJournal::WriteTo(const std::filesystem::path& path) {
+  if (
+    mWrittenStrings == mStrings.size()
+    && mWrittenTransactions == mTransactions.size()) {
+    return true;
+  }
+
+  std::error_code ec;
+  std::filesystem::create_directories(path.parent_path(), ec);
+  const auto size = std::filesystem::file_size(path, ec);
+  const auto isNew = ec || size == 0;
+  std::ofstream f(path, std::ios::binary | std::ios::app);
+  if (!f) {
+    return false;
+  }
+
+  if (isNew) {
+    mFileID = MakeFileID();
+    f << "J\t" << mFileID << '\n';
+  } else if (!EndsWithNewline(path)) {
+    // A previous write was interrupted; don't add to its last line
+    f << '\n';
+  }
+
+  std::ostringstream records;
+  bool hasCopy = false;
+  // Strings first, as the new transactions may refer to them
+  for (; mWrittenStrings < mStrings.size(); ++mWrittenStrings) {
+    records << "=\t" << mWrittenStrings << '\t'
+            << mStrings.at(mWrittenStrings) << '\n';
+  }
+
+  for (; mWrittenTransactions < mTransactions.size(); ++mWrittenTransactions) {
+    const auto& transaction = mTransactions.at(mWrittenTransactions);
+    records << "T\t" << transaction.mID << '\t'
+            << std::chrono::floor<std::chrono::seconds>(transaction.mTime)
+                 .time_since_epoch()
+                 .count()
+            << '\t' << static_cast<char>(transaction.mKind) << '\n';
+    for (auto&& op: transaction.mOperations) {
+      switch (op.mKind) {
+        case Operation::Kind::Reset:
+          hasCopy = true;
+          records << "R\t" << op.mStore << '\n';
+          break;
+        case Operation::Kind::Set:
+          records << "S\t" << op.mStore << '\t' << op.mPath << '\t';
+          if (op.mDisabled) {
+            records << *op.mDisabled;
+          } else {
+            records << '?';
+          }
+          records << '\n';
+          break;
+        case Operation::Kind::Delete:
+          records << "D\t" << op.mStore << '\t' << op.mPath << '\n';
+          break;
+      }
+    }
+  }
+
+  if (hasCopy) {
+    // Full copies are most of the file, and very repetitive; edits are
+    // usually a single line, so are left as text
+    const auto text = records.view();
+    const auto compressed = Compression::Compress(text);
+    f << "Z\t" << static_cast<char>(compressed.mAlgorithm) << '\t'
+      << compressed.mData.size() << '\t' << text.size() << '\n'
+      << compressed.mData << '\n';
+  } else {
+    f << records.view();
+  }
+  f.close();
+  if (!f) {
+    return false;
+  }
+  mFileSize = std::filesystem::file_size(path, ec);
+  return !ec;
+}
+
+void ChangeJournal::Compact() {
+  const auto drop = mTransactions.size() - (Config::JOURNAL_MAX_ENTRIES / 2);
+
+  // Copy every store's state as of the last dropped entry, so the kept
+  // entries can still be replayed
+  const auto& last = mTransactions.at(drop - 1);
+  Transaction base {last.mID, last.mTime, Kind::Checkpoint};
+  for (auto&& store: this->GetStoreIDs()) {
+    const auto entries = this->Replay(store, drop);
+    if (!entries) {
+      continue;
+    }
+    base.mOperations.push_back({Operation::Kind::Reset, store});
+    for (auto&& entry: *entries) {
+      base.mOperations.push_back({
+        Operation::Kind::Set,
+        store,
+        *this->FindString(ToUTF8(entry.mManifestPath)),
+        entry.mDisabled,
+      });
+    }
+  }
+
+  // Copied rather than moved, as the old entries are kept if the new file can
+  // not replace the old one
+  std::vector<Transaction> kept;
+  kept.reserve(mTransactions.size() - drop + 1);
+  kept.push_back(std::move(base));
+  std::ranges::copy(
+    mTransactions | std::views::drop(drop), std::back_inserter(kept));
+
+  // Rebuild the string table, dropping paths that are no longer used
+  auto oldStrings = std::exchange(mStrings, {});
+  auto oldStringIDs = std::exchange(mStringIDs, {});
+  for (auto&& transaction: kept) {
+    for (auto&& op: transaction.mOperations) {
+      op.mStore = this->Intern(oldStrings.at(op.mStore));
+      if (op.mKind != Operation::Kind::Reset) {
+        op.mPath = this->Intern(oldStrings.at(op.mPath));
+      }
+    }
+  }
+  auto oldTransactions = std::exchange(mTransactions, std::move(kept));
+  const auto oldWrittenStrings = std::exchange(mWrittenStrings, 0);
+  const auto oldWrittenTransactions = std::exchange(mWrittenTransactions, 0);
+  const auto oldFileID = mFileID;
+  const auto oldFileSize = mFileSize;
+
+  // Write a new file, then replace the old one, so that a failure does not
+  // lose the whole history
+  auto newPath = mPath;
+  newPath += ".new";
+  std::error_code ec;
+  std::filesystem::remove(newPath, ec);
+  if (this->WriteTo(newPath)) {
+    std::filesystem::rename(newPath, mPath, ec);
+    if (!ec) {
+      return;
+    }
+  }
+  std::filesystem::remove(newPath, ec);
+
+  // The old file is still in use, and its string IDs differ from the new
+  // ones, so go back to the old state and append to it instead; compaction
+  // is retried on the next change
+  mStrings = std::move(oldStrings);
+  mStringIDs = std::move(oldStringIDs);
+  mTransactions = std::move(oldTransactions);
+  mWrittenStrings = oldWrittenStrings;
+  mWrittenTransactions = oldWrittenTransactions;
+  mFileID = oldFileID;
+  mFileSize = oldFileSize;
+  this->Flush();
+}
+
+void ChangeJournal::Synchronize() {
+  std::error_code ec;
+  const auto size = std::filesystem::file_size(mPath, ec);
+  if (ec) {
+    // Not written yet, or deleted by something else
+    if (mFileSize != 0) {
+      this->Reset();
+    }
+    return;
+  }
+
+  std::ifstream f(mPath, std::ios::binary);
+  if (!f) {
+    return;
+  }
+  const auto fileID = ReadFileID(f);
+  if (fileID == mFileID && size == mFileSize) {
+    return;
+  }
+
+  // Only appended to since, so the string and entry IDs are still valid
+  const auto isAppended = fileID == mFileID && size > mFileSize
+    && mWrittenStrings == mStrings.size()
+    && mWrittenTransactions == mTransactions.size();
+  if (!isAppended) {
+    // Rewritten by another instance, or we failed to write our own changes;
+    // the IDs may now be used for something else, so start again
+    this->Reset();
+  }
+
+  // After the last record we read, or the start if reset
+  f.clear();
+  f.seekg(static_cast<std::streamoff>(mFileSize));
+  this->Parse(f);
+  mFileID = fileID;
+  mFileSize = size;
+  mWrittenStrings = mStrings.size();
+  mWrittenTransactions = mTransactions.size();
+  this->RebuildLatest();
+}
+
+void ChangeJournal::Reset() {
+  mStrings.clear();
+  mStringIDs.clear();
+  mTransactions.clear();
+  mNextID = 1;
+  mLatest.clear();
+  mEditsSinceCheckpoint.clear();
+  mWrittenStrings = 0;
+  mWrittenTransactions = 0;
+  mFileID = 0;
+  mFileSize = 0;
+}
+
+void ChangeJournal::Parse(std::istream& f) {
+  std::string line;
+  std::vector<std::string_view> fields;
+  bool inTransaction = false;
+  while (std::getline(f, line)) {
+    fields.clear();
+    for (auto&& field: std::views::split(line, '\t')) {
+      fields.emplace_back(field.begin(), field.end());
+    }
+    if (fields.empty() || fields.front().size() != 1) {
+      continue;
+    }
+
+    const auto index = [&](const std::size_t i) -> std::optional<uint32_t> {
+      if (i >= fields.size()) {
+        return std::nullopt;
+      }
+      const auto ret = ParseNumber<uint32_t>(fields.at(i));
+      if (!(ret && *ret < mStrings.size())) {
+        return std::nullopt;
+      }
+      return ret;
+    };
+
+    const auto type = fields.front().front();
+    if (type == '=') {
+      if (
+        fields.size() < 3
+        || ParseNumber<uint32_t>(fields.at(1)) != mStrings.size()) {
+        continue;
+      }
+      // Not `fields.at(2)`, as strings may contain tabs
+      const auto prefixLength = fields.at(0).size() + fields.at(1).size() + 2;
+      this->Intern(std::string_view {line}.substr(prefixLength));
+      continue;
+    }
+
+    if (type == 'Z') {
+      // Records in a block are complete entries
+      inTransaction = false;
+      const auto block = ReadBlock(f, fields);
+      if (block) {
+        std::istringstream records {*block};
+        this->Parse(records);
+      }
+      continue;
+    }
+
+    if (type == 'T') {
+      // Until the next valid header, records belong to this one, so must be
+      // dropped rather than added to the previous entry
+      inTransaction = false;
+      if (fields.size() != 4 || fields.at(3).size() != 1) {
+        continue;
+      }
+      const auto id = ParseNumber<uint64_t>(fields.at(1));
+      const auto time = ParseNumber<int64_t>(fields.at(2));
+      const auto kind = ParseKind(fields.at(3).front());
+      if (!(id && time && kind && *id >= mNextID)) {
+        continue;
+      }
+      mTransactions.push_back({
+        *id,
+        Clock::time_point {std::chrono::seconds {*time}},
+        *kind,
+      });
+      mNextID = *id + 1;
+      inTransaction = true;
+      continue;
+    }
+
+    if (!inTransaction) {
+      continue;
+    }
+    auto& ops = mTransactions.back().mOperations;
+    const auto store = index(1);
+    if (!store) {
+      continue;
+    }
+    switch (type) {
+      case 'R':
+        ops.push_back({Operation::Kind::Reset, *store});
+        break;
+      case 'S': {
+        const auto path = index(2);
+        if (!(path && fields.size() == 4)) {
+          break;
+        }
+        if (fields.at(3) == "?") {
+          ops.push_back({Operation::Kind::Set, *store, *path, std::nullopt});
+        } else if (const auto disabled = ParseNumber<uint32_t>(fields.at(3))) {
+          ops.push_back({Operation::Kind::Set, *store, *path, *disabled});
+        }
+        break;
+      }
+      case 'D':
+        if (const auto path = index(2)) {
+          ops.push_back({Operation::Kind::Delete, *store, *path});
+        }
+        break;
+    }
+  }
+}
+
+void ChangeJournal::RebuildLatest() {
+  mLatest.clear();
+  mEditsSinceCheckpoint.clear();
+  for (auto&& store: this->GetStoreIDs()) {
+    const auto& name = mStrings.at(store);
+    if (auto entries = this->Replay(store, mTransactions.size())) {
+      mLatest.emplace(name, std::move(*entries));
+    }
+
+    std::size_t edits = 0;
+    for (auto&& transaction: mTransactions) {
+      const auto& ops = transaction.mOperations;
+      if (std::ranges::any_of(ops, [store](const Operation& op) {
+            return op.mKind == Operation::Kind::Reset && op.mStore == store;
+          })) {
+        edits = 0;
+      } else if (
+        transaction.mKind == Kind::Edit
+        && std::ranges::contains(ops, store, &Operation::mStore)) {
+        ++edits;
+      }
+    }
+    mEditsSinceCheckpoint.emplace(name, edits);
+  }
+}
+
+std::vector<uint32_t> ChangeJournal::GetStoreIDs() const {
+  std::vector<uint32_t> ret;
+  for (auto&& transaction: mTransactions) {
+    for (auto&& op: transaction.mOperations) {
+      if (
+        op.mKind == Operation::Kind::Reset
+        && !std::ranges::contains(ret, op.mStore)) {
+        ret.push_back(op.mStore);
+      }
+    }
+  }
+  return ret;
+}
+
+}// namespace FredEmmott::OpenXRLayers
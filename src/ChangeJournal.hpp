@@ -0,0 +1,191 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <istream>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "LayerStoreBackend.hpp"
+
+namespace FredEmmott::OpenXRLayers {
+
+/** An append-only history of the changes to the layer stores.
+ *
+ * This is `Backups/journal.tsv` in the user data directory, and replaces the
+ * full per-run backups. Each commit is stored as the edits it made to each
+ * store - usually a single line for a toggle - and store names and manifest
+ * paths are only written once, to a string table.
+ *
+ * A full copy of a store is written the first time it is seen, whenever it
+ * was changed by something else, and every
+ * `Config::JOURNAL_CHECKPOINT_INTERVAL` edits; the state after any entry can
+ * be rebuilt by replaying the edits since the last full copy.
+ *
+ * Once there are more than `Config::JOURNAL_MAX_ENTRIES` entries, the oldest
+ * half are dropped and the file is rewritten.
+ *
+ * Full copies - and so the whole file after it is rewritten - are compressed
+ * with the Windows Compression API; see `Compression`. Edits are left as
+ * text, so that they can be appended without rewriting anything.
+ *
+ * Several instances - e.g. an elevated and a non-elevated one - can share the
+ * file: changes are written while holding `journal.tsv.lock`, after reading
+ * anything the other instances have written since.
+ *
+ * Each line is a tab-separated record:
+ * - `J  id`: the first line; a random ID for this copy of the file, so that
+ *   other instances can tell that it has been rewritten
+ * - `=  id  string`: an entry in the string table
+ * - `T  id  unixTime  kind`: the start of a journal entry; see `Kind`
+ * - `R  store`: the store is empty; usually followed by `S` records
+ * - `S  store  path  disabled`: `disabled` is `?` if the value is not a DWORD
+ * - `D  store  path`
+ * - `Z  algorithm  size  decompressedSize`: followed by `size` bytes of
+ *   compressed records and a newline; written for anything that includes a
+ *   full copy, along with the strings it adds
+ */
+class ChangeJournal final {
+ public:
+  using Clock = std::chrono::system_clock;
+  using Entries = std::vector<LayerStoreBackend::Entry>;
+
+  enum class Kind : char {
+    /// Changes made by this program
+    Edit = 'E',
+    /// The store was changed by something else; this is a full copy
+    External = 'X',
+    /// A periodic full copy; does not change anything
+    Checkpoint = 'C',
+  };
+
+  struct StoreChange {
+    std::string mStore;
+    Entries mBefore;
+    Entries mAfter;
+  };
+
+  struct Summary {
+    uint64_t mID {};
+    Clock::time_point mTime;
+    Kind mKind {};
+    std::vector<std::string> mStores;
+  };
+
+  static ChangeJournal& Get();
+
+  explicit ChangeJournal(const std::filesystem::path&);
+  ~ChangeJournal();
+
+  ChangeJournal(const ChangeJournal&) = delete;
+  ChangeJournal(ChangeJournal&&) = delete;
+  ChangeJournal& operator=(const ChangeJournal&) = delete;
+  ChangeJournal& operator=(ChangeJournal&&) = delete;
+
+  /// Returns the ID of the new `Kind::Edit` entry, or 0 if nothing changed
+  uint64_t Record(std::span<const StoreChange>);
+
+  /// The store's entries after the journal entry; nullopt if unknown
+  [[nodiscard]]
+  std::optional<Entries> GetStateAfter(
+    std::string_view store,
+    uint64_t id) const;
+  /// The store's entries before the journal entry; nullopt if unknown
+  [[nodiscard]]
+  std::optional<Entries> GetStateBefore(
+    std::string_view store,
+    uint64_t id) const;
+
+  /// Edits and external changes that affected the store, oldest first
+  [[nodiscard]]
+  std::vector<Summary> GetHistory(std::string_view store) const;
+
+  /// Increases each time `Record()` is called, so callers can cache history
+  [[nodiscard]]
+  uint64_t GetGeneration() const noexcept {
+    return mGeneration.load();
+  }
+
+ private:
+  struct Operation {
+    enum class Kind : uint8_t {
+      Reset,
+      Set,
+      Delete,
+    };
+    Kind mKind {};
+    // String table indices
+    uint32_t mStore {};
+    uint32_t mPath {};
+    /// nullopt if the value is not a DWORD; see `LayerStoreBackend::Entry`
+    std::optional<uint32_t> mDisabled;
+  };
+  struct Transaction {
+    uint64_t mID {};
+    Clock::time_point mTime;
+    ChangeJournal::Kind mKind {};
+    std::vector<Operation> mOperations;
+  };
+
+  const std::filesystem::path mPath;
+  const std::filesystem::path mLockPath;
+  std::atomic<uint64_t> mGeneration {1};
+
+  mutable std::mutex mMutex;
+  std::vector<std::string> mStrings;
+  std::unordered_map<std::string, uint32_t> mStringIDs;
+  std::vector<Transaction> mTransactions;
+  uint64_t mNextID {1};
+
+  // The latest state of each store, by name
+  std::unordered_map<std::string, Entries> mLatest;
+  std::unordered_map<std::string, std::size_t> mEditsSinceCheckpoint;
+
+  // What has already been written to the file
+  std::size_t mWrittenStrings {0};
+  std::size_t mWrittenTransactions {0};
+  // The `J` record, or 0 if there is none
+  uint64_t mFileID {0};
+  // How much of the file has been read or written
+  std::uintmax_t mFileSize {0};
+
+  /// Read anything that other instances have written; the lock must be held
+  void Synchronize();
+  /// Forget everything, as if the file did not exist
+  void Reset();
+  /// Read records up to the end of the stream
+  void Parse(std::istream&);
+  /// Rebuild the latest state of each store, and when it was last copied
+  void RebuildLatest();
+  /// Append anything that has not been written yet
+  void Flush();
+  /// Returns false if the file could not be written
+  bool WriteTo(const std::filesystem::path&);
+  /// Drop the oldest entries, and rewrite the file
+  void Compact();
+
+  uint32_t Intern(std::string_view);
+  [[nodiscard]]
+  std::optional<uint32_t> FindString(std::string_view) const;
+
+  void AppendCopy(Kind, std::string_view store, const Entries&);
+  /// Rebuild a store from the entries before `end`
+  [[nodiscard]]
+  std::optional<Entries> Replay(uint32_t store, std::size_t end) const;
+  [[nodiscard]]
+  std::optional<std::size_t> FindTransaction(uint64_t id) const;
+  /// Stores that have a full copy in the journal
+  [[nodiscard]]
+  std::vector<uint32_t> GetStoreIDs() const;
+};
+
+}// namespace FredEmmott::OpenXRLayers
@@ -0,0 +1,41 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+
+/** Compression for data written to disk, e.g. the change journal.
+ *
+ * On Windows, this uses the Windows Compression API; elsewhere, there is no
+ * system compression library, so data is stored as-is. The algorithm is
+ * stored with the data, so either can be read back on Windows.
+ */
+namespace FredEmmott::OpenXRLayers::Compression {
+
+enum class Algorithm : char {
+  /// Not compressed
+  None = '-',
+  /// `COMPRESS_ALGORITHM_XPRESS_HUFF`
+  XpressHuff = 'X',
+};
+
+struct Compressed {
+  Algorithm mAlgorithm {};
+  std::string mData;
+};
+
+/// Compress with the best available algorithm, or store as-is if that fails
+[[nodiscard]]
+Compressed Compress(std::string_view);
+
+/// nullopt if the data is corrupt, or the algorithm is not available
+[[nodiscard]]
+std::optional<std::string> Decompress(
+  Algorithm,
+  std::string_view data,
+  std::size_t decompressedSize);
+
+}// namespace FredEmmott::OpenXRLayers::Compression
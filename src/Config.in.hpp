@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <chrono>
+#include <cstddef>
 #include <string>
 
 namespace FredEmmott::OpenXRLayers::Config {
@@ -17,6 +19,9 @@ constexpr bool USE_EMOJI { @USE_EMOJI_BOOL@ };
 constexpr auto GLYPH_ENABLED {USE_EMOJI ? "\u2705" : "Y"};
 constexpr auto GLYPH_DISABLED {USE_EMOJI ? "\u274c" : "N"};
 constexpr auto GLYPH_ERROR {USE_EMOJI ? "\u26a0" : "!"};
+constexpr auto GLYPH_STAGED {USE_EMOJI ? "\u270f" : "*"};
+constexpr auto GLYPH_BLOCKED {USE_EMOJI ? "\u26d4" : "B"};
+constexpr auto GLYPH_PENDING {USE_EMOJI ? "\u231b" : "?"};
 
 constexpr auto LICENSE_TEXT {R"---LICENSE---(@LICENSE_TEXT@)---LICENSE---"};
 
@@ -25,4 +30,22 @@ constexpr auto MINIMUM_WINDOW_HEIGHT = 768;
 
 constexpr auto MAX_FPS = 60;
 
+// Wait for stores to be quiet for this long before reloading them, so that
+// e.g. an installer writing several registry values causes a single reload
+constexpr auto STORE_CHANGE_DEBOUNCE = std::chrono::milliseconds(250);
+// ... but if they keep changing, reload at least this often
+constexpr auto STORE_CHANGE_MAX_LATENCY = std::chrono::seconds(2);
+
+// Kill `loader-data` helpers that take longer than this, e.g. because a
+// runtime or layer is stuck waiting on something
+constexpr auto LOADER_DATA_TIMEOUT = std::chrono::seconds(30);
+// Each of these loads a runtime, so don't start one per runtime at once
+constexpr std::size_t MAX_CONCURRENT_RUNTIME_QUERIES = 4;
+
+// Write a full copy of a store to the change journal after this many edits,
+// so restoring a past state only needs to replay a few edits
+constexpr std::size_t JOURNAL_CHECKPOINT_INTERVAL = 32;
+// When the journal has more entries than this, the oldest half are dropped
+constexpr std::size_t JOURNAL_MAX_ENTRIES = 1000;
+
 }// namespace FredEmmott::OpenXRLayers::Config
\ No newline at end of file
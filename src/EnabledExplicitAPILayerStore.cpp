@@ -3,15 +3,39 @@
 
 #include "EnabledExplicitAPILayerStore.hpp"
 
+#include <nlohmann/json.hpp>
+
+#include <fstream>
 #include <ranges>
 
 namespace FredEmmott::OpenXRLayers {
 
+namespace {
+std::string ReadManifestName(const std::filesystem::path& path) {
+  std::ifstream f(path);
+  if (!f) {
+    return {};
+  }
+  try {
+    const auto json = nlohmann::json::parse(f);
+    return json.at("api_layer").value("name", std::string {});
+  } catch (const nlohmann::json::exception&) {
+    return {};
+  }
+}
+}// namespace
+
 EnabledExplicitAPILayerStore::EnabledExplicitAPILayerStore(
   Platform& platform,
   const std::vector<APILayerStore*>& backingStores)
   : mPlatform(platform),
-    mBackingStores(backingStores) {}
+    mBackingStores(backingStores),
+    mIndexedStores(backingStores.size()) {
+  for (auto&& store: mBackingStores) {
+    mBackingStoreConnections.emplace_back(
+      store->OnChange([this] { this->NotifyChange(); }));
+  }
+}
 
 EnabledExplicitAPILayerStore::~EnabledExplicitAPILayerStore() = default;
 
@@ -24,39 +48,75 @@ std::string EnabledExplicitAPILayerStore::GetDisplayName() const noexcept {
 
 std::vector<APILayer> EnabledExplicitAPILayerStore::GetAPILayers()
   const noexcept {
-  std::vector<APILayer> ret;
+  const std::unique_lock lock(mIndexMutex);
+  this->UpdateIndex();
 
-  const auto installedLayers
-    = mBackingStores | std::views::transform([](APILayerStore* store) {
-        return store->GetAPILayers();
-      })
-    | std::views::join | std::views::transform([](const APILayer& layer) {
-        return std::tuple {layer, APILayerDetails {layer.mManifestPath}};
-      })
-    | std::ranges::to<std::vector>();
+  std::vector<APILayer> ret;
   for (auto&& name: mPlatform.GetEnabledExplicitAPILayers()) {
-    const auto matching
-      = std::views::filter(
-          installedLayers,
-          [&](const auto& pair) { return get<1>(pair).mName == name; })
-      | std::ranges::to<std::vector>();
-    ret.push_back(
+    auto& entry = ret.emplace_back(
       APILayer::MakeForEnvVar(this, name, APILayer::Value::EnabledButAbsent));
-    if (matching.empty()) {
+    const auto it = mLayersByName.find(name);
+    if (it == mLayersByName.end()) {
       continue;
     }
-    auto& entry = ret.back();
-    for (auto&& match: std::views::elements<0>(matching)) {
+    for (auto&& match: it->second) {
       if (match.mValue == APILayer::Value::Enabled) {
         entry.mValue = APILayer::Value::Enabled;
         entry.mArchitectures |= match.mArchitectures;
-        entry.mManifestPath = match.mManifestPath;
+        entry.SetManifestPath(match.GetManifestPath());
       }
     }
   }
   return ret;
 }
 
+void EnabledExplicitAPILayerStore::UpdateIndex() const {
+  bool changed = false;
+  for (auto&& [store, indexed]:
+       std::views::zip(mBackingStores, mIndexedStores)) {
+    // Generations are bumped by the change notifications we forward
+    const auto snapshot = store->GetSnapshot();
+    if (snapshot->mGeneration == indexed.mGeneration) {
+      continue;
+    }
+    changed = true;
+    indexed.mGeneration = snapshot->mGeneration;
+    indexed.mLayers.clear();
+    indexed.mLayers.reserve(snapshot->mLayers.size());
+    for (auto&& layer: snapshot->mLayers) {
+      indexed.mLayers.emplace_back(
+        layer, this->GetManifestName(layer.GetManifestPath()));
+    }
+  }
+  if (!changed) {
+    return;
+  }
+
+  // No manifests are read here, so rebuilding the whole map is cheap
+  mLayersByName.clear();
+  for (auto&& indexed: mIndexedStores) {
+    for (auto&& [layer, name]: indexed.mLayers) {
+      mLayersByName[name].push_back(layer);
+    }
+  }
+}
+
+const std::string& EnabledExplicitAPILayerStore::GetManifestName(
+  const std::filesystem::path& path) const {
+  std::error_code ec;
+  const auto lastWriteTime = std::filesystem::last_write_time(path, ec);
+
+  auto& cached = mManifestNames[path];
+  if (!cached.mName.empty() && cached.mLastWriteTime == lastWriteTime) {
+    return cached.mName;
+  }
+  cached.mLastWriteTime = lastWriteTime;
+  // Only the name is needed, so avoid the signature checks and other work
+  // in `APILayerDetails`
+  cached.mName = ReadManifestName(path);
+  return cached.mName;
+}
+
 Architectures EnabledExplicitAPILayerStore::GetArchitectures() const noexcept {
   Architectures ret {Architecture::Invalid};
   for (auto&& store: mBackingStores) {
@@ -2,11 +2,26 @@
 // SPDX-License-Identifier: MIT
 #pragma once
 
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
 #include "APILayerStore.hpp"
 #include "Platform.hpp"
 
 namespace FredEmmott::OpenXRLayers {
 
+/** Layers enabled via the `XR_ENABLE_API_LAYERS` environment variable.
+ *
+ * The variable contains layer names, which are resolved to manifests from
+ * the backing stores via an index from name to layers. The index is updated
+ * when the backing stores change, only re-reading the manifests that are new
+ * or have been modified.
+ */
 class EnabledExplicitAPILayerStore : public virtual APILayerStore {
  public:
   EnabledExplicitAPILayerStore() = delete;
@@ -23,5 +38,29 @@ class EnabledExplicitAPILayerStore : public virtual APILayerStore {
  private:
   Platform& mPlatform;
   std::vector<APILayerStore*> mBackingStores;
+  std::vector<boost::signals2::scoped_connection> mBackingStoreConnections;
+
+  struct ManifestName {
+    std::filesystem::file_time_type mLastWriteTime;
+    std::string mName;
+  };
+  struct IndexedStore {
+    // The snapshot generation that `mLayers` is from
+    uint64_t mGeneration {0};
+    // Layers with their manifest names
+    std::vector<std::tuple<APILayer, std::string>> mLayers;
+  };
+
+  mutable std::mutex mIndexMutex;
+  // Indexed like `mBackingStores`
+  mutable std::vector<IndexedStore> mIndexedStores;
+  mutable std::unordered_map<std::filesystem::path, ManifestName>
+    mManifestNames;
+  // Installed layers by manifest name, in backing store order
+  mutable std::unordered_map<std::string, std::vector<APILayer>> mLayersByName;
+
+  void UpdateIndex() const;
+  [[nodiscard]]
+  const std::string& GetManifestName(const std::filesystem::path&) const;
 };
 }// namespace FredEmmott::OpenXRLayers
@@ -0,0 +1,161 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#include "Environment.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+namespace FredEmmott::OpenXRLayers {
+
+Environment::Environment(const std::map<std::string, std::string>& variables) {
+  std::size_t bufferSize {};
+  for (auto&& [name, value]: variables) {
+    bufferSize += name.size() + value.size();
+  }
+  mBuffer.reserve(bufferSize);
+  mEntries.reserve(variables.size());
+
+  for (auto&& [name, value]: variables) {
+    Append(name, value);
+  }
+}
+
+void Environment::Append(
+  const std::string_view name,
+  const std::string_view value) {
+  assert(mEntries.empty() || GetVariable(mEntries.back()).mName < name);
+  Entry entry {
+    .mNameOffset = mBuffer.size(),
+    .mNameSize = name.size(),
+  };
+  mBuffer.append(name);
+  entry.mValueOffset = mBuffer.size();
+  entry.mValueSize = value.size();
+  mBuffer.append(value);
+  mEntries.push_back(entry);
+}
+
+std::optional<std::string_view> Environment::Find(
+  const std::string_view name) const {
+  const auto variables = GetVariables();
+  const auto it
+    = std::ranges::lower_bound(variables, name, {}, &Variable::mName);
+  if (it == variables.end() || (*it).mName != name) {
+    return std::nullopt;
+  }
+  return (*it).mValue;
+}
+
+uint64_t Environment::GetHash() const noexcept {
+  uint64_t ret = 0xcbf29ce484222325;
+  const auto mix = [&ret](const std::string_view value) {
+    for (const auto c: value) {
+      ret ^= static_cast<uint8_t>(c);
+      ret *= 0x100000001b3;
+    }
+    // Separator, so e.g. `AB=C` and `A=BC` differ
+    ret ^= 0xff;
+    ret *= 0x100000001b3;
+  };
+  for (auto&& [name, value]: GetVariables()) {
+    mix(name);
+    mix(value);
+  }
+  return ret;
+}
+
+bool Environment::operator==(const Environment& other) const noexcept {
+  return std::ranges::equal(
+    GetVariables(), other.GetVariables(), [](const auto& a, const auto& b) {
+      return a.mName == b.mName && a.mValue == b.mValue;
+    });
+}
+
+Environment::Variable Environment::GetVariable(
+  const Entry& entry) const noexcept {
+  const std::string_view buffer {mBuffer};
+  return {
+    buffer.substr(entry.mNameOffset, entry.mNameSize),
+    buffer.substr(entry.mValueOffset, entry.mValueSize),
+  };
+}
+
+EnvironmentDiff Diff(const Environment& before, const Environment& after) {
+  EnvironmentDiff ret;
+  const auto beforeVariables = before.GetVariables();
+  const auto afterVariables = after.GetVariables();
+  auto b = beforeVariables.begin();
+  auto a = afterVariables.begin();
+  while (b != beforeVariables.end() || a != afterVariables.end()) {
+    if (
+      a == afterVariables.end()
+      || (b != beforeVariables.end() && (*b).mName < (*a).mName)) {
+      ret.emplace_back(std::string {(*b).mName}, std::string {(*b).mValue});
+      ++b;
+      continue;
+    }
+    if (b == beforeVariables.end() || (*a).mName < (*b).mName) {
+      ret.emplace_back(
+        std::string {(*a).mName}, std::nullopt, std::string {(*a).mValue});
+      ++a;
+      continue;
+    }
+    if ((*a).mValue != (*b).mValue) {
+      ret.emplace_back(
+        std::string {(*a).mName},
+        std::string {(*b).mValue},
+        std::string {(*a).mValue});
+    }
+    ++a;
+    ++b;
+  }
+  return ret;
+}
+
+const EnvironmentChange* FindChange(
+  const EnvironmentDiff& diff,
+  const std::string_view name) {
+  const auto it
+    = std::ranges::lower_bound(diff, name, {}, &EnvironmentChange::mName);
+  if (it == diff.end() || it->mName != name) {
+    return nullptr;
+  }
+  return &*it;
+}
+
+void from_json(const nlohmann::json& j, Environment& environment) {
+  environment = Environment {j.get<std::map<std::string, std::string>>()};
+}
+
+void to_json(nlohmann::json& j, const Environment& environment) {
+  j = nlohmann::json::object();
+  for (auto&& [name, value]: environment.GetVariables()) {
+    j[std::string {name}] = value;
+  }
+}
+
+void from_json(const nlohmann::json& j, EnvironmentChange& change) {
+  j.at("name").get_to(change.mName);
+  change.mBefore = std::nullopt;
+  change.mAfter = std::nullopt;
+  if (j.contains("before")) {
+    change.mBefore = j.at("before").get<std::string>();
+  }
+  if (j.contains("after")) {
+    change.mAfter = j.at("after").get<std::string>();
+  }
+}
+
+void to_json(nlohmann::json& j, const EnvironmentChange& change) {
+  j = {{"name", change.mName}};
+  if (change.mBefore) {
+    j["before"] = *change.mBefore;
+  }
+  if (change.mAfter) {
+    j["after"] = *change.mAfter;
+  }
+}
+
+}// namespace FredEmmott::OpenXRLayers
@@ -0,0 +1,110 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <nlohmann/json_fwd.hpp>
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace FredEmmott::OpenXRLayers {
+
+/** A set of environment variables, sorted by name.
+ *
+ * Names and values are stored in a single buffer, so copying an environment
+ * takes two allocations, however many variables there are.
+ */
+class Environment final {
+ public:
+  struct Variable {
+    std::string_view mName;
+    std::string_view mValue;
+  };
+
+  Environment() = default;
+  explicit Environment(const std::map<std::string, std::string>&);
+
+  /// Names must be appended in increasing order, without duplicates
+  void Append(std::string_view name, std::string_view value);
+
+  [[nodiscard]]
+  std::size_t size() const noexcept {
+    return mEntries.size();
+  }
+
+  [[nodiscard]]
+  bool empty() const noexcept {
+    return mEntries.empty();
+  }
+
+  /// A random-access range of `Variable`, sorted by name
+  [[nodiscard]]
+  auto GetVariables() const {
+    return std::views::transform(
+      mEntries, [this](const Entry& entry) { return GetVariable(entry); });
+  }
+
+  [[nodiscard]]
+  std::optional<std::string_view> Find(std::string_view name) const;
+  [[nodiscard]]
+  bool contains(const std::string_view name) const {
+    return Find(name).has_value();
+  }
+
+  /// FNV-1a; the same in every process
+  [[nodiscard]]
+  uint64_t GetHash() const noexcept;
+
+  bool operator==(const Environment&) const noexcept;
+
+ private:
+  struct Entry {
+    std::size_t mNameOffset {};
+    std::size_t mNameSize {};
+    std::size_t mValueOffset {};
+    std::size_t mValueSize {};
+  };
+  std::string mBuffer;
+  std::vector<Entry> mEntries;
+
+  [[nodiscard]]
+  Variable GetVariable(const Entry&) const noexcept;
+};
+
+/// A variable that differs between two environments
+struct EnvironmentChange {
+  std::string mName;
+  /// `std::nullopt` if the variable was added
+  std::optional<std::string> mBefore;
+  /// `std::nullopt` if the variable was removed
+  std::optional<std::string> mAfter;
+
+  bool operator==(const EnvironmentChange&) const noexcept = default;
+};
+
+/// Sorted by name
+using EnvironmentDiff = std::vector<EnvironmentChange>;
+
+/// Compares each variable once, as both environments are sorted
+[[nodiscard]]
+EnvironmentDiff Diff(const Environment& before, const Environment& after);
+
+/// nullptr if the variable did not change
+[[nodiscard]]
+const EnvironmentChange* FindChange(
+  const EnvironmentDiff&,
+  std::string_view name);
+
+/// An object, with a member per variable
+void from_json(const nlohmann::json&, Environment&);
+void to_json(nlohmann::json&, const Environment&);
+
+void from_json(const nlohmann::json&, EnvironmentChange&);
+void to_json(nlohmann::json&, const EnvironmentChange&);
+
+}// namespace FredEmmott::OpenXRLayers
@@ -0,0 +1,35 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <filesystem>
+#include <memory>
+
+namespace FredEmmott::OpenXRLayers {
+
+/** An exclusive lock on a file, shared with other processes.
+ *
+ * The constructor blocks until the lock is acquired, and it is released by
+ * the destructor. The file is created if needed, and is not deleted. If the
+ * file can not be opened or locked, this does nothing.
+ *
+ * This is used to stop two instances - e.g. an elevated and a non-elevated
+ * one - from writing to the same file at the same time.
+ */
+class FileLock final {
+ public:
+  FileLock() = delete;
+  explicit FileLock(const std::filesystem::path&);
+  ~FileLock();
+
+  FileLock(const FileLock&) = delete;
+  FileLock(FileLock&&) = delete;
+  FileLock& operator=(const FileLock&) = delete;
+  FileLock& operator=(FileLock&&) = delete;
+
+ private:
+  struct Impl;
+  std::unique_ptr<Impl> mImpl;
+};
+
+}// namespace FredEmmott::OpenXRLayers
@@ -5,20 +5,122 @@
 
 #include <fmt/format.h>
 
+#include <chrono>
+#include <format>
+#include <future>
+#include <limits>
 #include <ranges>
+#include <unordered_map>
+#include <utility>
 
 #include <imgui.h>
 
 #include "APILayer.hpp"
 #include "APILayerStore.hpp"
+#include "ChangeJournal.hpp"
 #include "Config.hpp"
+#include "LayerRelations.hpp"
+#include "LayerRules.hpp"
+#include "LayerStoreBackend.hpp"
+#include "LayerStoreTransaction.hpp"
 #include "Linter.hpp"
 #include "Platform.hpp"
+#include "RuntimeMatrix.hpp"
 #include "SaveReport.hpp"
+#include "UserLayerRules.hpp"
 
 namespace FredEmmott::OpenXRLayers {
 
+namespace {
+
+// How often to redraw while a fix preview's tooltip is waiting for it
+constexpr auto FixPreviewPollInterval = std::chrono::milliseconds(100);
+
+// Which elements of `values` are part of a longest strictly increasing
+// subsequence
+std::vector<bool> InLongestIncreasingSubsequence(
+  const std::vector<std::size_t>& values) {
+  constexpr auto None = std::numeric_limits<std::size_t>::max();
+  // Patience sorting: `tails[k]` is the index of the smallest value that ends
+  // an increasing subsequence of length `k + 1`
+  std::vector<std::size_t> tails;
+  std::vector<std::size_t> previous(values.size(), None);
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    const auto it = std::ranges::lower_bound(
+      tails, values[i], {}, [&values](const auto index) {
+        return values[index];
+      });
+    if (it != tails.begin()) {
+      previous[i] = *std::prev(it);
+    }
+    if (it == tails.end()) {
+      tails.push_back(i);
+    } else {
+      *it = i;
+    }
+  }
+
+  std::vector<bool> ret(values.size(), false);
+  for (auto i = tails.empty() ? None : tails.back(); i != None;
+       i = previous[i]) {
+    ret[i] = true;
+  }
+  return ret;
+}
+
+// Rows of `working` that are not in `base`, have a different value, or have
+// moved relative to the other layers that are in both
+std::vector<bool> GetChangedRows(
+  const std::vector<APILayer>& base,
+  const std::vector<APILayer>& working) {
+  std::unordered_map<APILayer::Key, std::size_t> baseIndices;
+  for (std::size_t i = 0; i < base.size(); ++i) {
+    baseIndices.emplace(base[i].GetKey(), i);
+  }
+
+  std::vector<bool> ret(working.size(), false);
+  // Rows that are in both, and their indices in `base`
+  std::vector<std::size_t> rows;
+  std::vector<std::size_t> baseOrder;
+  for (std::size_t i = 0; i < working.size(); ++i) {
+    const auto it = baseIndices.find(working[i].GetKey());
+    if (it == baseIndices.end()) {
+      ret[i] = true;
+      continue;
+    }
+    if (base[it->second].mValue != working[i].mValue) {
+      ret[i] = true;
+    }
+    rows.push_back(i);
+    baseOrder.push_back(it->second);
+  }
+
+  // The fewest layers that need to move are those outside of the longest run
+  // that is still in the original order
+  const auto inOrder = InLongestIncreasingSubsequence(baseOrder);
+  for (std::size_t i = 0; i < rows.size(); ++i) {
+    if (!inOrder[i]) {
+      ret[rows[i]] = true;
+    }
+  }
+  return ret;
+}
+
+}// namespace
+
 void GUI::DrawFrame() {
+  const auto [changes, nextDrain] = mStoreChanges->Drain();
+  for (auto&& change: changes) {
+    for (auto&& layerSet: mLayerSets) {
+      if (&layerSet->GetStore() == change.mStore) {
+        layerSet->mLayerDataIsStale = true;
+      }
+    }
+  }
+  if (nextDrain) {
+    Platform::Get().RequestFrame(*nextDrain);
+  }
+
   ImGui::Begin(
     "MainWindow",
     nullptr,
@@ -67,14 +169,26 @@ GUI::GUI(const ShowExplicit showExplicitMode) {
          if (store->GetKind() != APILayer::Kind::Explicit) {
            return false;
          }
-         return !store->GetAPILayers().empty();
+         return !store->GetSnapshot()->mLayers.empty();
        });
 
+  std::vector<APILayerStore*> shownStores;
   for (auto&& store: stores) {
     if (store->GetKind() == APILayer::Kind::Explicit && !showExplicit) {
       continue;
     }
     mLayerSets.emplace_back(std::make_unique<LayerSet>(store));
+    shownStores.push_back(store);
+  }
+
+  mStoreChanges.emplace(
+    shownStores,
+    Config::STORE_CHANGE_DEBOUNCE,
+    Config::STORE_CHANGE_MAX_LATENCY);
+  for (auto&& store: shownStores) {
+    mStoreChangeConnections.emplace_back(store->OnChange([this, store] {
+      mStoreChanges->Push(store, store->GetGeneration());
+    }));
   }
 }
 
@@ -90,19 +204,19 @@ GUI::LayerSet::~LayerSet() = default;
 GUI::LayerSet::LayerSet(APILayerStore* const store)
   : mStore(store),
     mReadWriteStore(dynamic_cast<ReadWriteAPILayerStore*>(store)) {
-  mOnChangeConnection
-    = store->OnChange([this] { this->mLayerDataIsStale = true; });
   mOnLoaderDataConnection = Platform::Get().OnLoaderData(
     [this] { this->mLintErrorsAreStale = true; });
+  mOnRulesChangeConnection = UserLayerRules::Get().OnChange(
+    [this] { this->mLintErrorsAreStale = true; });
 }
 
 GUI::LayerSet::LayerSet(ReadWriteAPILayerStore* const store)
   : mStore(store),
     mReadWriteStore(store) {
-  mOnChangeConnection
-    = store->OnChange([this] { this->mLayerDataIsStale = true; });
   mOnLoaderDataConnection = Platform::Get().OnLoaderData(
     [this] { this->mLintErrorsAreStale = true; });
+  mOnRulesChangeConnection = UserLayerRules::Get().OnChange(
+    [this] { this->mLintErrorsAreStale = true; });
 }
 
 void GUI::LayerSet::GUILayersList() {
@@ -131,18 +245,20 @@ void GUI::LayerSet::GUILayersList() {
       if (ImGui::Checkbox("##Enabled", &layerIsEnabled)) {
         using Value = APILayer::Value;
         layer.mValue = layerIsEnabled ? Value::Enabled : Value::Disabled;
-        if (mReadWriteStore->SetAPILayers(mLayers)) {
-          mLintErrorsAreStale = true;
-          mLayerDataIsStale = true;
-        }
+        this->EditLayers(mLayers);
       }
       ImGui::EndDisabled();
 
-      auto label = layer.GetKey().mValue;
+      auto label = layer.GetKey().GetValue();
 
       if (!layerErrors.empty()) {
         label = fmt::format("{} {}", Config::GLYPH_ERROR, label);
       }
+      if (
+        mStagedDiff && std::cmp_less(i, mStagedDiff->mChangedRows.size())
+        && mStagedDiff->mChangedRows.at(i)) {
+        label = fmt::format("{} {}", Config::GLYPH_STAGED, label);
+      }
 
       ImGui::SameLine();
 
@@ -201,16 +317,12 @@ void GUI::LayerSet::GUIButtons() {
     using Value = APILayer::Value;
     if (ImGui::Button("Enable Layer", {-FLT_MIN, 0})) {
       mSelectedLayer->mValue = Value::Enabled;
-      if (mReadWriteStore->SetAPILayers(mLayers)) {
-        mLintErrorsAreStale = true;
-      }
+      this->EditLayers(mLayers);
     }
 
     if (ImGui::Button("Disable Layer", {-FLT_MIN, 0})) {
       mSelectedLayer->mValue = Value::Disabled;
-      if (mReadWriteStore->SetAPILayers(mLayers)) {
-        mLintErrorsAreStale = true;
-      }
+      this->EditLayers(mLayers);
     }
     ImGui::EndDisabled();
   }
@@ -224,9 +336,7 @@ void GUI::LayerSet::GUIButtons() {
     auto it = std::ranges::find(newLayers, *mSelectedLayer);
     if (it != newLayers.begin() && it != newLayers.end()) {
       std::iter_swap((it - 1), it);
-      if (mReadWriteStore->SetAPILayers(newLayers)) {
-        mLayerDataIsStale = true;
-      }
+      this->EditLayers(newLayers);
     }
   }
   ImGui::EndDisabled();
@@ -237,20 +347,41 @@ void GUI::LayerSet::GUIButtons() {
     auto it = std::ranges::find(newLayers, *mSelectedLayer);
     if (it != newLayers.end() && (it + 1) != newLayers.end()) {
       std::iter_swap(it, it + 1);
-      if (mReadWriteStore->SetAPILayers(newLayers)) {
-        mLayerDataIsStale = true;
-      }
+      this->EditLayers(newLayers);
     }
   }
   ImGui::EndDisabled();
 
+  if (IsReadWrite()) {
+    ImGui::Separator();
+    const auto hasStagedChanges = this->HasStagedChanges();
+    ImGui::BeginDisabled(mUndoIDs.empty() || hasStagedChanges);
+    if (ImGui::Button("Undo", {-FLT_MIN, 0})) {
+      this->Undo();
+    }
+    ImGui::EndDisabled();
+    ImGui::BeginDisabled(mRedoIDs.empty() || hasStagedChanges);
+    if (ImGui::Button("Redo", {-FLT_MIN, 0})) {
+      this->Redo();
+    }
+    ImGui::EndDisabled();
+
+    ImGui::Separator();
+    this->GUIStagingButtons();
+  }
+
   for (const auto arch: mStore->GetArchitectures().enumerate()) {
     const auto loaderData = Platform::Get().GetLoaderData(arch);
+    const auto archName = magic_enum::enum_name(arch);
     if (loaderData) {
+      if ((*loaderData)->mIsRefreshing) {
+        ImGui::TextWrapped(
+          "%s",
+          std::format("⌛ Refreshing {} runtime data...", archName).c_str());
+      }
       continue;
     }
 
-    const auto archName = magic_enum::enum_name(arch);
     if (holds_alternative<LoaderData::PendingError>(loaderData.error())) {
       ImGui::TextWrapped(
         "%s", std::format("⌛ Fetching {} runtime data...", archName).c_str());
@@ -267,21 +398,145 @@ void GUI::LayerSet::GUIButtons() {
   ImGui::EndGroup();
 }
 
+void GUI::LayerSet::GUIStagingButtons() {
+  const auto hasStagedChanges = this->HasStagedChanges();
+  ImGui::BeginDisabled(hasStagedChanges);
+  ImGui::Checkbox("Stage Changes", &mStageChanges);
+  ImGui::EndDisabled();
+
+  if (mStageChanges) {
+    ImGui::BeginDisabled(!hasStagedChanges);
+    if (ImGui::Button("Apply Changes", {-FLT_MIN, 0})) {
+      this->ApplyStagedChanges();
+    }
+    if (mStagedDiff) {
+      GUIFixPreviewTooltip(&mStagedDiff->mLint);
+    }
+    if (ImGui::Button("Discard Changes", {-FLT_MIN, 0})) {
+      this->DiscardStagedChanges();
+    }
+    ImGui::EndDisabled();
+
+    if (mStagedDiff) {
+      ImGui::TextWrapped(
+        "%s",
+        fmt::format(
+          "{} {} changed, {} removed",
+          Config::GLYPH_STAGED,
+          std::ranges::count(mStagedDiff->mChangedRows, true),
+          mStagedDiff->mRemoved.size())
+          .c_str());
+      for (auto&& layer: mStagedDiff->mRemoved) {
+        ImGui::BulletText("%s", layer.GetDisplayPath().c_str());
+      }
+    }
+  }
+
+  if (!mCommitError) {
+    return;
+  }
+  using ConflictError = LayerStoreTransaction::ConflictError;
+  using WriteError = LayerStoreTransaction::WriteError;
+  std::string message;
+  if (holds_alternative<ConflictError>(*mCommitError)) {
+    message = "Couldn't save changes: another program changed the layers.";
+  } else if (get<WriteError>(*mCommitError).mRolledBack) {
+    message = "Couldn't save changes; the previous layers were restored.";
+  } else {
+    message = "Couldn't save changes, or restore the previous layers.";
+  }
+  ImGui::TextWrapped(
+    "%s", fmt::format("{} {}", Config::GLYPH_ERROR, message).c_str());
+}
+
 void GUI::LayerSet::GUITabs() {
   if (ImGui::BeginTabBar("##ErrorDetailsTabs", ImGuiTabBarFlags_None)) {
     this->GUIErrorsTab();
     this->GUIDetailsTab();
+    this->GUICompatibilityTab();
+    this->GUIRuntimesTab();
+    if (IsReadWrite()) {
+      this->GUIHistoryTab();
+    }
 
     ImGui::EndTabBar();
   }
 }
 
+void GUI::LayerSet::GUIHistoryTab() {
+  if (!ImGui::BeginTabItem("History")) {
+    return;
+  }
+  ImGui::BeginChild("##ScrollArea", {-FLT_MIN, -FLT_MIN});
+
+  this->UpdateHistory();
+  if (mHistory.empty()) {
+    ImGui::Text("No changes have been recorded.");
+  } else {
+    ImGui::BeginTable(
+      "##History", 3, ImGuiTableFlags_BordersInnerH | ImGuiTableFlags_RowBg);
+    ImGui::TableSetupColumn("Time", ImGuiTableColumnFlags_WidthFixed);
+    ImGui::TableSetupColumn("Description");
+    ImGui::TableSetupColumn("Buttons", ImGuiTableColumnFlags_WidthFixed);
+    ImGui::BeginDisabled(this->HasStagedChanges());
+    for (auto&& entry: mHistory) {
+      ImGui::PushID(static_cast<int>(entry.mID));
+      ImGui::TableNextRow();
+      ImGui::TableNextColumn();
+      ImGui::Text("%s", entry.mTime.c_str());
+      ImGui::TableNextColumn();
+      ImGui::TextWrapped(
+        "%s",
+        entry.mKind == ChangeJournal::Kind::Edit
+          ? "Edited"
+          : "Changed outside of this app, or first seen");
+      ImGui::TableNextColumn();
+      if (ImGui::Button("Restore")) {
+        if (
+          const auto entries = ChangeJournal::Get().GetStateAfter(
+            mStore->GetDisplayName(), entry.mID)) {
+          this->CommitEdit(ToAPILayers(mStore, *entries));
+        }
+      }
+      ImGui::SetItemTooltip("Restore the layers as they were after this");
+      ImGui::PopID();
+    }
+    ImGui::EndDisabled();
+    ImGui::EndTable();
+  }
+
+  ImGui::EndChild();
+  ImGui::EndTabItem();
+}
+
+void GUI::LayerSet::UpdateHistory() {
+  auto& journal = ChangeJournal::Get();
+  const auto generation = journal.GetGeneration();
+  if (generation == mHistoryGeneration) {
+    return;
+  }
+  mHistoryGeneration = generation;
+
+  const auto history = journal.GetHistory(mStore->GetDisplayName());
+  const auto zone = std::chrono::current_zone();
+  mHistory.clear();
+  for (auto&& entry: std::views::reverse(history)) {
+    const std::chrono::zoned_time time {
+      zone, std::chrono::floor<std::chrono::seconds>(entry.mTime)};
+    mHistory.push_back({
+      .mID = entry.mID,
+      .mKind = entry.mKind,
+      .mTime = std::format("{:%F %T}", time),
+    });
+  }
+}
+
 void GUI::LayerSet::GUIErrorsTab() {
   if (ImGui::BeginTabItem("Warnings")) {
     ImGui::BeginChild("##ScrollArea", {-FLT_MIN, -FLT_MIN});
 
     if (mSelectedLayer) {
-      ImGui::Text("For %s:", mSelectedLayer->mManifestPath.string().c_str());
+      ImGui::Text("For %s:", mSelectedLayer->GetDisplayPath().c_str());
     } else {
       ImGui::Text("All layers:");
     }
@@ -349,16 +604,20 @@ void GUI::LayerSet::GUIErrorsTab() {
               selectedErrors.size())
               .c_str());
         }
-        if (const auto store = mReadWriteStore) {
+        if (mReadWriteStore) {
           ImGui::SameLine();
           if (ImGui::Button("Fix Them!")) {
             auto nextLayers = mLayers;
             for (auto&& fixable: fixableErrors) {
               nextLayers = fixable->Fix(nextLayers);
             }
-            if (store->SetAPILayers(nextLayers)) {
-              mLayerDataIsStale = true;
-            }
+            this->EditLayers(nextLayers);
+          }
+          // The preview is for all errors, not just the selected layer's
+          if (
+            !mSelectedLayer
+            && ImGui::IsItemHovered(ImGuiHoveredFlags_ForTooltip)) {
+            GUIFixPreviewTooltip(this->GetFixAllPreview());
           }
         }
       }
@@ -384,9 +643,10 @@ void GUI::LayerSet::GUIErrorsTab() {
           const auto fixable = fixer && fixer->IsFixable() && mReadWriteStore;
           ImGui::BeginDisabled(!fixable);
           if (ImGui::Button("Fix It!")) {
-            if (mReadWriteStore->SetAPILayers(fixer->Fix(mLayers))) {
-              mLayerDataIsStale = true;
-            }
+            this->EditLayers(fixer->Fix(mLayers));
+          }
+          if (fixable && ImGui::IsItemHovered(ImGuiHoveredFlags_ForTooltip)) {
+            GUIFixPreviewTooltip(this->GetFixPreview(*error));
           }
           ImGui::EndDisabled();
         }
@@ -406,6 +666,41 @@ void GUI::LayerSet::GUIErrorsTab() {
   }
 }
 
+void GUI::LayerSet::GUIFixPreviewTooltip(const LintDiff* const diff) {
+  if (!ImGui::BeginItemTooltip()) {
+    return;
+  }
+  if (!diff) {
+    ImGui::Text("Checking what this would fix...");
+    // Nothing else draws a frame when the preview is ready
+    Platform::Get().RequestFrame(
+      std::chrono::steady_clock::now() + FixPreviewPollInterval);
+    ImGui::EndTooltip();
+    return;
+  }
+  ImGui::PushTextWrapPos(ImGui::GetFontSize() * 40);
+
+  ImGui::Text(
+    "%s",
+    fmt::format(
+      "Resolves {} warning(s), leaving {}.",
+      diff->mResolved.size(),
+      diff->mErrors.size())
+      .c_str());
+  if (diff->mIntroduced.empty()) {
+    ImGui::Text("No new warnings.");
+  } else {
+    ImGui::Separator();
+    ImGui::Text("New warnings:");
+    for (auto&& error: diff->mIntroduced) {
+      ImGui::BulletText("%s", error->GetDescription().c_str());
+    }
+  }
+
+  ImGui::PopTextWrapPos();
+  ImGui::EndTooltip();
+}
+
 void GUI::LayerSet::GUIDetailsTab() {
   if (ImGui::BeginTabItem("Details")) {
     ImGui::BeginChild("##ScrollArea", {-FLT_MIN, -FLT_MIN});
@@ -420,12 +715,12 @@ void GUI::LayerSet::GUIDetailsTab() {
       ImGui::Text("JSON File");
       ImGui::TableNextColumn();
       if (ImGui::Button("Copy##CopyJSONFile")) {
-        ImGui::SetClipboardText(mSelectedLayer->mManifestPath.string().c_str());
+        ImGui::SetClipboardText(mSelectedLayer->GetDisplayPath().c_str());
       }
       ImGui::SameLine();
-      ImGui::Text("%s", mSelectedLayer->mManifestPath.string().c_str());
+      ImGui::Text("%s", mSelectedLayer->GetDisplayPath().c_str());
 
-      const APILayerDetails details {mSelectedLayer->mManifestPath};
+      const APILayerDetails details {mSelectedLayer->GetManifestPath()};
       if (details.mState != APILayerDetails::State::Loaded) {
         const auto error = details.StateAsString();
         ImGui::TableNextRow();
@@ -565,10 +860,178 @@ void GUI::LayerSet::GUIDetailsTab() {
   }
 }
 
+void GUI::LayerSet::GUIRuntimesTab() {
+  if (!ImGui::BeginTabItem("Runtimes")) {
+    return;
+  }
+  if (!std::exchange(mQueriedAvailableRuntimes, true)) {
+    Platform::Get().QueryAvailableRuntimes();
+  }
+  ImGui::BeginChild("##ScrollArea", {-FLT_MIN, -FLT_MIN});
+
+  const RuntimeMatrix matrix {mLayers, mDetails};
+  if (matrix.empty()) {
+    ImGui::BeginDisabled();
+    ImGui::Text("There are no enabled implicit layers, or no runtimes.");
+    ImGui::EndDisabled();
+    ImGui::EndChild();
+    ImGui::EndTabItem();
+    return;
+  }
+
+  ImGui::TextWrapped(
+    "Each cell shows whether the layer in that row is loaded with the runtime "
+    "in that column: %s loaded, %s not loaded, %s blocked by the runtime, %s "
+    "could not query the runtime.",
+    Config::GLYPH_ENABLED,
+    Config::GLYPH_DISABLED,
+    Config::GLYPH_BLOCKED,
+    Config::GLYPH_ERROR);
+
+  const auto& runtimes = matrix.GetRuntimes();
+  if (ImGui::BeginTable(
+        "##RuntimeMatrix",
+        static_cast<int>(runtimes.size() + 1),
+        ImGuiTableFlags_Borders | ImGuiTableFlags_SizingFixedFit)) {
+    ImGui::TableSetupColumn("Layer");
+    for (auto&& [i, runtime]: std::views::enumerate(runtimes)) {
+      // The ID is stable while the runtime is being refreshed
+      ImGui::TableSetupColumn(
+        fmt::format(
+          "{}{} ({})###runtime-{}",
+          runtime.mIsRefreshing
+            ? fmt::format("{} ", Config::GLYPH_PENDING)
+            : std::string {},
+          runtime.mName,
+          magic_enum::enum_name(runtime.mArchitecture),
+          i)
+          .c_str());
+    }
+    ImGui::TableHeadersRow();
+
+    for (auto&& [row, layer]: std::views::enumerate(matrix.GetLayers())) {
+      ImGui::TableNextRow();
+      ImGui::TableNextColumn();
+      ImGui::Text("%s", layer.c_str());
+      for (std::size_t column = 0; column < runtimes.size(); ++column) {
+        ImGui::TableNextColumn();
+        const auto cell = matrix.Get(row, column);
+        const auto glyph = RuntimeMatrix::GetGlyph(cell);
+        ImGui::TextUnformatted(glyph.data(), glyph.data() + glyph.size());
+        if (cell != RuntimeMatrix::Cell::NotApplicable) {
+          ImGui::SetItemTooltip(
+            "%s", std::string {RuntimeMatrix::GetDescription(cell)}.c_str());
+        }
+      }
+    }
+    ImGui::EndTable();
+  }
+
+  ImGui::EndChild();
+  ImGui::EndTabItem();
+}
+
+void GUI::LayerSet::GUICompatibilityTab() {
+  if (!ImGui::BeginTabItem("Compatibility")) {
+    return;
+  }
+  ImGui::BeginChild("##ScrollArea", {-FLT_MIN, -FLT_MIN});
+
+  std::vector<std::size_t> related;
+  if (mRelations) {
+    for (std::size_t i = 0; i < mRelations->size(); ++i) {
+      if (mRelations->HasAnyRelation(i)) {
+        related.push_back(i);
+      }
+    }
+  }
+
+  if (related.empty()) {
+    ImGui::BeginDisabled();
+    ImGui::Text("There are no known rules between these layers.");
+    ImGui::EndDisabled();
+    ImGui::EndChild();
+    ImGui::EndTabItem();
+    return;
+  }
+
+  ImGui::TextWrapped(
+    "Each cell shows how the layer in that row relates to the layer in that "
+    "column: \u2191 must be above, \u2193 must be below, \u00d7 incompatible, "
+    "%s incompatible in the same game.",
+    Config::GLYPH_ERROR);
+
+  const auto cellText = [this](const std::size_t row, const std::size_t col) {
+    using enum LayerRelation;
+    const auto& relations = *mRelations;
+    if (
+      relations.Test(Conflicts, row, col)
+      || relations.Test(Conflicts, col, row)) {
+      return "\u00d7";
+    }
+    if (
+      relations.Test(ConflictsPerApp, row, col)
+      || relations.Test(ConflictsPerApp, col, row)) {
+      return Config::GLYPH_ERROR;
+    }
+    if (relations.Test(Above, row, col) || relations.Test(Below, col, row)) {
+      return "\u2191";
+    }
+    if (relations.Test(Below, row, col) || relations.Test(Above, col, row)) {
+      return "\u2193";
+    }
+    return "";
+  };
+
+  if (ImGui::BeginTable(
+        "##CompatibilityMatrix",
+        static_cast<int>(related.size() + 1),
+        ImGuiTableFlags_Borders | ImGuiTableFlags_SizingFixedFit)) {
+    ImGui::TableSetupColumn("Layer");
+    for (std::size_t i = 0; i < related.size(); ++i) {
+      ImGui::TableSetupColumn(fmt::to_string(i + 1).c_str());
+    }
+    ImGui::TableHeadersRow();
+
+    for (auto&& [i, row]: std::views::enumerate(related)) {
+      ImGui::TableNextRow();
+      ImGui::TableNextColumn();
+      ImGui::Text(
+        "%s",
+        fmt::format("{}. {}", i + 1, get<1>(mRelationsLayers.at(row)).mName)
+          .c_str());
+      for (const auto column: related) {
+        ImGui::TableNextColumn();
+        ImGui::Text("%s", cellText(row, column));
+      }
+    }
+    ImGui::EndTable();
+  }
+
+  ImGui::Separator();
+  for (auto&& description: DescribeRelations(*mRelations, mRelationsLayers)) {
+    ImGui::BulletText("%s", description.c_str());
+  }
+
+  ImGui::EndChild();
+  ImGui::EndTabItem();
+}
+
 void GUI::LayerSet::ReloadLayerDataNow() {
-  auto newLayers = mStore->GetAPILayers();
+  mLayerDataIsStale = false;
+  if (this->HasStagedChanges()) {
+    // Keep the working copy; if the store has changed, applying it will fail
+    // with a conflict
+    return;
+  }
+  mSnapshot = mStore->GetSnapshot();
+  this->SetLayers(mSnapshot->mLayers);
+}
+
+void GUI::LayerSet::SetLayers(std::vector<APILayer> newLayers) {
   if (mSelectedLayer) {
-    auto it = std::ranges::find(newLayers, *mSelectedLayer);
+    auto it = std::ranges::find(
+      newLayers, mSelectedLayer->GetKey(), &APILayer::GetKey);
     if (it != newLayers.end()) {
       mSelectedLayer = &*it;
     } else {
@@ -576,10 +1039,84 @@ void GUI::LayerSet::ReloadLayerDataNow() {
     }
   }
   mLayers = std::move(newLayers);
-  mLayerDataIsStale = false;
   mLintErrorsAreStale = true;
 }
 
+bool GUI::LayerSet::HasStagedChanges() const {
+  return mStageChanges && mSnapshot && mLayers != mSnapshot->mLayers;
+}
+
+void GUI::LayerSet::EditLayers(std::vector<APILayer> layers) {
+  if (mStageChanges) {
+    this->SetLayers(std::move(layers));
+    return;
+  }
+  this->CommitEdit(std::move(layers));
+}
+
+void GUI::LayerSet::CommitEdit(std::vector<APILayer> layers) {
+  if (const auto id = this->CommitLayers(std::move(layers))) {
+    mUndoIDs.push_back(id);
+    mRedoIDs.clear();
+  }
+}
+
+uint64_t GUI::LayerSet::CommitLayers(std::vector<APILayer> layers) {
+  LayerStoreTransaction transaction;
+  transaction.Stage(&GetReadWriteStore(), mSnapshot, std::move(layers));
+  const auto result = transaction.Commit();
+  // Even if the commit failed, `mLayers` may have been modified, or the
+  // store may have changed underneath us
+  mLayerDataIsStale = true;
+  if (!result) {
+    mCommitError = result.error();
+    return 0;
+  }
+  mCommitError.reset();
+  // The new base for any further staged changes
+  mSnapshot = mStore->GetSnapshot();
+  return *result;
+}
+
+void GUI::LayerSet::ApplyStagedChanges() {
+  this->CommitEdit(mLayers);
+}
+
+void GUI::LayerSet::Undo() {
+  this->Revert(mUndoIDs, mRedoIDs);
+}
+
+void GUI::LayerSet::Redo() {
+  this->Revert(mRedoIDs, mUndoIDs);
+}
+
+void GUI::LayerSet::Revert(
+  std::vector<uint64_t>& from,
+  std::vector<uint64_t>& to) {
+  const auto before = ChangeJournal::Get().GetStateBefore(
+    mStore->GetDisplayName(), from.back());
+  if (!before) {
+    // The entry is no longer in the journal
+    from.clear();
+    return;
+  }
+  const auto id = this->CommitLayers(ToAPILayers(mStore, *before));
+  if (mCommitError) {
+    return;
+  }
+  from.pop_back();
+  // 0 if the store already matched
+  if (id) {
+    to.push_back(id);
+  }
+}
+
+void GUI::LayerSet::DiscardStagedChanges() {
+  mCommitError.reset();
+  this->SetLayers(mSnapshot->mLayers);
+  mLayerDataIsStale = true;
+}
+
 bool GUI::LayerSet::HasErrors() {
   if (mLayerDataIsStale) {
     this->ReloadLayerDataNow();
@@ -591,16 +1128,137 @@ bool GUI::LayerSet::HasErrors() {
 }
 
 void GUI::LayerSet::RunAllLintersNow() {
-  mLintErrors = RunAllLinters(mStore, mLayers);
+  const auto staged = this->HasStagedChanges();
+  if (!staged) {
+    // Manifests may have changed since they were loaded
+    mDetails.clear();
+  }
+  LoadAPILayerDetails(mDetails, mLayers);
+  // Before linting, so that the linters can reuse them
+  this->UpdateRelations(mDetails);
+  // Before linting, so that changes while we are linting are not lost
   mLintErrorsAreStale = false;
+  mLintErrors = RunAllLinters(mStore, mLayers, mDetails, mRelations.get());
+  if (staged) {
+    this->UpdateStagedDiff();
+  } else {
+    mBaseLintErrors = mLintErrors;
+    mStagedDiff.reset();
+  }
+  this->StartFixPreviews();
+}
+
+void GUI::LayerSet::UpdateStagedDiff() {
+  const auto& base = mSnapshot->mLayers;
+  StagedDiff diff {
+    .mChangedRows = GetChangedRows(base, mLayers),
+    .mLint = DiffLintErrors(mLayers, mLintErrors, mBaseLintErrors),
+  };
+  for (auto&& layer: base) {
+    if (!std::ranges::contains(mLayers, layer.GetKey(), &APILayer::GetKey)) {
+      diff.mRemoved.push_back(layer);
+    }
+  }
+  mStagedDiff = std::move(diff);
+}
+
+void GUI::LayerSet::UpdateRelations(const APILayerDetailsMap& details) {
+  mRelationsLayers.clear();
+  for (auto&& layer: mLayers) {
+    const auto& layerDetails = details.at(layer.GetManifestPath());
+    if (layerDetails->mState != APILayerDetails::State::Loaded) {
+      continue;
+    }
+    mRelationsLayers.emplace_back(layer, layerDetails);
+  }
+  mRelations = std::make_shared<const LayerRelations>(
+    *GetLayerRules(), mRelationsLayers);
+}
+
+void GUI::LayerSet::StartFixPreviews() {
+  if (mFixPreviews.mFuture.valid()) {
+    mObsoleteFixPreviews.push_back(std::move(mFixPreviews.mFuture));
+  }
+  std::erase_if(mObsoleteFixPreviews, [](const auto& future) {
+    return future.wait_for(std::chrono::seconds::zero())
+      == std::future_status::ready;
+  });
+  mFixPreviews = {};
+
+  std::vector<std::vector<APILayer>> candidates;
+  // Matches the "Fix Them!" button
+  auto allFixed = mLayers;
+  bool haveFixes = false;
+  for (auto&& error: mLintErrors) {
+    const auto fixer = std::dynamic_pointer_cast<FixableLintError>(error);
+    if (!fixer) {
+      continue;
+    }
+    haveFixes = true;
+    allFixed = fixer->Fix(allFixed);
+    if (fixer->IsFixable()) {
+      mFixPreviews.mErrors.push_back(error.get());
+      candidates.push_back(fixer->Fix(mLayers));
+    }
+  }
+  if (!haveFixes) {
+    return;
+  }
+  candidates.push_back(std::move(allFixed));
+
+  // Copies, as these are replaced when the layers are linted again, which may
+  // be before the previews are ready
+  mFixPreviews.mFuture = std::async(
+    std::launch::async,
+    [store = mStore,
+     candidates = std::move(candidates),
+     details = mDetails,
+     baseErrors = mLintErrors,
+     relations = mRelations] {
+      return RunAllLintersForCandidates(
+        store, candidates, details, baseErrors, relations.get());
+    });
+}
+
+bool GUI::LayerSet::FixPreviewsAreReady() {
+  auto& previews = mFixPreviews;
+  if (!previews.mDiffs.empty()) {
+    return true;
+  }
+  if (
+    !previews.mFuture.valid()
+    || previews.mFuture.wait_for(std::chrono::seconds::zero())
+      != std::future_status::ready) {
+    return false;
+  }
+  previews.mDiffs = previews.mFuture.get();
+  return true;
+}
+
+const LintDiff* GUI::LayerSet::GetFixPreview(const LintError& error) {
+  if (!this->FixPreviewsAreReady()) {
+    return nullptr;
+  }
+  const auto it = std::ranges::find(mFixPreviews.mErrors, &error);
+  if (it == mFixPreviews.mErrors.end()) {
+    return nullptr;
+  }
+  return &mFixPreviews.mDiffs.at(
+    std::distance(mFixPreviews.mErrors.begin(), it));
+}
+
+const LintDiff* GUI::LayerSet::GetFixAllPreview() {
+  if (!this->FixPreviewsAreReady()) {
+    return nullptr;
+  }
+  return &mFixPreviews.mDiffs.back();
 }
 
 void GUI::LayerSet::AddLayersClicked() {
-  const auto& store = GetReadWriteStore();
   auto paths = Platform::Get().GetNewAPILayerJSONPaths();
   for (auto it = paths.begin(); it != paths.end();) {
-    auto existingLayer = std::ranges::find_if(
-      mLayers, [it](const auto& layer) { return layer.mManifestPath == *it; });
+    auto existingLayer
+      = std::ranges::find(mLayers, *it, &APILayer::GetManifestPath);
     if (existingLayer != mLayers.end()) {
       it = paths.erase(it);
       continue;
@@ -616,10 +1274,15 @@ void GUI::LayerSet::AddLayersClicked() {
     nextLayers.emplace_back(mStore, path, APILayer::Value::Enabled);
   }
 
+  // Only the order changes between iterations, so we only need to load the
+  // manifests once
+  APILayerDetailsMap details;
+  LoadAPILayerDetails(details, nextLayers);
+
   bool changed = false;
   do {
     changed = false;
-    auto errors = RunAllLinters(mStore, nextLayers);
+    auto errors = RunAllLinters(mStore, nextLayers, details);
     const auto nextKeys = std::views::transform(nextLayers, &APILayer::GetKey)
       | std::ranges::to<std::unordered_set>();
 
@@ -639,9 +1302,7 @@ void GUI::LayerSet::AddLayersClicked() {
 
       if (fixed.size() <= nextLayers.size()) {
         // Don't just silently fail. Add it with a lint error
-        if (store.SetAPILayers(nextLayers)) {
-          mLayerDataIsStale = true;
-        }
+        this->EditLayers(nextLayers);
         return;
       }
 
@@ -652,13 +1313,10 @@ void GUI::LayerSet::AddLayersClicked() {
     }
   } while (changed);
 
-  if (store.SetAPILayers(nextLayers)) {
-    mLayerDataIsStale = true;
-  }
+  this->EditLayers(nextLayers);
 }
 
 void GUI::LayerSet::GUIRemoveLayerPopup() {
-  const auto& store = GetReadWriteStore();
   auto viewport = ImGui::GetMainViewport();
   ImVec2 center = viewport->GetCenter();
   ImGui::SetNextWindowPos(center, ImGuiCond_Appearing, ImVec2(0.5f, 0.5f));
@@ -669,7 +1327,7 @@ void GUI::LayerSet::GUIRemoveLayerPopup() {
       "Are you sure you want to completely remove '%s'?\n\nThis can not "
       "be "
       "undone.",
-      mSelectedLayer->mManifestPath.string().c_str());
+      mSelectedLayer->GetDisplayPath().c_str());
     ImGui::Separator();
     const auto dpiScaling = Platform::Get().GetDPIScaling();
     ImGui::SetCursorPosX((256 + 128) * dpiScaling);
@@ -678,9 +1336,7 @@ void GUI::LayerSet::GUIRemoveLayerPopup() {
       auto it = std::ranges::find(nextLayers, *mSelectedLayer);
       if (it != nextLayers.end()) {
         nextLayers.erase(it);
-        if (store.SetAPILayers(nextLayers)) {
-          mLayerDataIsStale = true;
-        }
+        this->EditLayers(nextLayers);
       }
       ImGui::CloseCurrentPopup();
     }
@@ -697,8 +1353,6 @@ void GUI::LayerSet::GUIRemoveLayerPopup() {
 void GUI::LayerSet::DragDropReorder(
   const APILayer& source,
   const APILayer& target) {
-  const auto& store = GetReadWriteStore();
-
   auto newLayers = mLayers;
 
   auto sourceIt = std::ranges::find(newLayers, source);
@@ -722,9 +1376,7 @@ void GUI::LayerSet::DragDropReorder(
   newLayers.insert(targetIt, source);
 
   assert(mLayers.size() == newLayers.size());
-  if (store.SetAPILayers(newLayers)) {
-    mLayerDataIsStale = true;
-  }
+  this->EditLayers(newLayers);
 }
 
 void GUI::LayerSet::Draw() {
@@ -5,14 +5,26 @@
 
 #include <boost/signals2/connection.hpp>
 
+#include <atomic>
+#include <cstdint>
 #include <deque>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "APILayer.hpp"
+#include "ChangeJournal.hpp"
+#include "LayerRelations.hpp"
+#include "LayerStoreTransaction.hpp"
 #include "Linter.hpp"
+#include "StoreChangeQueue.hpp"
 
 namespace FredEmmott::OpenXRLayers {
 class ReadWriteAPILayerStore;
+struct StoreSnapshot;
 
 // The actual app GUI
 class GUI final {
@@ -26,8 +38,6 @@ class GUI final {
   void Run();
 
  private:
-  using LintErrors = std::vector<std::shared_ptr<LintError>>;
-
   class LayerSet final {
    public:
     LayerSet() = delete;
@@ -55,11 +65,65 @@ class GUI final {
       return *mReadWriteStore;
     }
 
+    // The source of `mLayers`, and the base for changes to them
+    std::shared_ptr<const StoreSnapshot> mSnapshot;
+    // If staging changes, this is the working copy
     std::vector<APILayer> mLayers;
     APILayer* mSelectedLayer {nullptr};
     LintErrors mLintErrors;
+    // What would happen if we applied the fix for each fixable error, or all
+    // of them ("Fix Them!"); computed off the GUI thread after linting
+    struct FixPreviews {
+      // The candidates are the fix for each of these, then all of them
+      std::vector<const LintError*> mErrors;
+      std::future<std::vector<LintDiff>> mFuture;
+      // Empty until `mFuture` is ready
+      std::vector<LintDiff> mDiffs;
+    };
+    FixPreviews mFixPreviews;
+    // Previews for earlier lint runs that are still being computed; kept
+    // until they finish, as destroying them would block the GUI thread
+    std::vector<std::future<std::vector<LintDiff>>> mObsoleteFixPreviews;
+    // Layers with loaded manifests, and the rules that apply between them;
+    // shared with the fix previews
+    LayerRelations::Layers mRelationsLayers;
+    std::shared_ptr<const LayerRelations> mRelations;
     bool mLayerDataIsStale {true};
-    bool mLintErrorsAreStale {true};
+    // Set from other threads, e.g. when loader data is available
+    std::atomic<bool> mLintErrorsAreStale {true};
+    // Details for `mLayers`; kept while staging, as only the order and
+    // values change
+    APILayerDetailsMap mDetails;
+    // Set when the runtimes tab is first opened, as querying each runtime
+    // loads it
+    bool mQueriedAvailableRuntimes {false};
+
+    // If true, edits only change `mLayers` until they are applied
+    bool mStageChanges {false};
+    struct StagedDiff {
+      // Indexed like `mLayers`; true if added, toggled, or moved
+      std::vector<bool> mChangedRows;
+      std::vector<APILayer> mRemoved;
+      // Compared to `mBaseLintErrors`
+      LintDiff mLint;
+    };
+    std::optional<StagedDiff> mStagedDiff;
+    // Errors for `mSnapshot`
+    LintErrors mBaseLintErrors;
+    std::optional<LayerStoreTransaction::Error> mCommitError;
+    struct HistoryRow {
+      uint64_t mID {};
+      ChangeJournal::Kind mKind {};
+      // Formatted once, as looking up the time zone is relatively expensive
+      std::string mTime;
+    };
+    // This store's `ChangeJournal` history, newest first; refreshed when the
+    // journal's generation changes
+    std::vector<HistoryRow> mHistory;
+    uint64_t mHistoryGeneration {0};
+    // `ChangeJournal` IDs of this layer set's commits
+    std::vector<uint64_t> mUndoIDs;
+    std::vector<uint64_t> mRedoIDs;
 
     bool HasErrors();
 
@@ -68,17 +132,53 @@ class GUI final {
     void GUILayersList();
 
     void GUIButtons();
+    void GUIStagingButtons();
     void GUIRemoveLayerPopup();
 
     void GUITabs();
     void GUIErrorsTab();
     void GUIDetailsTab();
+    void GUICompatibilityTab();
+    void GUIRuntimesTab();
+    void GUIHistoryTab();
+    void UpdateHistory();
+    /// `diff` is nullptr if the preview is still being computed
+    static void GUIFixPreviewTooltip(const LintDiff* diff);
 
     // This should only be called at the top of the frame loop; set
     // mLayerDataIsStale instead.
     void ReloadLayerDataNow();
     // Set mLayerDataIsStale or mLintErrorsAreStale instead
     void RunAllLintersNow();
+    void StartFixPreviews();
+    /// Whether `mFixPreviews.mDiffs` is filled in
+    bool FixPreviewsAreReady();
+    /// nullptr if the previews are still being computed
+    const LintDiff* GetFixPreview(const LintError&);
+    const LintDiff* GetFixAllPreview();
+    void UpdateRelations(const APILayerDetailsMap&);
+    void UpdateStagedDiff();
+
+    [[nodiscard]]
+    bool HasStagedChanges() const;
+    /// Replace `mLayers`, keeping the selection
+    void SetLayers(std::vector<APILayer>);
+    /// Stage or commit the new layers, depending on `mStageChanges`
+    void EditLayers(std::vector<APILayer>);
+    /// Commit the new layers, and make it undoable
+    void CommitEdit(std::vector<APILayer>);
+    /** Replace the store's layers if it has not changed since `mSnapshot`.
+     *
+     * Returns the journal ID, or 0 if nothing was written.
+     */
+    uint64_t CommitLayers(std::vector<APILayer>);
+    void ApplyStagedChanges();
+    void DiscardStagedChanges();
+
+    void Undo();
+    void Redo();
+    /// Restore the state from before `from.back()`, and move it to `to`
+    void Revert(std::vector<uint64_t>& from, std::vector<uint64_t>& to);
 
     void AddLayersClicked();
     void DragDropReorder(const APILayer& source, const APILayer& target);
@@ -88,14 +188,17 @@ class GUI final {
     }
 
    private:
-    boost::signals2::scoped_connection mOnChangeConnection;
     boost::signals2::scoped_connection mOnLoaderDataConnection;
+    boost::signals2::scoped_connection mOnRulesChangeConnection;
 
     const APILayerStore* mStore {nullptr};
     ReadWriteAPILayerStore* mReadWriteStore {nullptr};
   };
 
   std::vector<std::unique_ptr<LayerSet>> mLayerSets;
+  // Declared before the connections, so it outlives them
+  std::optional<StoreChangeQueue> mStoreChanges;
+  std::vector<boost::signals2::scoped_connection> mStoreChangeConnections;
 
   void Export();
   void DrawFrame();
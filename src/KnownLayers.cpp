@@ -0,0 +1,180 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "KnownLayers.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Platform.hpp"
+
+namespace FredEmmott::OpenXRLayers {
+
+using namespace KnownLayersFormat;
+
+namespace {
+/// A span of `T`s within `data`, or nullopt if out of bounds or misaligned
+template <class T>
+std::optional<std::span<const T>> GetArray(
+  const std::span<const std::byte> data,
+  const uint32_t offset,
+  const uint32_t count) {
+  if (offset % alignof(T) != 0 || offset > data.size()) {
+    return std::nullopt;
+  }
+  if ((data.size() - offset) / sizeof(T) < count) {
+    return std::nullopt;
+  }
+  return std::span {
+    reinterpret_cast<const T*>(data.data() + offset),
+    count,
+  };
+}
+}// namespace
+
+KnownLayers::~KnownLayers() = default;
+
+bool KnownLayers::Entry::IsBadVersion(
+  const Version implementationVersion) const noexcept {
+  if (mBadVersions.empty()) {
+    return true;
+  }
+  const auto packed = implementationVersion.GetPacked();
+  return std::ranges::any_of(mBadVersions, [packed](const auto& range) {
+    return packed >= range.mMin && packed <= range.mMax;
+  });
+}
+
+std::shared_ptr<const KnownLayers> KnownLayers::Get() {
+  static const auto sInstance = [] {
+    auto& platform = Platform::Get();
+    for (auto&& directory:
+         {platform.GetUserDataDirectory(), platform.GetExecutableDirectory()}) {
+      if (auto ret = Load(directory / FileName)) {
+        return ret;
+      }
+    }
+    return std::make_shared<const KnownLayers>();
+  }();
+  return sInstance;
+}
+
+std::shared_ptr<const KnownLayers> KnownLayers::Load(
+  const std::filesystem::path& path) {
+  auto file = Platform::Get().MapFile(path);
+  if (!file) {
+    return nullptr;
+  }
+  const auto data = file->GetData();
+
+  Header header;
+  if (data.size() < sizeof(header)) {
+    return nullptr;
+  }
+  std::memcpy(&header, data.data(), sizeof(header));
+  if (header.mMagic != Magic || header.mFormatVersion != FormatVersion) {
+    return nullptr;
+  }
+
+  // Qualified, as `Entry` is `KnownLayers::Entry` in this scope, and
+  // `VersionRange` is ambiguous
+  const auto versionRanges = GetArray<KnownLayersFormat::VersionRange>(
+    data, header.mVersionRangesOffset, header.mVersionRangeCount);
+  const auto entries = GetArray<KnownLayersFormat::Entry>(
+    data, header.mEntriesOffset, header.mEntryCount);
+  const auto displacements = GetArray<uint32_t>(
+    data, header.mDisplacementsOffset, header.mBucketCount);
+  const auto runtimes = GetArray<StringRef>(
+    data, header.mRuntimesOffset, header.mRuntimeCount);
+  const auto strings
+    = GetArray<char>(data, header.mStringsOffset, header.mStringsSize);
+  if (!(versionRanges && entries && displacements && runtimes && strings)) {
+    return nullptr;
+  }
+  if (displacements->empty() && !entries->empty()) {
+    return nullptr;
+  }
+
+  auto ret = std::make_shared<KnownLayers>();
+  ret->mVersionRanges = *versionRanges;
+  ret->mEntries = *entries;
+  ret->mDisplacements = *displacements;
+  ret->mRuntimes = *runtimes;
+  ret->mStrings = {strings->data(), strings->size()};
+
+  // Validate everything up front, so lookups don't need to
+  for (auto&& runtime: ret->mRuntimes) {
+    if (!ret->IsValid(runtime)) {
+      return nullptr;
+    }
+  }
+  for (auto&& entry: ret->mEntries) {
+    if (!(ret->IsValid(entry.mName) && ret->IsValid(entry.mVendor)
+          && ret->IsValid(entry.mAdvisory))) {
+      return nullptr;
+    }
+    if (entry.mAction > Action::MoveToEnd) {
+      return nullptr;
+    }
+    if (
+      entry.mFirstBadVersion > ret->mVersionRanges.size()
+      || ret->mVersionRanges.size() - entry.mFirstBadVersion
+        < entry.mBadVersionCount) {
+      return nullptr;
+    }
+    if (
+      entry.mFirstRequiredRuntime > ret->mRuntimes.size()
+      || ret->mRuntimes.size() - entry.mFirstRequiredRuntime
+        < entry.mRequiredRuntimeCount) {
+      return nullptr;
+    }
+  }
+
+  ret->mPath = path;
+  ret->mFile = std::move(file);
+  return ret;
+}
+
+bool KnownLayers::IsValid(const StringRef& ref) const noexcept {
+  return ref.mOffset <= mStrings.size()
+    && mStrings.size() - ref.mOffset >= ref.mSize;
+}
+
+std::string_view KnownLayers::GetString(const StringRef& ref) const {
+  return mStrings.substr(ref.mOffset, ref.mSize);
+}
+
+std::optional<KnownLayers::Entry> KnownLayers::Find(
+  const std::string_view layerName) const {
+  if (mEntries.empty()) {
+    return std::nullopt;
+  }
+
+  const auto bucketCount = static_cast<uint32_t>(mDisplacements.size());
+  const auto entryCount = static_cast<uint32_t>(mEntries.size());
+  const auto displacement
+    = mDisplacements[GetBucket(layerName, bucketCount)];
+  const auto& entry = mEntries[GetSlot(layerName, displacement, entryCount)];
+  if (GetString(entry.mName) != layerName) {
+    return std::nullopt;
+  }
+
+  Entry ret {
+    .mName = GetString(entry.mName),
+    .mVendor = GetString(entry.mVendor),
+    .mAdvisory = GetString(entry.mAdvisory),
+    .mBadVersions
+    = mVersionRanges.subspan(entry.mFirstBadVersion, entry.mBadVersionCount),
+    .mAction = entry.mAction,
+    .mMustBeLast = (entry.mFlags & Flags::MustBeLast) != 0,
+    .mIncludeDisabled = (entry.mFlags & Flags::IncludeDisabled) != 0,
+    .mArchitectures = static_cast<Architecture>(entry.mArchitectures),
+  };
+  for (auto&& runtime: mRuntimes.subspan(
+         entry.mFirstRequiredRuntime, entry.mRequiredRuntimeCount)) {
+    ret.mRequiredRuntimes.push_back(GetString(runtime));
+  }
+  return ret;
+}
+
+}// namespace FredEmmott::OpenXRLayers
@@ -0,0 +1,86 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "Architectures.hpp"
+#include "KnownLayersFormat.hpp"
+#include "Version.hpp"
+
+namespace FredEmmott::OpenXRLayers {
+class MappedFile;
+
+/** Layers with known problems, from `known-layers.bin`.
+ *
+ * The database is memory-mapped and used in-place; a copy in the user data
+ * directory takes precedence over the one shipped with the program, so the
+ * database can be updated without a new release.
+ */
+class KnownLayers final {
+ public:
+  struct Entry {
+    std::string_view mName;
+    std::string_view mVendor;
+    std::string_view mAdvisory;
+    std::span<const KnownLayersFormat::VersionRange> mBadVersions;
+    std::vector<std::string_view> mRequiredRuntimes;
+    KnownLayersFormat::Action mAction {};
+    bool mMustBeLast {false};
+    bool mIncludeDisabled {false};
+    /// Empty (Architecture::Invalid) for any architecture
+    Architectures mArchitectures {Architecture::Invalid};
+
+    [[nodiscard]]
+    bool IsBadVersion(Version implementationVersion) const noexcept;
+  };
+
+  /// The database; empty if neither copy is valid
+  static std::shared_ptr<const KnownLayers> Get();
+
+  KnownLayers() = default;
+  ~KnownLayers();
+
+  KnownLayers(const KnownLayers&) = delete;
+  KnownLayers(KnownLayers&&) = delete;
+  KnownLayers& operator=(const KnownLayers&) = delete;
+  KnownLayers& operator=(KnownLayers&&) = delete;
+
+  [[nodiscard]]
+  std::optional<Entry> Find(std::string_view layerName) const;
+
+  [[nodiscard]]
+  std::size_t size() const noexcept {
+    return mEntries.size();
+  }
+
+  /// Empty if the database is empty
+  [[nodiscard]]
+  std::filesystem::path GetPath() const noexcept {
+    return mPath;
+  }
+
+ private:
+  std::filesystem::path mPath;
+  std::unique_ptr<MappedFile> mFile;
+
+  std::span<const KnownLayersFormat::VersionRange> mVersionRanges;
+  std::span<const KnownLayersFormat::Entry> mEntries;
+  std::span<const uint32_t> mDisplacements;
+  std::span<const KnownLayersFormat::StringRef> mRuntimes;
+  std::string_view mStrings;
+
+  static std::shared_ptr<const KnownLayers> Load(
+    const std::filesystem::path&);
+  [[nodiscard]]
+  bool IsValid(const KnownLayersFormat::StringRef&) const noexcept;
+  [[nodiscard]]
+  std::string_view GetString(const KnownLayersFormat::StringRef&) const;
+};
+
+}// namespace FredEmmott::OpenXRLayers
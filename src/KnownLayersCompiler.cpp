@@ -0,0 +1,283 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+// Build-time tool to convert `known-layers.json` to the binary format
+// described in `KnownLayersFormat.hpp`
+//
+// Usage: known-layers-compiler INPUT.json OUTPUT.bin
+
+#include <magic_enum/magic_enum.hpp>
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <optional>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Architectures.hpp"
+#include "KnownLayersFormat.hpp"
+#include "Version.hpp"
+
+namespace FredEmmott::OpenXRLayers::KnownLayersFormat {
+namespace {
+
+class CompileError : public std::runtime_error {
+ public:
+  using std::runtime_error::runtime_error;
+};
+
+class StringTable {
+ public:
+  StringRef Add(const std::string& value) {
+    if (const auto it = mRefs.find(value); it != mRefs.end()) {
+      return it->second;
+    }
+    const StringRef ref {
+      static_cast<uint32_t>(mData.size()),
+      static_cast<uint32_t>(value.size()),
+    };
+    mData += value;
+    mRefs.emplace(value, ref);
+    return ref;
+  }
+
+  [[nodiscard]]
+  const std::string& GetData() const noexcept {
+    return mData;
+  }
+
+ private:
+  std::string mData;
+  std::unordered_map<std::string, StringRef> mRefs;
+};
+
+struct Database {
+  std::vector<std::string> mNames;
+  std::vector<Entry> mEntries;
+  std::vector<VersionRange> mVersionRanges;
+  std::vector<StringRef> mRuntimes;
+  StringTable mStrings;
+};
+
+Action ParseAction(const std::string& name, const std::string& action) {
+  if (action == "disable") {
+    return Action::Disable;
+  }
+  if (action == "remove") {
+    return Action::Remove;
+  }
+  if (action == "moveToEnd") {
+    return Action::MoveToEnd;
+  }
+  throw CompileError(std::format("{}: unknown action '{}'", name, action));
+}
+
+void AddLayer(Database& db, const nlohmann::json& json) {
+  const auto name = json.at("name").get<std::string>();
+  if (std::ranges::contains(db.mNames, name)) {
+    throw CompileError(std::format("{}: duplicate entry", name));
+  }
+
+  Entry entry {
+    .mName = db.mStrings.Add(name),
+    .mVendor = db.mStrings.Add(json.value("vendor", std::string {})),
+    .mAdvisory = db.mStrings.Add(json.at("advisory").get<std::string>()),
+    .mAction = ParseAction(name, json.value("action", "disable")),
+  };
+
+  if (json.contains("badVersions")) {
+    const auto expression = json.at("badVersions").get<std::string>();
+    const auto range = OpenXRLayers::VersionRange::Parse(expression);
+    if (!range) {
+      throw CompileError(std::format("{}: {}", name, range.error()));
+    }
+    if (range->GetIntervals().empty()) {
+      throw CompileError(
+        std::format("{}: '{}' does not match any versions", name, expression));
+    }
+    entry.mFirstBadVersion = static_cast<uint32_t>(db.mVersionRanges.size());
+    for (auto&& interval: range->GetIntervals()) {
+      db.mVersionRanges.push_back({
+        .mMin = interval.mMin,
+        .mMax = interval.mMax,
+      });
+      ++entry.mBadVersionCount;
+    }
+  }
+
+  if (json.contains("requiredRuntimes")) {
+    entry.mFirstRequiredRuntime = static_cast<uint32_t>(db.mRuntimes.size());
+    for (auto&& runtime: json.at("requiredRuntimes")) {
+      db.mRuntimes.push_back(db.mStrings.Add(runtime.get<std::string>()));
+      ++entry.mRequiredRuntimeCount;
+    }
+  }
+
+  if (json.value("mustBeLast", false)) {
+    entry.mFlags |= Flags::MustBeLast;
+    if (!json.contains("action")) {
+      entry.mAction = Action::MoveToEnd;
+    }
+  }
+  if (json.value("includeDisabled", false)) {
+    entry.mFlags |= Flags::IncludeDisabled;
+  }
+
+  if (json.contains("architectures")) {
+    Architectures architectures {Architecture::Invalid};
+    for (auto&& it: json.at("architectures")) {
+      const auto arch
+        = magic_enum::enum_cast<Architecture>(it.get<std::string>());
+      if (!arch || *arch == Architecture::Invalid) {
+        throw CompileError(std::format(
+          "{}: unknown architecture '{}'", name, it.get<std::string>()));
+      }
+      architectures |= *arch;
+    }
+    entry.mArchitectures = architectures.underlying();
+  }
+
+  db.mNames.push_back(name);
+  db.mEntries.push_back(entry);
+}
+
+/// Find displacements so that every name has a unique slot
+std::vector<uint32_t> PlaceEntries(Database& db) {
+  const auto entryCount = static_cast<uint32_t>(db.mEntries.size());
+  const auto bucketCount = std::max<uint32_t>(1, (entryCount + 1) / 2);
+
+  std::vector<std::vector<uint32_t>> buckets(bucketCount);
+  for (uint32_t i = 0; i < entryCount; ++i) {
+    buckets.at(GetBucket(db.mNames.at(i), bucketCount)).push_back(i);
+  }
+
+  std::vector<uint32_t> bucketOrder(bucketCount);
+  std::ranges::iota(bucketOrder, 0);
+  // Place the most crowded buckets first, while there is the most space
+  std::ranges::stable_sort(bucketOrder, std::ranges::greater {}, [&](auto i) {
+    return buckets.at(i).size();
+  });
+
+  std::vector<uint32_t> displacements(bucketCount, 0);
+  std::vector<std::optional<uint32_t>> slots(entryCount);
+  for (const auto bucket: bucketOrder) {
+    const auto& members = buckets.at(bucket);
+    if (members.empty()) {
+      break;
+    }
+
+    constexpr uint32_t MaxDisplacement = 1 << 20;
+    for (uint32_t displacement = 1;; ++displacement) {
+      if (displacement == MaxDisplacement) {
+        throw CompileError("unable to find a perfect hash");
+      }
+
+      std::vector<uint32_t> candidate;
+      for (const auto i: members) {
+        const auto slot = GetSlot(db.mNames.at(i), displacement, entryCount);
+        if (slots.at(slot) || std::ranges::contains(candidate, slot)) {
+          break;
+        }
+        candidate.push_back(slot);
+      }
+      if (candidate.size() != members.size()) {
+        continue;
+      }
+
+      for (std::size_t i = 0; i < members.size(); ++i) {
+        slots.at(candidate.at(i)) = members.at(i);
+      }
+      displacements.at(bucket) = displacement;
+      break;
+    }
+  }
+
+  // Reorder the entries into slot order
+  std::vector<Entry> entries;
+  entries.reserve(entryCount);
+  for (auto&& slot: slots) {
+    entries.push_back(db.mEntries.at(slot.value()));
+  }
+  db.mEntries = std::move(entries);
+
+  return displacements;
+}
+
+template <class T>
+uint32_t Append(std::string& out, const T* data, const std::size_t count) {
+  // Align everything to 8 bytes, so that `VersionRange` is aligned
+  out.resize((out.size() + 7) & ~std::size_t {7}, '\0');
+  const auto offset = static_cast<uint32_t>(out.size());
+  if (count) {
+    out.append(reinterpret_cast<const char*>(data), sizeof(T) * count);
+  }
+  return offset;
+}
+
+std::string Compile(const nlohmann::json& json) {
+  Database db;
+  for (auto&& layer: json.at("layers")) {
+    AddLayer(db, layer);
+  }
+  const auto displacements = PlaceEntries(db);
+
+  Header header {
+    .mVersionRangeCount = static_cast<uint32_t>(db.mVersionRanges.size()),
+    .mEntryCount = static_cast<uint32_t>(db.mEntries.size()),
+    .mBucketCount = static_cast<uint32_t>(displacements.size()),
+    .mRuntimeCount = static_cast<uint32_t>(db.mRuntimes.size()),
+    .mStringsSize = static_cast<uint32_t>(db.mStrings.GetData().size()),
+  };
+
+  std::string out(sizeof(Header), '\0');
+  header.mVersionRangesOffset = Append(
+    out, db.mVersionRanges.data(), db.mVersionRanges.size());
+  header.mEntriesOffset = Append(out, db.mEntries.data(), db.mEntries.size());
+  header.mDisplacementsOffset
+    = Append(out, displacements.data(), displacements.size());
+  header.mRuntimesOffset
+    = Append(out, db.mRuntimes.data(), db.mRuntimes.size());
+  header.mStringsOffset = Append(
+    out, db.mStrings.GetData().data(), db.mStrings.GetData().size());
+
+  std::memcpy(out.data(), &header, sizeof(header));
+  return out;
+}
+
+}// namespace
+}// namespace FredEmmott::OpenXRLayers::KnownLayersFormat
+
+int main(int argc, char** argv) {
+  using namespace FredEmmott::OpenXRLayers::KnownLayersFormat;
+  if (argc != 3) {
+    std::cerr << "Usage: known-layers-compiler INPUT.json OUTPUT.bin"
+              << std::endl;
+    return 1;
+  }
+
+  try {
+    std::ifstream in(std::filesystem::path {argv[1]});
+    const auto json = nlohmann::json::parse(in);
+    const auto data = Compile(json);
+
+    std::ofstream out(std::filesystem::path {argv[2]}, std::ios::binary);
+    out.write(data.data(), static_cast<std::streamsize>(data.size()));
+    if (!out) {
+      std::cerr << "Failed to write " << argv[2] << std::endl;
+      return 1;
+    }
+  } catch (const std::exception& e) {
+    std::cerr << argv[1] << ": " << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
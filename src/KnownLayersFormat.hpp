@@ -0,0 +1,136 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+/** The binary known-layers database, as produced by `known-layers-compiler`.
+ *
+ * The file is memory-mapped and used in-place, so everything is
+ * little-endian, naturally aligned, and referenced by offset from the start
+ * of the file:
+ *
+ * - `Header`
+ * - `VersionRange[mVersionRangeCount]`
+ * - `Entry[mEntryCount]`, in perfect-hash slot order
+ * - `uint32_t[mBucketCount]` displacements
+ * - `StringRef[mRuntimeCount]` runtime names
+ * - `char[mStringsSize]` string table; strings are not null-terminated
+ *
+ * Entries are found with 'hash and displace': `GetBucket()` gives the index
+ * of the displacement for a name, and `GetSlot()` combines that displacement
+ * with the name to find the entry; as the hash is only perfect for the names
+ * in the database, the entry's name must still be compared.
+ */
+namespace FredEmmott::OpenXRLayers::KnownLayersFormat {
+
+static_assert(
+  std::endian::native == std::endian::little,
+  "The known layers database is little-endian");
+
+constexpr std::array Magic {'X', 'R', 'K', 'L'};
+// Increment when the format changes incompatibly
+constexpr uint32_t FormatVersion = 2;
+
+constexpr auto FileName = "known-layers.bin";
+
+struct StringRef {
+  uint32_t mOffset {};
+  uint32_t mSize {};
+};
+
+/// Inclusive range of packed `implementation_version`s; see `Version`
+struct VersionRange {
+  uint64_t mMin {};
+  uint64_t mMax {};
+};
+
+enum class Action : uint8_t {
+  /// Disable the layer
+  Disable,
+  /// Remove the layer
+  Remove,
+  /// Move the layer to the end of the list
+  MoveToEnd,
+};
+
+namespace Flags {
+/// Only report if the layer is not the last enabled layer
+constexpr uint8_t MustBeLast = 1 << 0;
+/// Report even if the layer is disabled
+constexpr uint8_t IncludeDisabled = 1 << 1;
+}// namespace Flags
+
+struct Entry {
+  StringRef mName;
+  StringRef mVendor;
+  /// `fmt` format string; see `KnownLayersLinter` for the arguments
+  StringRef mAdvisory;
+  /// Only report these versions; if empty, report all versions
+  uint32_t mFirstBadVersion {};
+  uint32_t mBadVersionCount {};
+  /// Only report if the active runtime is not one of these
+  uint32_t mFirstRequiredRuntime {};
+  uint32_t mRequiredRuntimeCount {};
+  Action mAction {};
+  uint8_t mFlags {};
+  /// `Architecture` bits; 0 for any architecture
+  uint8_t mArchitectures {};
+  uint8_t mReserved {};
+};
+
+struct Header {
+  std::array<char, 4> mMagic {Magic};
+  uint32_t mFormatVersion {FormatVersion};
+
+  uint32_t mVersionRangesOffset {};
+  uint32_t mVersionRangeCount {};
+  uint32_t mEntriesOffset {};
+  uint32_t mEntryCount {};
+  uint32_t mDisplacementsOffset {};
+  uint32_t mBucketCount {};
+  uint32_t mRuntimesOffset {};
+  uint32_t mRuntimeCount {};
+  uint32_t mStringsOffset {};
+  uint32_t mStringsSize {};
+};
+
+static_assert(std::is_trivially_copyable_v<Header>);
+static_assert(std::is_trivially_copyable_v<Entry>);
+static_assert(std::is_trivially_copyable_v<VersionRange>);
+static_assert(std::is_trivially_copyable_v<StringRef>);
+
+/// Seeded FNV-1a
+constexpr uint64_t Hash(const std::string_view value, const uint32_t seed) {
+  uint64_t ret = 0xcbf29ce484222325;
+  const auto mix = [&ret](const uint8_t byte) {
+    ret ^= byte;
+    ret *= 0x100000001b3;
+  };
+  for (auto i = 0; i < 4; ++i) {
+    mix(static_cast<uint8_t>(seed >> (i * 8)));
+  }
+  for (const auto c: value) {
+    mix(static_cast<uint8_t>(c));
+  }
+  return ret;
+}
+
+constexpr uint32_t GetBucket(
+  const std::string_view name,
+  const uint32_t bucketCount) {
+  return static_cast<uint32_t>(Hash(name, 0) % bucketCount);
+}
+
+constexpr uint32_t GetSlot(
+  const std::string_view name,
+  const uint32_t displacement,
+  const uint32_t entryCount) {
+  return static_cast<uint32_t>(Hash(name, displacement) % entryCount);
+}
+
+}// namespace FredEmmott::OpenXRLayers::KnownLayersFormat
@@ -0,0 +1,326 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "LayerRelations.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <format>
+#include <limits>
+#include <ranges>
+#include <unordered_set>
+
+namespace FredEmmott::OpenXRLayers {
+
+BitMatrix::BitMatrix(const std::size_t size)
+  : mSize(size),
+    mWordsPerRow((size + BitsPerWord - 1) / BitsPerWord),
+    mWords(mWordsPerRow * size, 0) {}
+
+bool BitMatrix::test(const std::size_t row, const std::size_t column)
+  const noexcept {
+  assert(row < mSize && column < mSize);
+  const auto word = mWords[(row * mWordsPerRow) + (column / BitsPerWord)];
+  return (word >> (column % BitsPerWord)) & 1;
+}
+
+void BitMatrix::set(const std::size_t row, const std::size_t column) noexcept {
+  assert(row < mSize && column < mSize);
+  mWords[(row * mWordsPerRow) + (column / BitsPerWord)]
+    |= uint64_t {1} << (column % BitsPerWord);
+}
+
+bool BitMatrix::any(const std::size_t row) const noexcept {
+  const auto begin = mWords.begin() + (row * mWordsPerRow);
+  return std::any_of(
+    begin, begin + mWordsPerRow, [](const auto word) { return word != 0; });
+}
+
+std::generator<std::size_t> BitMatrix::columns(const std::size_t row) const {
+  for (std::size_t i = 0; i < mWordsPerRow; ++i) {
+    auto word = mWords[(row * mWordsPerRow) + i];
+    while (word) {
+      co_yield (i * BitsPerWord) + std::countr_zero(word);
+      // Clear the lowest set bit
+      word &= word - 1;
+    }
+  }
+}
+
+using LayerExtensions = std::unordered_map<
+  LayerID,
+  std::unordered_set<ExtensionID, Facet::Hash>,
+  Facet::Hash>;
+
+static FacetMap ExpandFacets(
+  const FacetMap& facets,
+  const LayerExtensions& layers,
+  const LayerRuleSet& rules) {
+  FacetMap next;
+  for (auto&& [facet, trace]: facets) {
+    switch (facet.GetKind()) {
+      case Facet::Kind::Layer:
+        next.emplace(facet, trace);
+        break;
+      case Facet::Kind::Extension:
+        for (auto&& [layer, extensions]: layers) {
+          if (extensions.contains(ExtensionID {facet})) {
+            auto nextTrace = trace;
+            nextTrace.push_front({layer, facet});
+            next.emplace(layer, nextTrace);
+          }
+        }
+        break;
+      case Facet::Kind::Explicit:
+        for (auto&& rule: rules.GetProviders(facet)) {
+          auto nextTrace = trace;
+          nextTrace.push_front({rule->mID, facet});
+          next.emplace(rule->mID, nextTrace);
+        }
+        break;
+    }
+  }
+
+  if (next == facets) {
+    for (const auto& it: facets | std::views::keys) {
+      assert(it.GetKind() == Facet::Kind::Layer);
+    }
+    return next;
+  }
+
+  return ExpandFacets(next, layers, rules);
+}
+
+static FacetMap ExpandFacets(
+  const LayerRules& rule,
+  auto proj,
+  const LayerExtensions& layers,
+  const LayerRuleSet& rules) {
+  FacetMap toExpand = std::invoke(proj, rule);
+
+  for (auto&& mixin: rule.mFacets | std::views::keys) {
+    const auto mixinRule = rules.Find(mixin);
+    if (!mixinRule) {
+      continue;
+    }
+    const FacetMap& mixinValues = std::invoke(proj, *mixinRule);
+    if (mixinValues.empty()) {
+      continue;
+    }
+
+    for (auto& value: mixinValues | std::views::keys) {
+      toExpand.emplace(
+        value,
+        FacetTrace {
+          {rule.mID, mixin},
+        });
+    }
+  }
+
+  return ExpandFacets(toExpand, layers, rules);
+}
+
+/** Replace Extension and Explicit facets with the Layers.
+ *
+ * The original Facets are retained in the trace.
+ */
+static std::vector<LayerRules> ExpandRules(
+  const LayerRuleSet& rules,
+  const LayerTable& layers) {
+  LayerExtensions layerExtensions;
+  for (auto&& [_, details]: layers) {
+    layerExtensions.emplace(
+      LayerID {details.mName},
+      details.mExtensions | std::views::transform([](auto& ext) {
+        return ExtensionID {ext.mName};
+      }) | std::ranges::to<std::unordered_set<ExtensionID, Facet::Hash>>());
+  }
+
+  auto ret = rules.GetRules() | std::views::filter([](auto& it) {
+               return it.mID.GetKind() == Facet::Kind::Layer;
+             })
+    | std::ranges::to<std::vector>();
+  auto expandFacets = [&](LayerRules& it, auto proj) {
+    FacetMap& facets = std::invoke(proj, it);
+    facets = ExpandFacets(it, proj, layerExtensions, rules);
+  };
+  for (auto& it: ret) {
+    expandFacets(it, &LayerRules::mAbove);
+    expandFacets(it, &LayerRules::mBelow);
+    expandFacets(it, &LayerRules::mConflicts);
+    expandFacets(it, &LayerRules::mConflictsPerApp);
+  }
+  return ret;
+}
+
+std::string ExplainTrace(const FacetTrace& trace) {
+  if (trace.empty()) {
+    return {};
+  }
+
+  if (trace.size() == 1) {
+    return std::format("because it {}", trace.front().mWhy.GetDescription());
+  } else {
+    std::string traceStr;
+    const auto reverseTrace = trace | std::views::reverse;
+    for (auto it = reverseTrace.begin(); it != reverseTrace.end(); ++it) {
+      if (it != reverseTrace.begin()) {
+        traceStr
+          += (std::ranges::next(it) == reverseTrace.end()) ? ", and " : ", ";
+      }
+
+      const auto& [what, why] = *it;
+      traceStr
+        += std::format("{} {}", what.GetDescription(), why.GetDescription());
+    }
+    return std::format("because {}", traceStr);
+  }
+}
+
+// Marks keys that are in the layer list more than once
+static constexpr auto AmbiguousRow = std::numeric_limits<std::size_t>::max();
+
+static uint64_t MakeTraceKey(const std::size_t row, const std::size_t column) {
+  return (static_cast<uint64_t>(row) << 32) | column;
+}
+
+LayerRelations::LayerRelations(
+  const LayerRuleSet& rules,
+  const Layers& layers)
+  : mSize(layers.size()) {
+  for (auto& matrix: mMatrices) {
+    matrix = BitMatrix {mSize};
+  }
+
+  std::unordered_map<Facet, std::vector<std::size_t>, Facet::Hash> indices;
+  const auto keys = layers.GetPathIDs();
+  for (std::size_t i = 0; i < layers.size(); ++i) {
+    indices[LayerID {std::get<1>(layers.at(i)).mName}].push_back(i);
+    const auto [it, inserted] = mRows.try_emplace(keys[i], i);
+    if (!inserted) {
+      it->second = AmbiguousRow;
+    }
+  }
+
+  const auto expanded = ExpandRules(rules, layers);
+  std::unordered_map<Facet, const LayerRules*, Facet::Hash> rulesByID;
+  for (auto&& rule: expanded) {
+    rulesByID.emplace(rule.mID, &rule);
+  }
+
+  for (std::size_t row = 0; row < layers.size(); ++row) {
+    const auto& details = std::get<1>(layers.at(row));
+    const auto ruleIt = rulesByID.find(LayerID {details.mName});
+    if (ruleIt == rulesByID.end()) {
+      continue;
+    }
+    const auto& rule = *ruleIt->second;
+
+    const auto set = [&](const LayerRelation relation, const FacetMap& facets) {
+      const auto i = std::to_underlying(relation);
+      for (auto&& [facet, trace]: facets) {
+        const auto it = indices.find(facet);
+        if (it == indices.end()) {
+          continue;
+        }
+        for (const auto column: it->second) {
+          if (column == row) {
+            continue;
+          }
+          mMatrices[i].set(row, column);
+          if (!trace.empty()) {
+            mTraces[i].emplace(MakeTraceKey(row, column), trace);
+          }
+        }
+      }
+    };
+    set(LayerRelation::Above, rule.mAbove);
+    set(LayerRelation::Below, rule.mBelow);
+    set(LayerRelation::Conflicts, rule.mConflicts);
+    set(LayerRelation::ConflictsPerApp, rule.mConflictsPerApp);
+  }
+}
+
+std::optional<std::size_t> LayerRelations::Find(
+  const APILayer::Key key) const {
+  const auto it = mRows.find(key);
+  if (it == mRows.end() || it->second == AmbiguousRow) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+bool LayerRelations::HasAnyRelation(const std::size_t index) const noexcept {
+  return std::ranges::any_of(mMatrices, [index](const auto& matrix) {
+    if (matrix.any(index)) {
+      return true;
+    }
+    for (std::size_t row = 0; row < matrix.size(); ++row) {
+      if (matrix.test(row, index)) {
+        return true;
+      }
+    }
+    return false;
+  });
+}
+
+const FacetTrace& LayerRelations::GetTrace(
+  const LayerRelation relation,
+  const std::size_t row,
+  const std::size_t column) const {
+  static const FacetTrace sEmpty;
+  const auto& traces = mTraces.at(std::to_underlying(relation));
+  const auto it = traces.find(MakeTraceKey(row, column));
+  if (it == traces.end()) {
+    return sEmpty;
+  }
+  return it->second;
+}
+
+std::vector<std::string> DescribeRelations(
+  const LayerRelations& relations,
+  const LayerRelations::Layers& layers) {
+  assert(relations.size() == layers.size());
+  const auto name = [&layers](const std::size_t index) -> std::string_view {
+    return std::get<1>(layers.at(index)).mName;
+  };
+  const auto because = [](const FacetTrace& trace) -> std::string {
+    if (trace.empty()) {
+      return ".";
+    }
+    return std::format(" {}.", ExplainTrace(trace));
+  };
+
+  std::vector<std::string> ret;
+  using enum LayerRelation;
+  for (std::size_t row = 0; row < relations.size(); ++row) {
+    for (const auto column: relations.Get(Above).columns(row)) {
+      ret.push_back(std::format(
+        "{} must be above {}{}",
+        name(row),
+        name(column),
+        because(relations.GetTrace(Above, row, column))));
+    }
+    for (const auto column: relations.Get(Below).columns(row)) {
+      ret.push_back(std::format(
+        "{} must be below {}{}",
+        name(row),
+        name(column),
+        because(relations.GetTrace(Below, row, column))));
+    }
+    for (const auto column: relations.Get(Conflicts).columns(row)) {
+      ret.push_back(
+        std::format("{} and {} are incompatible.", name(row), name(column)));
+    }
+    for (const auto column: relations.Get(ConflictsPerApp).columns(row)) {
+      ret.push_back(std::format(
+        "{} and {} are incompatible if used in the same game.",
+        name(row),
+        name(column)));
+    }
+  }
+  return ret;
+}
+
+}// namespace FredEmmott::OpenXRLayers
@@ -0,0 +1,130 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <magic_enum/magic_enum.hpp>
+
+#include <array>
+#include <cstdint>
+#include <generator>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "APILayer.hpp"
+#include "LayerRules.hpp"
+#include "LayerTable.hpp"
+
+namespace FredEmmott::OpenXRLayers {
+
+/// A square matrix of bits, indexed by `[row][column]`
+class BitMatrix {
+ public:
+  BitMatrix() = default;
+  explicit BitMatrix(std::size_t size);
+
+  [[nodiscard]]
+  std::size_t size() const noexcept {
+    return mSize;
+  }
+
+  [[nodiscard]]
+  bool test(std::size_t row, std::size_t column) const noexcept;
+  void set(std::size_t row, std::size_t column) noexcept;
+
+  [[nodiscard]]
+  bool any(std::size_t row) const noexcept;
+
+  /// The indices of the set columns in the specified row
+  std::generator<std::size_t> columns(std::size_t row) const;
+
+ private:
+  static constexpr std::size_t BitsPerWord = 64;
+
+  std::size_t mSize {};
+  std::size_t mWordsPerRow {};
+  std::vector<uint64_t> mWords;
+};
+
+enum class LayerRelation : uint8_t {
+  /// The row layer must be above the column layer
+  Above,
+  /// The row layer must be below the column layer
+  Below,
+  /// The row layer can not be used with the column layer
+  Conflicts,
+  /// The row layer can not be used in the same game as the column layer
+  ConflictsPerApp,
+};
+
+/** The rules from `GetLayerRules()`, applied to a specific list of layers.
+ *
+ * Extension and explicit facets are expanded to the layers that provide them,
+ * and the result is stored as one `BitMatrix` per `LayerRelation`; rows and
+ * columns are indices into the list of layers passed to the constructor.
+ *
+ * Relations are as the rules state them, so if layer A must be above layer B,
+ * that may be stored as either `Above[A][B]` or `Below[B][A]`.
+ *
+ * Each relation only depends on the two layers involved, so relations for a
+ * list of layers also apply to any subset or reordering of it; use `Find()`
+ * to get the rows.
+ */
+class LayerRelations {
+ public:
+  using Layers = LayerTable;
+
+  LayerRelations() = delete;
+  LayerRelations(const LayerRuleSet& rules, const Layers& layers);
+
+  [[nodiscard]]
+  std::size_t size() const noexcept {
+    return mSize;
+  }
+
+  [[nodiscard]]
+  const BitMatrix& Get(const LayerRelation relation) const noexcept {
+    return mMatrices.at(std::to_underlying(relation));
+  }
+
+  [[nodiscard]]
+  bool Test(
+    const LayerRelation relation,
+    const std::size_t row,
+    const std::size_t column) const noexcept {
+    return Get(relation).test(row, column);
+  }
+
+  /// The row for the layer with this key, unless it is absent or ambiguous
+  [[nodiscard]]
+  std::optional<std::size_t> Find(APILayer::Key) const;
+
+  /// Whether the layer is in any relation with any other layer
+  [[nodiscard]]
+  bool HasAnyRelation(std::size_t index) const noexcept;
+
+  /// Why the relation exists; empty if the rule names the layer directly
+  [[nodiscard]]
+  const FacetTrace&
+  GetTrace(LayerRelation, std::size_t row, std::size_t column) const;
+
+ private:
+  static constexpr auto RelationCount = magic_enum::enum_count<LayerRelation>();
+
+  std::size_t mSize {};
+  std::unordered_map<APILayer::Key, std::size_t> mRows;
+  std::array<BitMatrix, RelationCount> mMatrices;
+  std::array<std::unordered_map<uint64_t, FacetTrace>, RelationCount> mTraces;
+};
+
+/// e.g. "because it provides XR_EXT_hand_tracking"
+std::string ExplainTrace(const FacetTrace& trace);
+
+/// One human-readable sentence per relation, e.g. for reports
+std::vector<std::string> DescribeRelations(
+  const LayerRelations&,
+  const LayerRelations::Layers&);
+
+}// namespace FredEmmott::OpenXRLayers
@@ -3,10 +3,141 @@
 
 #include "LayerRules.hpp"
 
+#include <array>
+#include <deque>
+#include <format>
+#include <mutex>
+#include <optional>
+#include <ranges>
+#include <shared_mutex>
+#include <stdexcept>
+#include <utility>
+
+#include "UserLayerRules.hpp"
+
 namespace FredEmmott::OpenXRLayers {
 
+namespace {
+class FacetTable final {
+ public:
+  static FacetTable& Get() {
+    static FacetTable sInstance;
+    return sInstance;
+  }
+
+  uint32_t Intern(
+    const Facet::Kind kind,
+    const std::string_view id,
+    const std::string_view description,
+    const bool isFormat) {
+    {
+      const std::shared_lock lock(mMutex);
+      if (const auto index = Find(kind, id, description, isFormat)) {
+        return *index;
+      }
+    }
+
+    const std::unique_lock lock(mMutex);
+    if (const auto index = Find(kind, id, description, isFormat)) {
+      return *index;
+    }
+
+    auto& ids = mIndices[std::to_underlying(kind)];
+    if (const auto it = ids.find(id); it != ids.end()) {
+      // Explicit facet with a new description
+      auto& entry = mEntries.at(it->second);
+      entry.mDescription = std::string {description};
+      return it->second;
+    }
+
+    if (mEntries.size() == MaxEntries) [[unlikely]] {
+      throw std::length_error("Too many facets");
+    }
+    const auto index = static_cast<uint32_t>(mEntries.size());
+    // std::deque never moves existing elements, so the string_view keys stay
+    // valid
+    auto& entry = mEntries.emplace_back(
+      std::string {id},
+      isFormat ? std::string {} : std::string {description},
+      isFormat ? description : std::string_view {});
+    ids.emplace(entry.mID, index);
+    return index;
+  }
+
+  std::string_view GetID(const uint32_t index) {
+    const std::shared_lock lock(mMutex);
+    return mEntries.at(index).mID;
+  }
+
+  std::string GetDescription(const uint32_t index) {
+    const std::shared_lock lock(mMutex);
+    const auto& entry = mEntries.at(index);
+    if (entry.mDescriptionFormat.empty()) {
+      return entry.mDescription;
+    }
+    return std::vformat(
+      entry.mDescriptionFormat, std::make_format_args(entry.mID));
+  }
+
+ private:
+  static constexpr std::size_t MaxEntries = 1 << 24;
+
+  struct Entry {
+    std::string mID;
+    std::string mDescription;
+    // Static storage duration; if set, `mDescription` is unused
+    std::string_view mDescriptionFormat;
+  };
+
+  std::shared_mutex mMutex;
+  std::deque<Entry> mEntries;
+  // One per Facet::Kind
+  std::array<std::unordered_map<std::string_view, uint32_t>, 3> mIndices;
+
+  // Requires at least a shared lock
+  std::optional<uint32_t> Find(
+    const Facet::Kind kind,
+    const std::string_view id,
+    const std::string_view description,
+    const bool isFormat) const {
+    const auto& ids = mIndices[std::to_underlying(kind)];
+    const auto it = ids.find(id);
+    if (it == ids.end()) {
+      return std::nullopt;
+    }
+    if (isFormat || mEntries.at(it->second).mDescription == description) {
+      return it->second;
+    }
+    return std::nullopt;
+  }
+};
+}// namespace
+
+Facet::Facet(const std::string_view id, const std::string_view description)
+  : mHandle(
+      (std::to_underlying(Kind::Explicit) << IndexBits)
+      | FacetTable::Get().Intern(
+        Kind::Explicit, id, description, /* isFormat = */ false)) {}
+
+Facet::Facet(
+  const Kind kind,
+  const std::string_view id,
+  const std::string_view descriptionFormat)
+  : mHandle(
+      (std::to_underlying(kind) << IndexBits)
+      | FacetTable::Get().Intern(
+        kind, id, descriptionFormat, /* isFormat = */ true)) {}
+
+std::string_view Facet::GetID() const {
+  return FacetTable::Get().GetID(mHandle & ((1 << IndexBits) - 1));
+}
+
+std::string Facet::GetDescription() const {
+  return FacetTable::Get().GetDescription(mHandle & ((1 << IndexBits) - 1));
+}
+
 inline namespace LayerIDs {
-#define DEFINE_LAYER_ID(x) static constexpr LayerID x {#x};
+#define DEFINE_LAYER_ID(x) static const LayerID x {#x};
 DEFINE_LAYER_ID(XR_APILAYER_FREDEMMOTT_HandTrackedCockpitClicking)
 DEFINE_LAYER_ID(XR_APILAYER_FREDEMMOTT_OpenKneeboard)
 DEFINE_LAYER_ID(XR_APILAYER_MBUCCHIA_quad_views_foveated)
@@ -21,7 +152,7 @@ DEFINE_LAYER_ID(XR_APILAYER_app_racelab_Overlay)
 }// namespace LayerIDs
 
 inline namespace ExtensionIDs {
-#define DEFINE_EXTENSION_ID(x) static constexpr ExtensionID x {#x};
+#define DEFINE_EXTENSION_ID(x) static const ExtensionID x {#x};
 DEFINE_EXTENSION_ID(XR_EXT_eye_gaze_interaction)
 DEFINE_EXTENSION_ID(XR_EXT_hand_tracking)
 DEFINE_EXTENSION_ID(XR_VARJO_foveated_rendering)
@@ -30,7 +161,7 @@ DEFINE_EXTENSION_ID(XR_VARJO_foveated_rendering)
 
 namespace Facets {
 #define DEFINE_FACET(name, description) \
-  static constexpr Facet name {"#" #name, description};
+  static const Facet name {"#" #name, description};
 DEFINE_FACET(CompositionLayers, "provides an overlay")
 DEFINE_FACET(TransformsPoses, "modifies poses")
 DEFINE_FACET(UsesGameWorldPoses, "uses poses")
@@ -55,7 +186,7 @@ struct Literals {
 };
 }// namespace
 
-std::vector<LayerRules> GetLayerRules() {
+std::vector<LayerRules> GetBuiltinLayerRules() {
   return {
     {
       .mID = Facets::TransformsPoses,
@@ -144,4 +275,35 @@ std::vector<LayerRules> GetLayerRules() {
   };
 }
 
-}// namespace FredEmmott::OpenXRLayers
\ No newline at end of file
+LayerRuleSet::LayerRuleSet(std::vector<LayerRules> rules)
+  : mRules(std::move(rules)) {
+  for (auto&& rule: mRules) {
+    mByID.emplace(rule.mID, &rule);
+    for (auto&& facet: rule.mFacets | std::views::keys) {
+      mProviders[facet].push_back(&rule);
+    }
+  }
+}
+
+const LayerRules* LayerRuleSet::Find(const Facet& id) const noexcept {
+  const auto it = mByID.find(id);
+  if (it == mByID.end()) {
+    return nullptr;
+  }
+  return it->second;
+}
+
+std::span<const LayerRules* const> LayerRuleSet::GetProviders(
+  const Facet& facet) const noexcept {
+  const auto it = mProviders.find(facet);
+  if (it == mProviders.end()) {
+    return {};
+  }
+  return it->second;
+}
+
+std::shared_ptr<const LayerRuleSet> GetLayerRules() {
+  return UserLayerRules::Get().GetRuleSet();
+}
+
+}// namespace FredEmmott::OpenXRLayers
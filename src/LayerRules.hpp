@@ -3,94 +3,98 @@
 #pragma once
 
 #include <cassert>
+#include <cstdint>
 #include <deque>
-#include <format>
+#include <memory>
+#include <span>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <vector>
 
-#include "ConstexprString.hpp"
 #include "StringTemplateParameter.hpp"
 
 namespace FredEmmott::OpenXRLayers {
 
+/** A layer, extension, or explicit facet, interned into a global table.
+ *
+ * A facet is a 32-bit handle: the kind in the top 8 bits, and an index into
+ * the table in the low 24 bits. Copying, comparing, and hashing facets are
+ * integer operations; the ID and description are only looked up when they are
+ * displayed.
+ */
 class Facet {
  public:
-  enum class Kind {
+  enum class Kind : uint8_t {
     Explicit,
     Layer,
     Extension,
   };
 
   Facet() = delete;
-  constexpr Facet(
-    const std::string_view& id,
-    const std::string_view& description)
-    : Facet(Kind::Explicit, id, description) {}
-
-  constexpr Facet(
-    const Kind kind,
-    const std::string_view& id,
-    const std::string_view& description)
-    : mKind(kind),
-      mID(id),
-      mDescription(description) {}
-
-  [[nodiscard]] constexpr auto GetKind() const noexcept {
-    return mKind;
-  }
+  /// An explicit facet; if the ID is already interned, the description is
+  /// replaced
+  Facet(std::string_view id, std::string_view description);
 
-  [[nodiscard]] constexpr auto GetID() const noexcept {
-    return mID.Get();
-  }
+  /** A facet with a description generated from its ID.
+   *
+   * The description is `std::format(descriptionFormat, id)`, formatted when it
+   * is needed; `descriptionFormat` must have static storage duration, e.g. a
+   * string literal.
+   */
+  Facet(Kind kind, std::string_view id, std::string_view descriptionFormat);
 
-  [[nodiscard]] constexpr std::string_view GetDescription() const noexcept {
-    return mDescription.Get();
+  [[nodiscard]] constexpr Kind GetKind() const noexcept {
+    return static_cast<Kind>(mHandle >> IndexBits);
   }
 
+  [[nodiscard]] std::string_view GetID() const;
+  [[nodiscard]] std::string GetDescription() const;
+
   [[nodiscard]] constexpr bool operator==(const Facet&) const noexcept
     = default;
 
   struct Hash {
     static auto operator()(const Facet& facet) noexcept {
-      return std::hash<std::string_view> {}(facet.GetID());
+      return std::hash<uint32_t> {}(facet.mHandle);
     }
   };
 
  private:
-  Kind mKind;
-  ConstexprString mID;
-  ConstexprString mDescription;
+  static constexpr uint32_t IndexBits = 24;
+
+  uint32_t mHandle {};
 };
 
 template <Facet::Kind TKind, auto TDescriptionFormat = "{}"_tp>
 class BasicFacetID {
  public:
   BasicFacetID() = delete;
-  explicit constexpr BasicFacetID(const std::string_view id) : mID(id) {}
+  explicit BasicFacetID(const std::string_view id)
+    : mFacet(TKind, id, TDescriptionFormat.value) {}
 
-  explicit constexpr BasicFacetID(const Facet& facet) : mID(facet.GetID()) {
+  explicit constexpr BasicFacetID(const Facet& facet) : mFacet(facet) {
     assert(facet.GetKind() == TKind);
   }
 
-  [[nodiscard]] constexpr auto GetID() const noexcept {
-    return mID.Get();
+  [[nodiscard]] auto GetID() const {
+    return mFacet.GetID();
   }
 
   // ReSharper disable once CppNonExplicitConversionOperator
   constexpr operator Facet() const noexcept {// NOLINT(*-explicit-constructor)
-    return Facet {
-      TKind, mID.Get(), std::format(TDescriptionFormat.value, mID.Get())};
+    return mFacet;
   }
 
   [[nodiscard]] constexpr bool operator==(const BasicFacetID&) const noexcept
     = default;
 
   [[nodiscard]] constexpr bool operator==(const Facet& facet) const noexcept {
-    return facet.GetKind() == TKind && facet.GetID() == mID.Get();
+    return facet == mFacet;
   }
 
  private:
-  ConstexprString mID;
+  Facet mFacet;
 };
 
 using LayerID = BasicFacetID<Facet::Kind::Layer>;
@@ -138,6 +142,46 @@ struct LayerRules {
   FacetMap mConflictsPerApp;
 };
 
-std::vector<LayerRules> GetLayerRules();
+/** A set of rules, indexed for lookups by ID or provided facet.
+ *
+ * Rules are immutable once added to the set, so this can be shared between
+ * threads.
+ */
+class LayerRuleSet final {
+ public:
+  LayerRuleSet() = default;
+  explicit LayerRuleSet(std::vector<LayerRules> rules);
+
+  LayerRuleSet(const LayerRuleSet&) = delete;
+  LayerRuleSet(LayerRuleSet&&) = delete;
+  LayerRuleSet& operator=(const LayerRuleSet&) = delete;
+  LayerRuleSet& operator=(LayerRuleSet&&) = delete;
+
+  [[nodiscard]]
+  const std::vector<LayerRules>& GetRules() const noexcept {
+    return mRules;
+  }
+
+  /// The rule with the specified ID, or nullptr
+  [[nodiscard]]
+  const LayerRules* Find(const Facet& id) const noexcept;
+
+  /// The rules that list `facet` in their `mFacets`
+  [[nodiscard]]
+  std::span<const LayerRules* const> GetProviders(
+    const Facet& facet) const noexcept;
+
+ private:
+  std::vector<LayerRules> mRules;
+  std::unordered_map<Facet, const LayerRules*, Facet::Hash> mByID;
+  std::unordered_map<Facet, std::vector<const LayerRules*>, Facet::Hash>
+    mProviders;
+};
+
+/// The rules that are built in to this program
+std::vector<LayerRules> GetBuiltinLayerRules();
+
+/// The built-in rules, combined with the user's rules file (if any)
+std::shared_ptr<const LayerRuleSet> GetLayerRules();
 
 }// namespace FredEmmott::OpenXRLayers
\ No newline at end of file
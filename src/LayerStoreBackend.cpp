@@ -0,0 +1,197 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "LayerStoreBackend.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <string>
+
+namespace FredEmmott::OpenXRLayers {
+
+std::vector<LayerStoreBackend::Entry> ToLayerStoreEntries(
+  const std::vector<APILayer>& layers) {
+  std::vector<LayerStoreBackend::Entry> ret;
+  ret.reserve(layers.size());
+  for (auto&& layer: layers) {
+    auto& entry = ret.emplace_back(layer.GetManifestPath());
+    if (layer.mValue != APILayer::Value::Win32_NotDWORD) {
+      entry.mDisabled = layer.IsEnabled() ? 0u : 1u;
+    }
+  }
+  return ret;
+}
+
+std::vector<APILayer> ToAPILayers(
+  const APILayerStore* const source,
+  const std::span<const LayerStoreBackend::Entry> entries) {
+  using Value = APILayer::Value;
+  std::vector<APILayer> ret;
+  ret.reserve(entries.size());
+  for (auto&& entry: entries) {
+    if (!entry.mDisabled) {
+      ret.emplace_back(source, entry.mManifestPath, Value::Win32_NotDWORD);
+      continue;
+    }
+    ret.emplace_back(
+      source,
+      entry.mManifestPath,
+      *entry.mDisabled ? Value::Disabled : Value::Enabled);
+  }
+  return ret;
+}
+
+std::vector<LayerStoreEdit> DiffLayerStore(
+  const std::span<const LayerStoreBackend::Entry> before,
+  const std::span<const LayerStoreBackend::Entry> after) {
+  // Greedily matching the earliest occurrence gives the longest prefix
+  std::vector<bool> keep(before.size(), false);
+  std::size_t keepCount = 0;
+  for (std::size_t i = 0; i < before.size() && keepCount < after.size(); ++i) {
+    if (before[i].mManifestPath == after[keepCount].mManifestPath) {
+      keep[i] = true;
+      ++keepCount;
+    }
+  }
+
+  using enum LayerStoreEdit::Kind;
+  std::vector<LayerStoreEdit> ret;
+  for (std::size_t i = 0; i < before.size(); ++i) {
+    if (!keep[i]) {
+      ret.push_back({Delete, before[i].mManifestPath});
+    }
+  }
+
+  for (std::size_t i = 0, j = 0; i < before.size(); ++i) {
+    if (!keep[i]) {
+      continue;
+    }
+    const auto& target = after[j++];
+    if (before[i].mDisabled != target.mDisabled) {
+      ret.push_back({Set, target.mManifestPath, target.mDisabled.value_or(1)});
+    }
+  }
+
+  for (auto&& target: after.subspan(keepCount)) {
+    ret.push_back({Set, target.mManifestPath, target.mDisabled.value_or(1)});
+  }
+  return ret;
+}
+
+bool ApplyLayerStoreEdits(
+  LayerStoreBackend& backend,
+  const std::span<const LayerStoreEdit> edits) {
+  for (auto&& edit: edits) {
+    switch (edit.mKind) {
+      case LayerStoreEdit::Kind::Set:
+        if (!backend.Set(edit.mManifestPath, edit.mDisabled)) {
+          return false;
+        }
+        break;
+      case LayerStoreEdit::Kind::Delete:
+        if (!backend.Delete(edit.mManifestPath)) {
+          return false;
+        }
+        break;
+    }
+  }
+  return true;
+}
+
+MemoryLayerStoreBackend::MemoryLayerStoreBackend(std::vector<Entry> entries)
+  : mEntries(std::move(entries)) {}
+
+std::vector<LayerStoreBackend::Entry> MemoryLayerStoreBackend::Read() const {
+  return mEntries;
+}
+
+bool MemoryLayerStoreBackend::Set(
+  const std::filesystem::path& manifestPath,
+  const uint32_t disabled) {
+  const auto it
+    = std::ranges::find(mEntries, manifestPath, &Entry::mManifestPath);
+  if (it == mEntries.end()) {
+    mEntries.push_back({manifestPath, disabled});
+  } else {
+    it->mDisabled = disabled;
+  }
+  return true;
+}
+
+bool MemoryLayerStoreBackend::Delete(
+  const std::filesystem::path& manifestPath) {
+  return std::erase_if(
+           mEntries,
+           [&](const Entry& entry) {
+             return entry.mManifestPath == manifestPath;
+           })
+    > 0;
+}
+
+TSVLayerStoreBackend::TSVLayerStoreBackend(const std::filesystem::path& path)
+  : mPath(path) {}
+
+std::vector<LayerStoreBackend::Entry> TSVLayerStoreBackend::Read() const {
+  std::vector<Entry> ret;
+  std::ifstream f(mPath);
+  std::string line;
+  while (std::getline(f, line)) {
+    const auto tab = line.find('\t');
+    if (tab == std::string::npos) {
+      continue;
+    }
+    const auto value = std::string_view {line}.substr(0, tab);
+    const auto path = std::string_view {line}.substr(tab + 1);
+
+    Entry entry {
+      std::filesystem::path {std::u8string_view {
+        reinterpret_cast<const char8_t*>(path.data()), path.size()}},
+    };
+    uint32_t disabled {};
+    const auto end = value.data() + value.size();
+    if (const auto [ptr, ec] = std::from_chars(value.data(), end, disabled);
+        ec == std::errc {} && ptr == end) {
+      entry.mDisabled = disabled;
+    }
+    ret.push_back(std::move(entry));
+  }
+  return ret;
+}
+
+bool TSVLayerStoreBackend::Set(
+  const std::filesystem::path& manifestPath,
+  const uint32_t disabled) {
+  MemoryLayerStoreBackend entries {Read()};
+  entries.Set(manifestPath, disabled);
+  return Write(mPath, entries.Read());
+}
+
+bool TSVLayerStoreBackend::Delete(const std::filesystem::path& manifestPath) {
+  MemoryLayerStoreBackend entries {Read()};
+  if (!entries.Delete(manifestPath)) {
+    return false;
+  }
+  return Write(mPath, entries.Read());
+}
+
+bool TSVLayerStoreBackend::Write(
+  const std::filesystem::path& path,
+  const std::span<const Entry> entries) {
+  std::ofstream f(path, std::ios::binary | std::ios::trunc);
+  for (auto&& entry: entries) {
+    const auto utf8 = entry.mManifestPath.u8string();
+    // Non-DWORD values are written as `?`, and read back as non-DWORDs
+    if (entry.mDisabled) {
+      f << *entry.mDisabled;
+    } else {
+      f << '?';
+    }
+    f << '\t';
+    f.write(reinterpret_cast<const char*>(utf8.data()), utf8.size());
+    f << '\n';
+  }
+  return f.good();
+}
+
+}// namespace FredEmmott::OpenXRLayers
@@ -0,0 +1,114 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "APILayer.hpp"
+
+namespace FredEmmott::OpenXRLayers {
+
+/** Ordered storage for a list of API layers, e.g. a registry key.
+ *
+ * Entries are kept in insertion order, like registry values: `Set()` changes
+ * an existing entry in place, or appends a new entry. There is no way to
+ * insert in the middle, so reordering requires deleting and re-appending.
+ */
+class LayerStoreBackend {
+ public:
+  struct Entry {
+    std::filesystem::path mManifestPath;
+    /// nullopt if the stored value is not a DWORD
+    std::optional<uint32_t> mDisabled;
+
+    bool operator==(const Entry&) const noexcept = default;
+  };
+
+  virtual ~LayerStoreBackend() = default;
+
+  [[nodiscard]]
+  virtual std::vector<Entry> Read() const = 0;
+  virtual bool Set(
+    const std::filesystem::path& manifestPath,
+    uint32_t disabled) = 0;
+  virtual bool Delete(const std::filesystem::path& manifestPath) = 0;
+};
+
+/// Non-DWORD values become nullopt, so they are left alone unless moved
+[[nodiscard]]
+std::vector<LayerStoreBackend::Entry> ToLayerStoreEntries(
+  const std::vector<APILayer>&);
+[[nodiscard]]
+std::vector<APILayer> ToAPILayers(
+  const APILayerStore* source,
+  std::span<const LayerStoreBackend::Entry>);
+
+struct LayerStoreEdit {
+  enum class Kind {
+    Set,
+    Delete,
+  };
+
+  Kind mKind {};
+  std::filesystem::path mManifestPath;
+  /// Only used for `Kind::Set`
+  uint32_t mDisabled {};
+
+  bool operator==(const LayerStoreEdit&) const noexcept = default;
+};
+
+/** The fewest edits that turn `before` into `after`.
+ *
+ * As entries can only be appended, the entries that can stay in place are the
+ * longest prefix of `after` that is also a subsequence of `before`; changed
+ * values in that prefix are set in place, and everything else is deleted and
+ * re-appended. Toggling a layer is a single `Set()`.
+ */
+[[nodiscard]]
+std::vector<LayerStoreEdit> DiffLayerStore(
+  std::span<const LayerStoreBackend::Entry> before,
+  std::span<const LayerStoreBackend::Entry> after);
+
+/// Stops at the first failure
+bool ApplyLayerStoreEdits(
+  LayerStoreBackend&,
+  std::span<const LayerStoreEdit>);
+
+class MemoryLayerStoreBackend final : public LayerStoreBackend {
+ public:
+  MemoryLayerStoreBackend() = default;
+  explicit MemoryLayerStoreBackend(std::vector<Entry> entries);
+
+  std::vector<Entry> Read() const override;
+  bool Set(const std::filesystem::path&, uint32_t disabled) override;
+  bool Delete(const std::filesystem::path&) override;
+
+ private:
+  std::vector<Entry> mEntries;
+};
+
+/** A text file with one `disabled<TAB>manifestPath` line per layer.
+ *
+ * This is the format of the registry backups written by previous versions,
+ * before the `ChangeJournal`. The file is rewritten on every change.
+ */
+class TSVLayerStoreBackend final : public LayerStoreBackend {
+ public:
+  TSVLayerStoreBackend() = delete;
+  explicit TSVLayerStoreBackend(const std::filesystem::path& path);
+
+  std::vector<Entry> Read() const override;
+  bool Set(const std::filesystem::path&, uint32_t disabled) override;
+  bool Delete(const std::filesystem::path&) override;
+
+  static bool Write(const std::filesystem::path&, std::span<const Entry>);
+
+ private:
+  std::filesystem::path mPath;
+};
+
+}// namespace FredEmmott::OpenXRLayers
@@ -0,0 +1,99 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "LayerStoreTransaction.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <utility>
+
+#include "APILayerStore.hpp"
+#include "ChangeJournal.hpp"
+#include "LayerStoreBackend.hpp"
+
+namespace FredEmmott::OpenXRLayers {
+
+namespace {
+// Serializes commits within this process; other processes are caught by
+// the generation check
+std::mutex gCommitMutex;
+
+bool IsUnchanged(const APILayerStore& store, const StoreSnapshot& base) {
+  if (store.GetGeneration() == base.mGeneration) {
+    return true;
+  }
+  // The generation also changes when the store is notified of our own
+  // previous writes; that is only a conflict if the content differs.
+  return store.GetSnapshot()->mLayers == base.mLayers;
+}
+}// namespace
+
+void LayerStoreTransaction::Stage(
+  ReadWriteAPILayerStore* const store,
+  std::shared_ptr<const StoreSnapshot> base,
+  std::vector<APILayer> layers) {
+  const auto it = std::ranges::find(mEdits, store, &Edit::mStore);
+  if (it != mEdits.end()) {
+    it->mLayers = std::move(layers);
+    return;
+  }
+  mEdits.push_back({store, std::move(base), std::move(layers)});
+}
+
+std::expected<uint64_t, LayerStoreTransaction::Error>
+LayerStoreTransaction::Commit() {
+  const auto edits = std::exchange(mEdits, {});
+  const std::unique_lock lock(gCommitMutex);
+
+  for (auto&& edit: edits) {
+    if (!IsUnchanged(*edit.mStore, *edit.mBase)) {
+      return std::unexpected {ConflictError {edit.mStore}};
+    }
+  }
+
+  for (auto it = edits.begin(); it != edits.end(); ++it) {
+    if (it->mLayers == it->mBase->mLayers) {
+      continue;
+    }
+    if (!it->mStore->WriteAPILayers(it->mBase->mLayers, it->mLayers)) {
+      WriteError error {it->mStore, true};
+      // Include the failed store, as it may have been partially written
+      Rollback({edits.begin(), std::next(it)}, error);
+      return std::unexpected {error};
+    }
+  }
+
+  std::vector<ChangeJournal::StoreChange> changes;
+  for (auto&& edit: edits) {
+    if (edit.mLayers == edit.mBase->mLayers) {
+      continue;
+    }
+    changes.push_back({
+      edit.mStore->GetDisplayName(),
+      ToLayerStoreEntries(edit.mBase->mLayers),
+      ToLayerStoreEntries(edit.mLayers),
+    });
+  }
+  if (changes.empty()) {
+    return 0;
+  }
+  return ChangeJournal::Get().Record(changes);
+}
+
+void LayerStoreTransaction::Rollback(
+  const std::span<const Edit> written,
+  WriteError& error) {
+  for (auto&& edit: written) {
+    if (edit.mLayers == edit.mBase->mLayers) {
+      continue;
+    }
+    // The store may be partially written, so we can't use the staged layers
+    // as the pre-image; let the store re-read itself instead
+    edit.mStore->SetAPILayers(edit.mBase->mLayers);
+    if (edit.mStore->GetSnapshot()->mLayers != edit.mBase->mLayers) {
+      error.mRolledBack = false;
+    }
+  }
+}
+
+}// namespace FredEmmott::OpenXRLayers
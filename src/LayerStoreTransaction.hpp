@@ -0,0 +1,78 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <span>
+#include <variant>
+#include <vector>
+
+#include "APILayer.hpp"
+
+namespace FredEmmott::OpenXRLayers {
+class APILayerStore;
+class ReadWriteAPILayerStore;
+struct StoreSnapshot;
+
+/** Replaces the layers in one or more stores, all or nothing.
+ *
+ * Each edit is based on a snapshot of its store. `Commit()` checks that none
+ * of the stores have changed since their snapshots were taken - e.g. because
+ * an installer modified them - before writing anything; the snapshots are also
+ * the pre-images for the writes, so the stores are not re-read.
+ *
+ * If any write fails, every store that has been written to is restored from
+ * its snapshot.
+ */
+class LayerStoreTransaction final {
+ public:
+  /// A store changed after its snapshot was taken; nothing was written
+  struct ConflictError {
+    const APILayerStore* mStore {nullptr};
+  };
+  /// Writing to a store failed
+  struct WriteError {
+    const APILayerStore* mStore {nullptr};
+    /// False if restoring any of the stores also failed
+    bool mRolledBack {false};
+  };
+  using Error = std::variant<ConflictError, WriteError>;
+
+  LayerStoreTransaction() = default;
+
+  /** Replace the layers in `store`.
+   *
+   * `base` must be a snapshot of `store`; staging the same store again
+   * replaces the earlier edit, but keeps the earlier base.
+   */
+  void Stage(
+    ReadWriteAPILayerStore* store,
+    std::shared_ptr<const StoreSnapshot> base,
+    std::vector<APILayer> layers);
+
+  [[nodiscard]]
+  bool empty() const noexcept {
+    return mEdits.empty();
+  }
+
+  /** Write all staged edits; the transaction is empty afterwards.
+   *
+   * Successful commits are recorded in the `ChangeJournal`; returns the
+   * journal entry's ID, or 0 if nothing changed.
+   */
+  std::expected<uint64_t, Error> Commit();
+
+ private:
+  struct Edit {
+    ReadWriteAPILayerStore* mStore {nullptr};
+    std::shared_ptr<const StoreSnapshot> mBase;
+    std::vector<APILayer> mLayers;
+  };
+  std::vector<Edit> mEdits;
+
+  void Rollback(std::span<const Edit> written, WriteError&);
+};
+
+}// namespace FredEmmott::OpenXRLayers
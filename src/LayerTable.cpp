@@ -0,0 +1,120 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "LayerTable.hpp"
+
+#include <magic_enum/magic_enum.hpp>
+
+#include <stdexcept>
+#include <utility>
+
+namespace FredEmmott::OpenXRLayers {
+
+static_assert(
+  magic_enum::enum_count<APILayer::Value>()
+  <= LayerTable::Packed::ValueMask + 1);
+
+namespace {
+uint8_t Pack(const APILayer& layer, const APILayerDetails& details) {
+  uint8_t ret = static_cast<uint8_t>(layer.mValue);
+  if (layer.GetKind() == APILayer::Kind::Implicit) {
+    ret |= LayerTable::Packed::Implicit;
+  }
+  if (details.mState == APILayerDetails::State::Loaded) {
+    ret |= LayerTable::Packed::Loaded;
+  }
+  ret |= (layer.mArchitectures.underlying()
+          << LayerTable::Packed::ArchitecturesShift)
+    & LayerTable::Packed::ArchitecturesMask;
+  return ret;
+}
+}// namespace
+
+LayerTable::LayerTable(
+  const std::vector<APILayer>& layers,
+  const APILayerDetailsMap& details) {
+  this->reserve(layers.size());
+  for (auto&& layer: layers) {
+    this->emplace_back(layer, details.at(layer.GetManifestPath()));
+  }
+}
+
+void LayerTable::reserve(const std::size_t capacity) {
+  mPacked.reserve(capacity);
+  mNameIDs.reserve(capacity);
+  mPathIDs.reserve(capacity);
+  mLayers.reserve(capacity);
+  mDetails.reserve(capacity);
+}
+
+void LayerTable::clear() noexcept {
+  mPacked.clear();
+  mNameIDs.clear();
+  mPathIDs.clear();
+  mLayers.clear();
+  mDetails.clear();
+}
+
+void LayerTable::emplace_back(
+  const APILayer& layer,
+  std::shared_ptr<const APILayerDetails> details) {
+  mPacked.push_back(Pack(layer, *details));
+  mNameIDs.push_back(APILayer::Key {details->mName});
+  mPathIDs.push_back(layer.GetKey());
+  mLayers.push_back(layer);
+  mDetails.push_back(std::move(details));
+}
+
+LayerTable::Row LayerTable::at(const std::size_t index) const {
+  if (index >= size()) [[unlikely]] {
+    throw std::out_of_range("LayerTable row out of range");
+  }
+  return (*this)[index];
+}
+
+std::vector<std::size_t> LayerTable::Select(const Filter filter) const {
+  std::vector<std::size_t> ret;
+  ret.reserve(mPacked.size());
+  for (std::size_t i = 0; i < mPacked.size(); ++i) {
+    if (filter.Matches(mPacked[i])) {
+      ret.push_back(i);
+    }
+  }
+  return ret;
+}
+
+std::size_t LayerTable::Count(const Filter filter) const noexcept {
+  std::size_t ret = 0;
+  // No branches, so this can be vectorized
+  for (const auto packed: mPacked) {
+    ret += filter.Matches(packed);
+  }
+  return ret;
+}
+
+std::optional<std::size_t> LayerTable::FindLast(
+  const Filter filter) const noexcept {
+  for (auto i = mPacked.size(); i > 0; --i) {
+    if (filter.Matches(mPacked[i - 1])) {
+      return i - 1;
+    }
+  }
+  return std::nullopt;
+}
+
+LayerTable LayerTable::Subset(
+  const std::span<const std::size_t> indices) const {
+  LayerTable ret;
+  ret.mRelations = mRelations;
+  ret.reserve(indices.size());
+  for (const auto i: indices) {
+    ret.mPacked.push_back(mPacked.at(i));
+    ret.mNameIDs.push_back(mNameIDs.at(i));
+    ret.mPathIDs.push_back(mPathIDs.at(i));
+    ret.mLayers.push_back(mLayers.at(i));
+    ret.mDetails.push_back(mDetails.at(i));
+  }
+  return ret;
+}
+
+}// namespace FredEmmott::OpenXRLayers
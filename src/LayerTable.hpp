@@ -0,0 +1,285 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <compare>
+#include <cstdint>
+#include <filesystem>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <span>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "APILayer.hpp"
+#include "portability/filesystem.hpp"
+
+namespace FredEmmott::OpenXRLayers {
+
+class LayerRelations;
+
+/// Manifest details keyed by manifest path.
+///
+/// Loading details is relatively expensive - it parses the manifest and checks
+/// the library's signature - so this can be shared between lint runs that
+/// only differ in order or enabled state. Details are immutable once loaded,
+/// so maps and `LayerTable`s share them instead of copying them.
+using APILayerDetailsMap = std::unordered_map<
+  std::filesystem::path,
+  std::shared_ptr<const APILayerDetails>>;
+
+/** Layers and their details, stored column-by-column.
+ *
+ * Most passes only need each layer's value, kind, architectures, and name;
+ * these are in contiguous columns - the first three packed into a single byte
+ * per layer - so filtering is a tight loop over bytes. The full `APILayer` and
+ * `APILayerDetails` are stored out-of-line for the passes that need them.
+ *
+ * Rows can also be iterated or indexed as
+ * `std::tuple<const APILayer&, const APILayerDetails&>`, like a
+ * `std::vector<std::tuple<APILayer, APILayerDetails>>`.
+ */
+class LayerTable final {
+ public:
+  using Row = std::tuple<const APILayer&, const APILayerDetails&>;
+
+  /// Bits in the packed column
+  struct Packed {
+    static constexpr uint8_t ValueMask = 0b0000'0011;
+    static constexpr uint8_t Implicit = 1 << 2;
+    static constexpr uint8_t Loaded = 1 << 3;
+    static constexpr uint8_t ArchitecturesShift = 4;
+    static constexpr uint8_t ArchitecturesMask = 0b0011'0000;
+  };
+
+  /** Matches rows where `(packed & mMask) == mMatch`.
+   *
+   * Filters can be combined with `&` if they test different bits.
+   */
+  struct Filter {
+    uint8_t mMask {};
+    uint8_t mMatch {};
+
+    constexpr Filter operator&(const Filter& other) const noexcept {
+      return {
+        static_cast<uint8_t>(mMask | other.mMask),
+        static_cast<uint8_t>(mMatch | other.mMatch),
+      };
+    }
+
+    [[nodiscard]]
+    constexpr bool Matches(const uint8_t packed) const noexcept {
+      return (packed & mMask) == mMatch;
+    }
+  };
+
+  static constexpr Filter Enabled {
+    Packed::ValueMask,
+    static_cast<uint8_t>(APILayer::Value::Enabled),
+  };
+  static constexpr Filter Loaded {Packed::Loaded, Packed::Loaded};
+  static constexpr Filter Implicit {Packed::Implicit, Packed::Implicit};
+  static constexpr Filter Explicit {Packed::Implicit, 0};
+
+  class Iterator {
+   public:
+    using iterator_concept = std::random_access_iterator_tag;
+    // Dereferencing gives a prvalue, so this is only an input iterator for
+    // pre-C++20 algorithms
+    using iterator_category = std::input_iterator_tag;
+    using value_type = Row;
+    using difference_type = std::ptrdiff_t;
+
+    Iterator() = default;
+    Iterator(const LayerTable* table, const std::size_t index)
+      : mTable(table),
+        mIndex(index) {}
+
+    Row operator*() const {
+      return (*mTable)[mIndex];
+    }
+
+    Row operator[](const difference_type offset) const {
+      return (*mTable)[mIndex + offset];
+    }
+
+    Iterator& operator++() {
+      ++mIndex;
+      return *this;
+    }
+
+    Iterator operator++(int) {
+      auto ret = *this;
+      ++mIndex;
+      return ret;
+    }
+
+    Iterator& operator--() {
+      --mIndex;
+      return *this;
+    }
+
+    Iterator operator--(int) {
+      auto ret = *this;
+      --mIndex;
+      return ret;
+    }
+
+    Iterator& operator+=(const difference_type offset) {
+      mIndex += offset;
+      return *this;
+    }
+
+    Iterator& operator-=(const difference_type offset) {
+      mIndex -= offset;
+      return *this;
+    }
+
+    friend Iterator operator+(Iterator it, const difference_type offset) {
+      return it += offset;
+    }
+
+    friend Iterator operator+(const difference_type offset, Iterator it) {
+      return it += offset;
+    }
+
+    friend Iterator operator-(Iterator it, const difference_type offset) {
+      return it -= offset;
+    }
+
+    friend difference_type operator-(const Iterator& a, const Iterator& b) {
+      return static_cast<difference_type>(a.mIndex)
+        - static_cast<difference_type>(b.mIndex);
+    }
+
+    bool operator==(const Iterator& other) const noexcept {
+      return mIndex == other.mIndex;
+    }
+
+    auto operator<=>(const Iterator& other) const noexcept {
+      return mIndex <=> other.mIndex;
+    }
+
+    /// The row index
+    [[nodiscard]]
+    std::size_t GetIndex() const noexcept {
+      return mIndex;
+    }
+
+   private:
+    const LayerTable* mTable {nullptr};
+    std::size_t mIndex {};
+  };
+
+  LayerTable() = default;
+  LayerTable(const std::vector<APILayer>&, const APILayerDetailsMap&);
+
+  void reserve(std::size_t);
+  void clear() noexcept;
+  void emplace_back(const APILayer&, std::shared_ptr<const APILayerDetails>);
+
+  [[nodiscard]]
+  std::size_t size() const noexcept {
+    return mPacked.size();
+  }
+
+  [[nodiscard]]
+  bool empty() const noexcept {
+    return mPacked.empty();
+  }
+
+  [[nodiscard]]
+  Row operator[](const std::size_t index) const {
+    return {mLayers[index], *mDetails[index]};
+  }
+
+  [[nodiscard]]
+  Row at(std::size_t index) const;
+
+  [[nodiscard]]
+  Iterator begin() const noexcept {
+    return {this, 0};
+  }
+
+  [[nodiscard]]
+  Iterator end() const noexcept {
+    return {this, size()};
+  }
+
+  /// Value, kind, loaded state, and architectures; see `Packed`
+  [[nodiscard]]
+  std::span<const uint8_t> GetPacked() const noexcept {
+    return mPacked;
+  }
+
+  /// Interned `APILayerDetails::mName`s
+  [[nodiscard]]
+  std::span<const APILayer::Key> GetNameIDs() const noexcept {
+    return mNameIDs;
+  }
+
+  /// The `APILayer::Key`s, i.e. the interned manifest paths; for layers
+  /// enabled via environment variables, this is the layer name
+  [[nodiscard]]
+  std::span<const APILayer::Key> GetPathIDs() const noexcept {
+    return mPathIDs;
+  }
+
+  [[nodiscard]]
+  bool Matches(const std::size_t index, const Filter filter) const noexcept {
+    return filter.Matches(mPacked[index]);
+  }
+
+  [[nodiscard]]
+  Architectures GetArchitectures(const std::size_t index) const noexcept {
+    return static_cast<Architecture>(
+      (mPacked[index] & Packed::ArchitecturesMask)
+      >> Packed::ArchitecturesShift);
+  }
+
+  /// Indices of the matching rows, in order
+  [[nodiscard]]
+  std::vector<std::size_t> Select(Filter) const;
+
+  [[nodiscard]]
+  std::size_t Count(Filter) const noexcept;
+
+  /// The index of the last matching row
+  [[nodiscard]]
+  std::optional<std::size_t> FindLast(Filter) const noexcept;
+
+  /// A table containing only the specified rows, in the specified order
+  [[nodiscard]]
+  LayerTable Subset(std::span<const std::size_t> indices) const;
+
+  /** Relations that the caller has already built, if any.
+   *
+   * These may be for a superset or reordering of these layers; rows are found
+   * with `LayerRelations::Find()`. They are kept by `Subset()`, and must
+   * outlive this table.
+   */
+  [[nodiscard]]
+  const LayerRelations* GetRelations() const noexcept {
+    return mRelations;
+  }
+
+  void SetRelations(const LayerRelations* relations) noexcept {
+    mRelations = relations;
+  }
+
+ private:
+  // Hot columns
+  std::vector<uint8_t> mPacked;
+  std::vector<APILayer::Key> mNameIDs;
+  std::vector<APILayer::Key> mPathIDs;
+
+  // Cold data; details are shared, so `Subset()` does not copy them
+  std::vector<APILayer> mLayers;
+  std::vector<std::shared_ptr<const APILayerDetails>> mDetails;
+
+  const LayerRelations* mRelations {nullptr};
+};
+
+}// namespace FredEmmott::OpenXRLayers
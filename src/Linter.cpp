@@ -3,8 +3,11 @@
 
 #include "Linter.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <ranges>
+#include <thread>
 
 namespace FredEmmott::OpenXRLayers {
 
@@ -31,6 +34,11 @@ LayerKeySet LintError::GetAffectedLayers() const {
   return mAffectedLayers;
 }
 
+bool LintError::IsEquivalentTo(const LintError& other) const noexcept {
+  return mDescription == other.mDescription
+    && mAffectedLayers == other.mAffectedLayers;
+}
+
 Linter::Linter() {
   RegisterLinter(this);
 }
@@ -39,24 +47,117 @@ Linter::~Linter() {
   UnregisterLinter(this);
 }
 
-std::vector<std::shared_ptr<LintError>> RunAllLinters(
-  const APILayerStore* store,
+void LoadAPILayerDetails(
+  APILayerDetailsMap& details,
   const std::vector<APILayer>& layers) {
-  std::vector<std::shared_ptr<LintError>> errors;
-
-  std::vector<std::tuple<APILayer, APILayerDetails>> layersWithDetails;
   for (const auto& layer: layers) {
-    layersWithDetails.push_back({layer, {layer.mManifestPath}});
+    const auto& path = layer.GetManifestPath();
+    if (details.contains(path)) {
+      continue;
+    }
+    details.emplace(path, std::make_shared<const APILayerDetails>(path));
   }
+}
+
+LintErrors RunAllLinters(
+  const APILayerStore* store,
+  const std::vector<APILayer>& layers) {
+  APILayerDetailsMap details;
+  LoadAPILayerDetails(details, layers);
+  return RunAllLinters(store, layers, details);
+}
+
+LintErrors RunAllLinters(
+  const APILayerStore* store,
+  const std::vector<APILayer>& layers,
+  const APILayerDetailsMap& details,
+  const LayerRelations* relations) {
+  LintErrors errors;
+
+  LayerTable table {layers, details};
+  table.SetRelations(relations);
 
   auto it = std::back_inserter(errors);
   for (const auto linter: gLinters) {
-    std::ranges::move(linter->Lint(store, layersWithDetails), it);
+    std::ranges::move(linter->Lint(store, table), it);
   }
 
   return errors;
 }
 
+static LintErrors WithoutEquivalents(
+  const LintErrors& errors,
+  const LintErrors& toRemove) {
+  return errors | std::views::filter([&toRemove](const auto& error) {
+           return !std::ranges::any_of(toRemove, [&error](const auto& other) {
+             return error->IsEquivalentTo(*other);
+           });
+         })
+    | std::ranges::to<std::vector>();
+}
+
+LintDiff DiffLintErrors(
+  std::vector<APILayer> layers,
+  LintErrors errors,
+  const LintErrors& baseErrors) {
+  LintDiff ret {
+    .mLayers = std::move(layers),
+    .mIntroduced = WithoutEquivalents(errors, baseErrors),
+    .mResolved = WithoutEquivalents(baseErrors, errors),
+  };
+  ret.mErrors = std::move(errors);
+  return ret;
+}
+
+std::vector<LintDiff> RunAllLintersForCandidates(
+  const APILayerStore* store,
+  const std::span<const std::vector<APILayer>> candidates,
+  const APILayerDetailsMap& details,
+  const LintErrors& baseErrors,
+  const LayerRelations* relations) {
+  const auto haveAllDetails = std::ranges::all_of(
+    candidates | std::views::join, [&details](const APILayer& layer) {
+      return details.contains(layer.GetManifestPath());
+    });
+  // Only copied if something is missing; either way, from here on, the
+  // details are only read, so can be shared between threads
+  APILayerDetailsMap extendedDetails;
+  if (!haveAllDetails) {
+    extendedDetails = details;
+    for (auto&& candidate: candidates) {
+      LoadAPILayerDetails(extendedDetails, candidate);
+    }
+  }
+  const auto& sharedDetails = haveAllDetails ? details : extendedDetails;
+
+  // There may be a candidate per warning, so use a thread per core rather
+  // than per candidate
+  std::vector<LintErrors> errors(candidates.size());
+  std::atomic<std::size_t> next {0};
+  const auto threadCount = std::min<std::size_t>(
+    candidates.size(), std::max(1u, std::thread::hardware_concurrency()));
+  {
+    std::vector<std::jthread> threads;
+    threads.reserve(threadCount);
+    for (std::size_t i = 0; i < threadCount; ++i) {
+      threads.emplace_back([&] {
+        for (auto j = next++; j < candidates.size(); j = next++) {
+          errors.at(j)
+            = RunAllLinters(store, candidates[j], sharedDetails, relations);
+        }
+      });
+    }
+  }
+
+  std::vector<LintDiff> ret;
+  ret.reserve(candidates.size());
+  for (std::size_t i = 0; i < candidates.size(); ++i) {
+    ret.push_back(
+      DiffLintErrors(candidates[i], std::move(errors.at(i)), baseErrors));
+  }
+  return ret;
+}
+
 OrderingLintError::OrderingLintError(
   const std::string& description,
   const APILayer& layerToMove,
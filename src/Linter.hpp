@@ -6,10 +6,14 @@
 #include <filesystem>
 #include <memory>
 #include <set>
+#include <span>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "APILayer.hpp"
+#include "LayerTable.hpp"
+#include "portability/filesystem.hpp"
 
 namespace FredEmmott::OpenXRLayers {
 
@@ -26,6 +30,9 @@ class LintError {
   [[nodiscard]] std::string GetDescription() const;
   [[nodiscard]] LayerKeySet GetAffectedLayers() const;
 
+  /// Same description and affected layers, e.g. from a different lint run
+  [[nodiscard]] bool IsEquivalentTo(const LintError&) const noexcept;
+
  private:
   std::string mDescription;
   LayerKeySet mAffectedLayers;
@@ -111,11 +118,52 @@ class Linter {
 
   virtual std::vector<std::shared_ptr<LintError>> Lint(
     const APILayerStore*,
-    const std::vector<std::tuple<APILayer, APILayerDetails>>&) = 0;
+    const LayerTable&) = 0;
+};
+
+using LintErrors = std::vector<std::shared_ptr<LintError>>;
+
+/// Load details for any layers that are not already in the map
+void LoadAPILayerDetails(APILayerDetailsMap&, const std::vector<APILayer>&);
+
+LintErrors RunAllLinters(const APILayerStore*, const std::vector<APILayer>&);
+/// `relations` may be for a superset of the layers; see `LayerTable`
+LintErrors RunAllLinters(
+  const APILayerStore*,
+  const std::vector<APILayer>&,
+  const APILayerDetailsMap&,
+  const LayerRelations* relations = nullptr);
+
+/// The consequences of changing the layers from a base configuration
+struct LintDiff {
+  std::vector<APILayer> mLayers;
+  /// All errors for `mLayers`
+  LintErrors mErrors;
+  /// Errors that are not present in the base configuration
+  LintErrors mIntroduced;
+  /// Errors from the base configuration that are not present in `mLayers`
+  LintErrors mResolved;
 };
 
-std::vector<std::shared_ptr<LintError>> RunAllLinters(
+/// Compare the errors for `layers` with the errors for a base configuration
+LintDiff DiffLintErrors(
+  std::vector<APILayer> layers,
+  LintErrors errors,
+  const LintErrors& baseErrors);
+
+/** Lint hypothetical configurations without writing them, concurrently.
+ *
+ * `details`, `baseErrors`, and `relations` are the caller's existing results
+ * for the base configuration; details are only loaded for layers that are not
+ * already in `details`, and are then shared, read-only, by every candidate.
+ *
+ * Returns one diff per candidate, in the same order.
+ */
+std::vector<LintDiff> RunAllLintersForCandidates(
   const APILayerStore*,
-  const std::vector<APILayer>&);
+  std::span<const std::vector<APILayer>> candidates,
+  const APILayerDetailsMap& details,
+  const LintErrors& baseErrors,
+  const LayerRelations* relations = nullptr);
 
 }// namespace FredEmmott::OpenXRLayers
\ No newline at end of file
@@ -12,28 +12,30 @@
 namespace FredEmmott::OpenXRLayers {
 
 Architecture LoaderData::GetBuildArchitecture() {
-  return Platform::Get().GetBuildArchitecture();
+  return Platform::GetBuildArchitecture();
 }
 
 void to_json(nlohmann::json& j, const LoaderData& data) {
   j.update(
     nlohmann::json {
       {"architecture", magic_enum::enum_name(data.mArchitecture)},
-      {"queryExtensionsResult", std::to_underlying(data.mQueryLayersResult)},
+      {"queryExtensionsResult",
+       std::to_underlying(data.mQueryExtensionsResult)},
       {"queryLayersResult", std::to_underlying(data.mQueryLayersResult)},
       {"enabledLayerNames", data.mEnabledLayerNames},
       {"availableExtensionNames", data.mAvailableExtensionNames},
       {"environmentVariables",
        {
          {"beforeLoader", data.mEnvironmentVariablesBeforeLoader},
-         {"afterLoader", data.mEnvironmentVariablesAfterLoader},
+         {"changes", data.mEnvironmentVariableChanges},
        }},
+      {"isComplete", data.mIsComplete},
     });
 }
 
 void from_json(const nlohmann::json& j, LoaderData& data) {
   data.mArchitecture = *magic_enum::enum_cast<Architecture>(
-    std::string_view {j["architecture"]});
+    j.at("architecture").get_ref<const std::string&>());
   data.mQueryLayersResult = static_cast<XrResult>(j["queryLayersResult"]);
   data.mQueryExtensionsResult
     = static_cast<XrResult>(j["queryExtensionsResult"]);
@@ -43,8 +45,9 @@ void from_json(const nlohmann::json& j, LoaderData& data) {
     .at("beforeLoader")
     .get_to(data.mEnvironmentVariablesBeforeLoader);
   j.at("environmentVariables")
-    .at("afterLoader")
-    .get_to(data.mEnvironmentVariablesAfterLoader);
+    .at("changes")
+    .get_to(data.mEnvironmentVariableChanges);
+  data.mIsComplete = j.value("isComplete", true);
 }
 
 }// namespace FredEmmott::OpenXRLayers
\ No newline at end of file
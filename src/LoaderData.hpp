@@ -4,7 +4,10 @@
 #include <nlohmann/json_fwd.hpp>
 #include <openxr/openxr.h>
 
+#include <chrono>
+#include <expected>
 #include <filesystem>
+#include <memory>
 #include <string>
 #include <system_error>
 #include <unordered_set>
@@ -12,6 +15,7 @@
 
 #include "APILayerSignature.hpp"
 #include "Architectures.hpp"
+#include "Environment.hpp"
 
 namespace FredEmmott::OpenXRLayers {
 
@@ -39,9 +43,14 @@ struct LoaderData {
   struct BadExitCodeError {
     uint32_t mExitCode;
   };
-  struct InvalidJSONError {
+  /// The helper's response could not be decoded
+  struct InvalidResponseError {
     std::string mExplanation;
   };
+  /// The helper was killed because it did not exit in time
+  struct TimeoutError {
+    std::chrono::milliseconds mTimeout;
+  };
   using Error = std::variant<
     PendingError,
     PipeCreationError,
@@ -51,7 +60,8 @@ struct LoaderData {
     UnsignedHelperError,
     CanNotSpawnError,
     BadExitCodeError,
-    InvalidJSONError>;
+    InvalidResponseError,
+    TimeoutError>;
 
   Architecture mArchitecture {GetBuildArchitecture()};
   XrResult mQueryExtensionsResult {XR_RESULT_MAX_ENUM};
@@ -60,15 +70,38 @@ struct LoaderData {
   std::vector<std::string> mEnabledLayerNames;
   std::vector<std::string> mAvailableExtensionNames;
 
+  Environment mEnvironmentVariablesBeforeLoader;
   // It's possible for runtimes to modify the environment variables,
   // which can disable API layers
-  std::map<std::string, std::string> mEnvironmentVariablesBeforeLoader;
-  std::map<std::string, std::string> mEnvironmentVariablesAfterLoader;
+  EnvironmentDiff mEnvironmentVariableChanges;
+
+  /** False if this is from before the runtime was loaded.
+   *
+   * `mAvailableExtensionNames` and `mEnvironmentVariableChanges` are from a
+   * previous query, or empty if there wasn't one; changes the runtime makes
+   * to the environment - and so to `mEnabledLayerNames` - are missing.
+   */
+  bool mIsComplete {true};
+
+  /// Not serialized; set if this is being replaced by a newer query
+  bool mIsRefreshing {false};
+
+  bool operator==(const LoaderData&) const noexcept = default;
 
  private:
   static Architecture GetBuildArchitecture();
 };
 
+/// Loader data for a specific runtime, instead of the active runtime
+struct RuntimeLoaderData {
+  /// The runtime's manifest
+  std::filesystem::path mRuntime;
+  /// For display; the runtime's name, or the manifest path
+  std::string mName;
+  std::expected<std::shared_ptr<const LoaderData>, LoaderData::Error> mResult {
+    std::unexpected {LoaderData::PendingError {}}};
+};
+
 void from_json(const nlohmann::json&, LoaderData&);
 void to_json(nlohmann::json&, const LoaderData&);
 
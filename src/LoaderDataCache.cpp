@@ -0,0 +1,111 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#include "LoaderDataCache.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <format>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include "APILayerStore.hpp"
+#include "Config.hpp"
+#include "Platform.hpp"
+#include "portability/filesystem.hpp"
+
+namespace FredEmmott::OpenXRLayers {
+
+LoaderDataCache::LoaderDataCache(std::filesystem::path directory)
+  : mDirectory(std::move(directory)) {}
+
+std::size_t LoaderDataCache::GetFingerprint(
+  const Architecture arch,
+  const std::size_t serverFingerprint) {
+  auto& platform = Platform::Get();
+
+  std::string fingerprint;
+  const auto append = [&fingerprint](const auto& value) {
+    fingerprint += std::format("{}", value);
+    fingerprint += '\0';
+  };
+
+  append(Config::BUILD_VERSION);
+  append(serverFingerprint);
+  for (auto&& store: APILayerStore::Get()) {
+    if (!store->GetArchitectures().contains(arch)) {
+      continue;
+    }
+    append(store->GetDisplayName());
+    for (auto&& layer: store->GetSnapshot()->mLayers) {
+      const auto& path = layer.GetManifestPath();
+      append(std::hash<std::filesystem::path> {}(path));
+      append(std::to_underlying(layer.mValue));
+      // Covers the manifest's contents, e.g. the layer name and
+      // `disable_environment`
+      append(platform.GetFileChangeTime(path).time_since_epoch().count());
+    }
+  }
+  return std::hash<std::string> {}(fingerprint);
+}
+
+std::shared_ptr<const LoaderData> LoaderDataCache::Load(
+  const Architecture arch,
+  const std::size_t fingerprint) const {
+  std::ifstream f(GetPath(arch), std::ios::binary);
+  if (!f) {
+    return nullptr;
+  }
+
+  try {
+    const auto json = nlohmann::json::parse(f);
+    if (json.at("fingerprint").get<std::size_t>() != fingerprint) {
+      return nullptr;
+    }
+    auto ret = std::make_shared<LoaderData>(
+      json.at("loaderData").get<LoaderData>());
+    if (ret->mArchitecture != arch) {
+      return nullptr;
+    }
+    return ret;
+  } catch (const nlohmann::json::exception&) {
+    return nullptr;
+  }
+}
+
+void LoaderDataCache::Store(
+  const Architecture arch,
+  const std::size_t fingerprint,
+  const LoaderData& data) const {
+  std::error_code ec;
+  std::filesystem::create_directories(mDirectory, ec);
+  if (ec) {
+    return;
+  }
+
+  // Write then rename, so a crash or concurrent instance can not leave a
+  // partial file behind
+  const auto path = GetPath(arch);
+  auto temporary = path;
+  temporary += ".tmp";
+  {
+    std::ofstream f(temporary, std::ios::binary | std::ios::trunc);
+    f << nlohmann::json {
+      {"fingerprint", fingerprint},
+      {"loaderData", data},
+    };
+    if (!f.good()) {
+      return;
+    }
+  }
+  std::filesystem::rename(temporary, path, ec);
+}
+
+std::filesystem::path LoaderDataCache::GetPath(const Architecture arch) const {
+  return mDirectory
+    / std::format("loader-data-{}.json", magic_enum::enum_name(arch));
+}
+
+}// namespace FredEmmott::OpenXRLayers
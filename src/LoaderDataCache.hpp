@@ -0,0 +1,48 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+
+#include "Architectures.hpp"
+#include "LoaderData.hpp"
+
+namespace FredEmmott::OpenXRLayers {
+
+/** The most recent `LoaderData` for each architecture, persisted between
+ * launches.
+ *
+ * Each entry is stored with a fingerprint of everything that affects it, so
+ * it can be shown immediately on the next launch - before the helpers have
+ * started - if nothing has changed in the meantime.
+ */
+class LoaderDataCache final {
+ public:
+  LoaderDataCache() = delete;
+  explicit LoaderDataCache(std::filesystem::path directory);
+
+  /** Combines a server fingerprint with everything else the data depends
+   * on: the layers in each store for this architecture, and our version.
+   *
+   * See `LoaderDataSpawner::GetServerFingerprint()`.
+   */
+  [[nodiscard]]
+  static std::size_t GetFingerprint(
+    Architecture,
+    std::size_t serverFingerprint);
+
+  /// nullptr if there is no entry, or if its fingerprint does not match
+  [[nodiscard]]
+  std::shared_ptr<const LoaderData> Load(Architecture, std::size_t fingerprint)
+    const;
+  void Store(Architecture, std::size_t fingerprint, const LoaderData&) const;
+
+ private:
+  std::filesystem::path mDirectory;
+
+  std::filesystem::path GetPath(Architecture) const;
+};
+
+}// namespace FredEmmott::OpenXRLayers
@@ -0,0 +1,381 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#include "LoaderDataFormat.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <format>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace FredEmmott::OpenXRLayers::LoaderDataFormat {
+
+static_assert(
+  std::endian::native == std::endian::little,
+  "The loader data format is little-endian");
+
+namespace {
+
+class Writer final {
+ public:
+  void WriteUnsigned(uint64_t value) {
+    while (value >= 0x80) {
+      mBuffer.push_back(static_cast<char>((value & 0x7f) | 0x80));
+      value >>= 7;
+    }
+    mBuffer.push_back(static_cast<char>(value));
+  }
+
+  void WriteSigned(const int64_t value) {
+    WriteUnsigned(
+      (static_cast<uint64_t>(value) << 1)
+      ^ static_cast<uint64_t>(value >> 63));
+  }
+
+  void WriteBytes(const std::string_view value) {
+    mBuffer.append(value);
+  }
+
+  /// Index in the string table; `value` must outlive the writer
+  uint64_t Intern(const std::string_view value) {
+    const auto [it, inserted] = mIndices.try_emplace(value, mStrings.size());
+    if (inserted) {
+      mStrings.push_back(value);
+    }
+    return it->second;
+  }
+
+  [[nodiscard]]
+  const std::vector<std::string_view>& GetStrings() const noexcept {
+    return mStrings;
+  }
+
+  [[nodiscard]]
+  std::string& GetBuffer() noexcept {
+    return mBuffer;
+  }
+
+ private:
+  std::string mBuffer;
+  std::unordered_map<std::string_view, uint64_t> mIndices;
+  std::vector<std::string_view> mStrings;
+};
+
+class Reader final {
+ public:
+  explicit Reader(const std::string_view data) : mData(data) {}
+
+  [[nodiscard]]
+  std::optional<uint64_t> ReadUnsigned() {
+    uint64_t ret {};
+    for (int shift = 0; shift < 64; shift += 7) {
+      if (mData.empty()) {
+        return std::nullopt;
+      }
+      const auto byte = static_cast<uint8_t>(mData.front());
+      mData.remove_prefix(1);
+      ret |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80)) {
+        return ret;
+      }
+    }
+    return std::nullopt;
+  }
+
+  [[nodiscard]]
+  std::optional<int64_t> ReadSigned() {
+    const auto value = ReadUnsigned();
+    if (!value) {
+      return std::nullopt;
+    }
+    return static_cast<int64_t>((*value >> 1) ^ (~(*value & 1) + 1));
+  }
+
+  [[nodiscard]]
+  std::optional<std::string_view> ReadBytes(const uint64_t size) {
+    if (size > mData.size()) {
+      return std::nullopt;
+    }
+    const auto ret = mData.substr(0, size);
+    mData.remove_prefix(size);
+    return ret;
+  }
+
+  /// A count of items that each take at least `minimumSize` bytes
+  [[nodiscard]]
+  std::optional<uint64_t> ReadCount(const std::size_t minimumSize) {
+    const auto ret = ReadUnsigned();
+    // Don't let a corrupt count make us allocate a huge vector
+    if (!ret || *ret > mData.size() / minimumSize) {
+      return std::nullopt;
+    }
+    return ret;
+  }
+
+  [[nodiscard]]
+  bool IsEmpty() const noexcept {
+    return mData.empty();
+  }
+
+ private:
+  std::string_view mData;
+};
+
+std::unexpected<LoaderData::InvalidResponseError> Invalid(
+  const std::string_view what) {
+  return std::unexpected {
+    LoaderData::InvalidResponseError {std::string {what}},
+  };
+}
+
+}// namespace
+
+std::string EncodeFrame(
+  const LoaderData& data,
+  const EnvironmentEncoding environmentEncoding) {
+  Writer writer;
+  const auto& environment = data.mEnvironmentVariablesBeforeLoader;
+  const auto& changes = data.mEnvironmentVariableChanges;
+  const auto includeEnvironment
+    = environmentEncoding == EnvironmentEncoding::Full;
+
+  // Build the string table first, so the indices are known
+  std::vector<uint64_t> indices;
+  const auto intern = [&](auto&& range) {
+    for (auto&& value: range) {
+      indices.push_back(writer.Intern(value));
+    }
+  };
+  intern(data.mEnabledLayerNames);
+  intern(data.mAvailableExtensionNames);
+  if (includeEnvironment) {
+    for (auto&& [name, value]: environment.GetVariables()) {
+      indices.push_back(writer.Intern(name));
+      indices.push_back(writer.Intern(value));
+    }
+  }
+  for (auto&& change: changes) {
+    indices.push_back(writer.Intern(change.mName));
+    for (auto&& value: {&change.mBefore, &change.mAfter}) {
+      if (*value) {
+        indices.push_back(writer.Intern(**value));
+      }
+    }
+  }
+
+  // Reserved for the frame header
+  writer.WriteBytes(std::string_view {"\0\0\0\0", FrameHeaderSize});
+  writer.WriteBytes({Magic.data(), Magic.size()});
+  writer.WriteUnsigned(FormatVersion);
+  writer.WriteUnsigned(std::to_underlying(data.mArchitecture));
+  writer.WriteSigned(data.mQueryExtensionsResult);
+  writer.WriteSigned(data.mQueryLayersResult);
+  writer.WriteUnsigned(
+    (data.mIsComplete ? Flags::IsComplete : 0)
+    | (includeEnvironment ? Flags::HasEnvironment : 0));
+
+  writer.WriteUnsigned(writer.GetStrings().size());
+  for (auto&& value: writer.GetStrings()) {
+    writer.WriteUnsigned(value.size());
+    writer.WriteBytes(value);
+  }
+
+  auto index = indices.begin();
+  const auto writeIndices
+    = [&](const std::size_t count, const std::size_t perEntry) {
+        writer.WriteUnsigned(count);
+        for (std::size_t i = 0; i < count * perEntry; ++i) {
+          writer.WriteUnsigned(*index++);
+        }
+      };
+  writeIndices(data.mEnabledLayerNames.size(), 1);
+  writeIndices(data.mAvailableExtensionNames.size(), 1);
+
+  writer.WriteUnsigned(environment.GetHash());
+  if (includeEnvironment) {
+    // Name and value
+    writeIndices(environment.size(), 2);
+  }
+
+  writer.WriteUnsigned(changes.size());
+  for (auto&& change: changes) {
+    writer.WriteUnsigned(*index++);
+    writer.WriteUnsigned(
+      (change.mBefore ? ChangeFields::Before : 0)
+      | (change.mAfter ? ChangeFields::After : 0));
+    for (auto&& value: {&change.mBefore, &change.mAfter}) {
+      if (*value) {
+        writer.WriteUnsigned(*index++);
+      }
+    }
+  }
+
+  auto& ret = writer.GetBuffer();
+  const auto payloadSize = static_cast<uint32_t>(ret.size() - FrameHeaderSize);
+  const auto header = std::bit_cast<std::array<char, FrameHeaderSize>>(
+    payloadSize);
+  std::ranges::copy(header, ret.begin());
+  return std::move(ret);
+}
+
+std::expected<std::optional<std::string>, LoaderData::InvalidResponseError>
+TakeFrame(std::string& buffer) {
+  if (buffer.size() < FrameHeaderSize) {
+    return std::nullopt;
+  }
+  std::array<char, FrameHeaderSize> header {};
+  std::ranges::copy_n(buffer.begin(), FrameHeaderSize, header.begin());
+  const auto payloadSize = std::bit_cast<uint32_t>(header);
+  if (payloadSize > MaxPayloadSize) {
+    return Invalid(std::format("frame of {} bytes is too large", payloadSize));
+  }
+  if (buffer.size() < FrameHeaderSize + payloadSize) {
+    return std::nullopt;
+  }
+
+  auto ret = buffer.substr(FrameHeaderSize, payloadSize);
+  buffer.erase(0, FrameHeaderSize + payloadSize);
+  return ret;
+}
+
+std::expected<LoaderData, LoaderData::InvalidResponseError> Decode(
+  const std::string_view payload,
+  const Environment* const knownEnvironment) {
+  Reader reader {payload};
+
+  if (
+    reader.ReadBytes(Magic.size())
+    != std::string_view {Magic.data(), Magic.size()}) {
+    return Invalid("bad magic");
+  }
+  if (const auto version = reader.ReadUnsigned(); version != FormatVersion) {
+    return Invalid("unsupported format version");
+  }
+
+  LoaderData ret;
+  const auto arch = reader.ReadUnsigned();
+  const auto queryExtensionsResult = reader.ReadSigned();
+  const auto queryLayersResult = reader.ReadSigned();
+  const auto flags = reader.ReadUnsigned();
+  if (!(arch && queryExtensionsResult && queryLayersResult && flags)) {
+    return Invalid("truncated header");
+  }
+  ret.mArchitecture = static_cast<Architecture>(*arch);
+  ret.mQueryExtensionsResult = static_cast<XrResult>(*queryExtensionsResult);
+  ret.mQueryLayersResult = static_cast<XrResult>(*queryLayersResult);
+  ret.mIsComplete = (*flags & Flags::IsComplete);
+
+  // Each string takes at least one byte for its size
+  const auto stringCount = reader.ReadCount(1);
+  if (!stringCount) {
+    return Invalid("bad string count");
+  }
+  std::vector<std::string_view> strings;
+  strings.reserve(*stringCount);
+  for (uint64_t i = 0; i < *stringCount; ++i) {
+    const auto size = reader.ReadUnsigned();
+    const auto value = size ? reader.ReadBytes(*size) : std::nullopt;
+    if (!value) {
+      return Invalid("truncated string table");
+    }
+    strings.push_back(*value);
+  }
+  const auto readString = [&]() -> std::optional<std::string_view> {
+    const auto index = reader.ReadUnsigned();
+    if (!(index && *index < strings.size())) {
+      return std::nullopt;
+    }
+    return strings[*index];
+  };
+
+  for (auto&& out: {&ret.mEnabledLayerNames, &ret.mAvailableExtensionNames}) {
+    const auto count = reader.ReadCount(1);
+    if (!count) {
+      return Invalid("bad list size");
+    }
+    out->reserve(*count);
+    for (uint64_t i = 0; i < *count; ++i) {
+      const auto value = readString();
+      if (!value) {
+        return Invalid("bad string index");
+      }
+      out->emplace_back(*value);
+    }
+  }
+
+  const auto environmentHash = reader.ReadUnsigned();
+  if (!environmentHash) {
+    return Invalid("truncated environment hash");
+  }
+  auto& environment = ret.mEnvironmentVariablesBeforeLoader;
+  if (*flags & Flags::HasEnvironment) {
+    const auto count = reader.ReadCount(2);
+    if (!count) {
+      return Invalid("bad environment size");
+    }
+    for (uint64_t i = 0; i < *count; ++i) {
+      const auto name = readString();
+      const auto value = readString();
+      if (!(name && value)) {
+        return Invalid("bad string index");
+      }
+      // `Environment::Append()` requires this
+      if (i > 0 && *name <= environment.GetVariables().back().mName) {
+        return Invalid("environment is not sorted");
+      }
+      environment.Append(*name, *value);
+    }
+    if (environment.GetHash() != *environmentHash) {
+      return Invalid("environment does not match its hash");
+    }
+  } else if (
+    knownEnvironment && knownEnvironment->GetHash() == *environmentHash) {
+    environment = *knownEnvironment;
+  } else {
+    return Invalid("unknown environment");
+  }
+
+  const auto changeCount = reader.ReadCount(2);
+  if (!changeCount) {
+    return Invalid("bad change count");
+  }
+  auto& changes = ret.mEnvironmentVariableChanges;
+  changes.reserve(*changeCount);
+  for (uint64_t i = 0; i < *changeCount; ++i) {
+    const auto name = readString();
+    const auto fields = reader.ReadUnsigned();
+    if (!(name && fields)) {
+      return Invalid("truncated change");
+    }
+    if (i > 0 && *name <= changes.back().mName) {
+      return Invalid("changes are not sorted");
+    }
+    if (
+      *fields == 0
+      || (*fields & ~(ChangeFields::Before | ChangeFields::After))) {
+      return Invalid("bad change fields");
+    }
+    auto& change = changes.emplace_back(std::string {*name});
+    for (auto&& [field, out]: {
+           std::pair {ChangeFields::Before, &change.mBefore},
+           std::pair {ChangeFields::After, &change.mAfter},
+         }) {
+      if (!(*fields & field)) {
+        continue;
+      }
+      const auto value = readString();
+      if (!value) {
+        return Invalid("bad string index");
+      }
+      out->emplace(*value);
+    }
+  }
+
+  if (!reader.IsEmpty()) {
+    return Invalid("trailing data");
+  }
+  return ret;
+}
+
+}// namespace FredEmmott::OpenXRLayers::LoaderDataFormat
@@ -0,0 +1,91 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <expected>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "LoaderData.hpp"
+
+/** The binary encoding of `LoaderData` used by `loader-data` helpers in
+ * server mode.
+ *
+ * Each response is a frame: a little-endian `uint32_t` payload size, then the
+ * payload. Integers in the payload are LEB128 varints; signed integers are
+ * zigzag-encoded first:
+ *
+ * - `Magic`, then `FormatVersion`
+ * - `mArchitecture`, `mQueryExtensionsResult`, `mQueryLayersResult`
+ * - `Flags`
+ * - the string table: a count, then each string's size and bytes
+ * - `mEnabledLayerNames`, then `mAvailableExtensionNames`: each a count, then
+ *   string table indices
+ * - `Environment::GetHash()` of `mEnvironmentVariablesBeforeLoader`
+ * - if `Flags::HasEnvironment` is set, `mEnvironmentVariablesBeforeLoader`: a
+ *   count, then name and value string table indices, in name order
+ * - `mEnvironmentVariableChanges`: a count, then for each, the name's string
+ *   table index, a bitmask of `ChangeFields`, and the index of each value
+ *   that is present
+ *
+ * The environment is most of the data, and a helper's environment does not
+ * change while it is running, so the helper only sends it in its first frame;
+ * later frames only include the hash, and the changes the runtime made.
+ *
+ * This is decoded directly into a `LoaderData`, without an intermediate DOM;
+ * the JSON representation is still used for reports, the cache, and when
+ * running a helper by hand.
+ */
+namespace FredEmmott::OpenXRLayers::LoaderDataFormat {
+
+constexpr std::array Magic {'X', 'R', 'L', 'D'};
+// Increment when the format changes incompatibly
+constexpr uint32_t FormatVersion = 3;
+
+namespace Flags {
+constexpr uint64_t IsComplete = 1 << 0;
+constexpr uint64_t HasEnvironment = 1 << 1;
+}// namespace Flags
+
+namespace ChangeFields {
+constexpr uint64_t Before = 1 << 0;
+constexpr uint64_t After = 1 << 1;
+}// namespace ChangeFields
+
+enum class EnvironmentEncoding {
+  Full,
+  /// The receiver must already have the environment from an earlier frame
+  HashOnly,
+};
+
+constexpr std::size_t FrameHeaderSize = sizeof(uint32_t);
+/// Larger frames are assumed to be corrupt, e.g. text written by a runtime
+constexpr uint32_t MaxPayloadSize = 64 * 1024 * 1024;
+
+/// Includes the frame header
+[[nodiscard]]
+std::string EncodeFrame(const LoaderData&, EnvironmentEncoding);
+
+/** If `buffer` starts with a complete frame, remove it and return its
+ * payload.
+ *
+ * `std::nullopt` if more data is needed.
+ */
+[[nodiscard]]
+std::expected<std::optional<std::string>, LoaderData::InvalidResponseError>
+TakeFrame(std::string& buffer);
+
+/** Decode a payload, without the frame header.
+ *
+ * `knownEnvironment` is the environment from an earlier frame from the same
+ * helper, if any; it is used if this frame only includes the hash.
+ */
+[[nodiscard]]
+std::expected<LoaderData, LoaderData::InvalidResponseError> Decode(
+  std::string_view payload,
+  const Environment* knownEnvironment);
+
+}// namespace FredEmmott::OpenXRLayers::LoaderDataFormat
@@ -5,62 +5,144 @@
 #include <nlohmann/json.hpp>
 
 #include <iostream>
+#include <string>
+#include <string_view>
+#include <utility>
 
 #include "LoaderData.hpp"
+#include "LoaderDataFormat.hpp"
+#include "LoaderDataService.hpp"
 #include "Platform.hpp"
 
-namespace FredEmmott::OpenXRLayers {
+#ifndef _WIN32
+extern char** environ;
+#endif
 
-static LoaderData QueryLoaderDataInCurrentProcess() {
-  LoaderData ret {
-    .mEnvironmentVariablesBeforeLoader
-    = Platform::Get().GetEnvironmentVariables(),
-  };
+namespace FredEmmott::OpenXRLayers {
 
-  // We (mostly) don't care about the extensions, but enumerating them can load
-  // runtime DLL, which can call `setenv()` and change the rest. However, while
-  // they're currently unused in the linters and UI, we do include them in the
-  // report
-  uint32_t propertyCount {};
-  ret.mQueryExtensionsResult = xrEnumerateInstanceExtensionProperties(
-    nullptr, 0, &propertyCount, nullptr);
-  if (XR_SUCCEEDED(ret.mQueryExtensionsResult)) {
-    std::vector<XrExtensionProperties> extensions(
-      propertyCount, {XR_TYPE_EXTENSION_PROPERTIES});
-    ret.mQueryExtensionsResult = xrEnumerateInstanceExtensionProperties(
-      nullptr, propertyCount, &propertyCount, extensions.data());
-    if (XR_SUCCEEDED(ret.mQueryExtensionsResult)) {
-      for (auto&& ext: extensions) {
-        ret.mAvailableExtensionNames.emplace_back(ext.extensionName);
-      }
+static std::map<std::string, std::string> GetEnvironmentVariableMap() {
+#ifdef _WIN32
+  return Platform::Get().GetEnvironmentVariables();
+#else
+  // There's no POSIX `Platform`, and this is all we need from it
+  std::map<std::string, std::string> ret;
+  for (auto it = environ; it && *it; ++it) {
+    const std::string_view entry {*it};
+    const auto separator = entry.find('=');
+    if (separator == std::string_view::npos) {
+      continue;
     }
+    ret.emplace(entry.substr(0, separator), entry.substr(separator + 1));
   }
+  return ret;
+#endif
+}
+
+static Environment GetEnvironmentVariables() {
+  return Environment {GetEnvironmentVariableMap()};
+}
 
+/// Doesn't load the runtime
+static void QueryLayers(LoaderData& data) {
+  data.mEnabledLayerNames.clear();
   uint32_t layerCount {};
-  ret.mQueryLayersResult
+  data.mQueryLayersResult
     = xrEnumerateApiLayerProperties(0, &layerCount, nullptr);
-  if (XR_SUCCEEDED(ret.mQueryLayersResult)) {
+  if (XR_SUCCEEDED(data.mQueryLayersResult)) {
     std::vector<XrApiLayerProperties> layers(
       layerCount, {XR_TYPE_API_LAYER_PROPERTIES});
-    ret.mQueryLayersResult
+    data.mQueryLayersResult
       = xrEnumerateApiLayerProperties(layerCount, &layerCount, layers.data());
-    if (XR_SUCCEEDED(ret.mQueryLayersResult)) {
+    if (XR_SUCCEEDED(data.mQueryLayersResult)) {
       for (auto&& layer: layers) {
-        ret.mEnabledLayerNames.emplace_back(layer.layerName);
+        data.mEnabledLayerNames.emplace_back(layer.layerName);
+      }
+    }
+  }
+
+  data.mEnvironmentVariableChanges = Diff(
+    data.mEnvironmentVariablesBeforeLoader, GetEnvironmentVariables());
+}
+
+/// Loads the runtime
+static void QueryExtensions(LoaderData& data) {
+  data.mAvailableExtensionNames.clear();
+  uint32_t propertyCount {};
+  data.mQueryExtensionsResult = xrEnumerateInstanceExtensionProperties(
+    nullptr, 0, &propertyCount, nullptr);
+  if (XR_SUCCEEDED(data.mQueryExtensionsResult)) {
+    std::vector<XrExtensionProperties> extensions(
+      propertyCount, {XR_TYPE_EXTENSION_PROPERTIES});
+    data.mQueryExtensionsResult = xrEnumerateInstanceExtensionProperties(
+      nullptr, propertyCount, &propertyCount, extensions.data());
+    if (XR_SUCCEEDED(data.mQueryExtensionsResult)) {
+      for (auto&& ext: extensions) {
+        data.mAvailableExtensionNames.emplace_back(ext.extensionName);
       }
     }
   }
+}
+
+static LoaderData QueryLoaderDataInCurrentProcess(
+  Environment environmentBeforeLoader) {
+  LoaderData ret {
+    .mEnvironmentVariablesBeforeLoader = std::move(environmentBeforeLoader),
+  };
 
-  ret.mEnvironmentVariablesAfterLoader
-    = Platform::Get().GetEnvironmentVariables();
+  // We (mostly) don't care about the extensions, but enumerating them can load
+  // runtime DLL, which can call `setenv()` and change the rest. However, while
+  // they're currently unused in the linters and UI, we do include them in the
+  // report
+  QueryExtensions(ret);
+  QueryLayers(ret);
   return ret;
 }
 
+static void WriteFrame(
+  const LoaderData& data,
+  const LoaderDataFormat::EnvironmentEncoding environmentEncoding) {
+  const auto frame = LoaderDataFormat::EncodeFrame(data, environmentEncoding);
+  std::cout.write(frame.data(), frame.size());
+  std::cout.flush();
+}
+
 void LoaderDataMain() {
-  const auto data = QueryLoaderDataInCurrentProcess();
+  const auto data = QueryLoaderDataInCurrentProcess(GetEnvironmentVariables());
   const nlohmann::json json(data);
 
   std::cout << std::setw(2) << json << std::endl;
 }
 
+void LoaderDataServerMain() {
+  // The runtime may modify the environment on the first query, and it stays
+  // modified; later queries should still report the original environment
+  const auto environment = GetEnvironmentVariables();
+  // The client remembers it after the first frame
+  auto environmentEncoding = LoaderDataFormat::EnvironmentEncoding::Full;
+
+  std::string request;
+  while (std::getline(std::cin, request)) {
+    if (request != LoaderDataServer::QueryRequest) {
+      continue;
+    }
+
+    // The linters only need the layers and the environment, so send those
+    // before loading the runtime, which is usually the slowest part
+    LoaderData data {
+      .mEnvironmentVariablesBeforeLoader = environment,
+      .mIsComplete = false,
+    };
+    QueryLayers(data);
+    WriteFrame(data, environmentEncoding);
+    environmentEncoding = LoaderDataFormat::EnvironmentEncoding::HashOnly;
+
+    // As in `QueryLoaderDataInCurrentProcess()`, the runtime may change the
+    // environment, and so which layers are enabled
+    QueryExtensions(data);
+    QueryLayers(data);
+    data.mIsComplete = true;
+    WriteFrame(data, environmentEncoding);
+  }
+}
+
 }// namespace FredEmmott::OpenXRLayers
\ No newline at end of file
@@ -3,5 +3,8 @@
 #pragma once
 
 namespace FredEmmott::OpenXRLayers {
+/// Print the loader data as JSON, then exit
 void LoaderDataMain();
+/// Answer requests on stdin until it is closed; see `LoaderDataServer`
+void LoaderDataServerMain();
 }
@@ -0,0 +1,646 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#include "LoaderDataService.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <format>
+#include <functional>
+#include <future>
+#include <ranges>
+#include <stdexcept>
+#include <vector>
+
+#include "LoaderDataFormat.hpp"
+
+namespace FredEmmott::OpenXRLayers {
+
+std::filesystem::path LoaderDataSpawner::GetHelperFileName(
+  const Architecture arch) {
+  return std::format("openxr-loader-data-{}.dll", magic_enum::enum_name(arch));
+}
+
+LoaderDataService::LoaderDataService(
+  std::unique_ptr<LoaderDataSpawner> spawner,
+  std::unique_ptr<LoaderDataCache> cache,
+  const Architectures architectures,
+  const Clock::duration timeout,
+  const Clock::duration debounce,
+  const std::size_t maxConcurrentRuntimeQueries)
+  : mSpawner(std::move(spawner)),
+    mCache(std::move(cache)),
+    mArchitectures(architectures),
+    mTimeout(timeout),
+    mDebounce(debounce),
+    mMaxConcurrentRuntimeQueries(maxConcurrentRuntimeQueries) {
+  const auto pending = std::make_shared<const Result>(
+    std::unexpected {LoaderData::PendingError {}});
+  const auto noRuntimes = std::make_shared<const RuntimeResults>();
+  for (const auto arch: mArchitectures.enumerate()) {
+    mStates.try_emplace(arch);
+    mPublished.try_emplace(arch, pending);
+    mPublishedRuntimes.try_emplace(arch, noRuntimes);
+    mServers.try_emplace(arch);
+  }
+  mThread
+    = std::jthread {std::bind_front(&LoaderDataService::ThreadMain, this)};
+}
+
+LoaderDataService::~LoaderDataService() = default;
+
+LoaderDataService::Result LoaderDataService::Get(
+  const Architecture arch) const {
+  const auto it = mPublished.find(arch);
+  if (it == mPublished.end()) {
+    return std::unexpected {LoaderData::PendingError {}};
+  }
+  return *it->second.load();
+}
+
+LoaderDataService::Result LoaderDataService::Wait(
+  const Architecture arch,
+  const Clock::time_point timeout) {
+  std::unique_lock lock(mMutex);
+  const auto it = mStates.find(arch);
+  if (it != mStates.end()) {
+    const auto& state = it->second;
+    mCondition.wait_until(lock, timeout, [&state] {
+      if (!(state.mResult && state.mResultGeneration == state.mGeneration)) {
+        return false;
+      }
+      const auto& result = *state.mResult;
+      return !result || (*result)->mIsComplete;
+    });
+  }
+  return Get(arch);
+}
+
+std::shared_ptr<const LoaderDataService::RuntimeResults>
+LoaderDataService::GetRuntimes(const Architecture arch) const {
+  const auto it = mPublishedRuntimes.find(arch);
+  if (it == mPublishedRuntimes.end()) {
+    return std::make_shared<const RuntimeResults>();
+  }
+  return it->second.load();
+}
+
+std::shared_ptr<const LoaderDataService::RuntimeResults>
+LoaderDataService::WaitForRuntimes(
+  const Architecture arch,
+  const Clock::time_point timeout) {
+  std::unique_lock lock(mMutex);
+  const auto it = mStates.find(arch);
+  if (it != mStates.end()) {
+    const auto& state = it->second;
+    mCondition.wait_until(lock, timeout, [&state] {
+      return std::ranges::all_of(
+        state.mRuntimes, [&state](const auto& runtime) {
+          return runtime.mResult
+            && runtime.mResultGeneration == state.mRuntimesGeneration;
+        });
+    });
+  }
+  return GetRuntimes(arch);
+}
+
+LoaderDataService::Result LoaderDataService::GetPublishedResult(
+  const std::optional<Result>& result,
+  const bool isRefreshing) {
+  if (result && *result) {
+    const auto& data = **result;
+    if (!isRefreshing) {
+      return data;
+    }
+    auto refreshing = std::make_shared<LoaderData>(*data);
+    refreshing->mIsRefreshing = true;
+    return refreshing;
+  }
+  if (result && !isRefreshing) {
+    return *result;
+  }
+  // Otherwise, don't show an error that may already be fixed
+  return std::unexpected {LoaderData::PendingError {}};
+}
+
+void LoaderDataService::Republish(
+  const Architecture arch,
+  const State& state) {
+  const auto isRefreshing = state.mResultGeneration != state.mGeneration;
+  mPublished.at(arch).store(
+    std::make_shared<const Result>(
+      GetPublishedResult(state.mResult, isRefreshing)));
+}
+
+void LoaderDataService::RepublishRuntimes(
+  const Architecture arch,
+  const State& state) {
+  auto published = std::make_shared<RuntimeResults>();
+  published->reserve(state.mRuntimes.size());
+  for (auto&& runtime: state.mRuntimes) {
+    const auto isRefreshing
+      = runtime.mResultGeneration != state.mRuntimesGeneration;
+    published->push_back({
+      runtime.mRuntime,
+      runtime.mName,
+      GetPublishedResult(runtime.mResult, isRefreshing),
+    });
+  }
+  mPublishedRuntimes.at(arch).store(std::move(published));
+}
+
+void LoaderDataService::Invalidate(const Architectures architectures) {
+  {
+    const std::unique_lock lock(mMutex);
+    for (auto&& [arch, state]: mStates) {
+      if (architectures.contains(arch)) {
+        MarkStale(arch, state);
+      }
+    }
+  }
+  mCondition.notify_all();
+}
+
+void LoaderDataService::MarkStale(const Architecture arch, State& state) {
+  const auto wasCurrent = state.mResultGeneration == state.mGeneration;
+  ++state.mGeneration;
+  // Any in-flight query is now obsolete
+  state.mCancel.request_stop();
+  if (wasCurrent) {
+    Republish(arch, state);
+  }
+  MarkRuntimesStale(arch, state);
+}
+
+void LoaderDataService::MarkRuntimesStale(
+  const Architecture arch,
+  State& state) {
+  const auto wereCurrent
+    = std::ranges::any_of(state.mRuntimes, [&state](const auto& runtime) {
+        return runtime.mResultGeneration == state.mRuntimesGeneration;
+      });
+  ++state.mRuntimesGeneration;
+  state.mRuntimesCancel.request_stop();
+  if (wereCurrent) {
+    RepublishRuntimes(arch, state);
+  }
+  mLastInvalidation = Clock::now();
+}
+
+void LoaderDataService::SetRuntimes(
+  const Architecture arch,
+  RuntimeResults runtimes) {
+  {
+    const std::unique_lock lock(mMutex);
+    const auto it = mStates.find(arch);
+    if (it == mStates.end()) {
+      return;
+    }
+    auto& state = it->second;
+    if (std::ranges::equal(
+          state.mRuntimes,
+          runtimes,
+          {},
+          &State::Runtime::mRuntime,
+          &RuntimeLoaderData::mRuntime)) {
+      return;
+    }
+    state.mRuntimes.clear();
+    for (auto&& runtime: runtimes) {
+      state.mRuntimes.push_back({
+        .mRuntime = std::move(runtime.mRuntime),
+        .mName = std::move(runtime.mName),
+      });
+    }
+    // Also makes any in-flight results for the previous runtimes obsolete
+    MarkRuntimesStale(arch, state);
+    RepublishRuntimes(arch, state);
+  }
+  mCondition.notify_all();
+}
+
+std::vector<Architecture> LoaderDataService::WaitForStaleArchitectures(
+  std::unique_lock<std::mutex>& lock,
+  const std::stop_token token) {
+  const auto getStale = [this] {
+    std::vector<Architecture> ret;
+    for (auto&& [arch, state]: mStates) {
+      if (
+        (state.mQueriedGeneration != state.mGeneration && !state.mInFlight)
+        || state.mQueriedRuntimesGeneration != state.mRuntimesGeneration) {
+        ret.push_back(arch);
+      }
+    }
+    return ret;
+  };
+
+  while (!token.stop_requested()) {
+    auto stale = getStale();
+    if (stale.empty()) {
+      mCondition.wait(
+        lock, token, [&getStale] { return !getStale().empty(); });
+      continue;
+    }
+
+    const auto debounced = mLastInvalidation + mDebounce;
+    if (Clock::now() >= debounced) {
+      return stale;
+    }
+    // Restart the interval if there's another invalidation in the meantime
+    mCondition.wait_until(lock, token, debounced, [&] {
+      return mLastInvalidation + mDebounce != debounced;
+    });
+  }
+  return {};
+}
+
+void LoaderDataService::LoadCache() {
+  for (const auto arch: mArchitectures.enumerate()) {
+    uint64_t generation {};
+    {
+      const std::unique_lock lock(mMutex);
+      generation = mStates.at(arch).mGeneration;
+    }
+
+    const auto fingerprint = LoaderDataCache::GetFingerprint(
+      arch, mSpawner->GetServerFingerprint(arch));
+    auto cached = mCache->Load(arch, fingerprint);
+    if (!cached) {
+      continue;
+    }
+
+    {
+      const std::unique_lock lock(mMutex);
+      auto& state = mStates.at(arch);
+      // If something changed while we were loading, the fingerprint may
+      // already be out of date
+      if (state.mGeneration != generation || state.mResult) {
+        continue;
+      }
+      state.mResult = std::move(cached);
+      state.mResultGeneration = generation;
+      state.mCachedFingerprint = fingerprint;
+      Republish(arch, state);
+    }
+    mCondition.notify_all();
+    mOnUpdateSignal();
+  }
+}
+
+void LoaderDataService::ThreadMain(const std::stop_token token) {
+  if (mCache) {
+    LoadCache();
+  }
+
+  // Each entry uses the corresponding `mServers` entry until it completes
+  std::unordered_map<Architecture, std::future<void>> pending;
+  std::unordered_map<Architecture, std::future<void>> pendingRuntimes;
+
+  while (true) {
+    struct Query {
+      Architecture mArchitecture;
+      // Unset if only the runtimes are stale
+      std::optional<uint64_t> mGeneration;
+      std::stop_token mCancel;
+      // Unset if the runtimes are not stale
+      std::optional<uint64_t> mRuntimesGeneration;
+      std::stop_token mRuntimesCancel;
+      std::vector<std::filesystem::path> mRuntimes;
+    };
+    std::vector<Query> queries;
+    {
+      std::unique_lock lock(mMutex);
+      for (const auto arch: WaitForStaleArchitectures(lock, token)) {
+        auto& state = mStates.at(arch);
+        auto& query = queries.emplace_back(arch);
+        if (state.mQueriedGeneration != state.mGeneration && !state.mInFlight) {
+          state.mQueriedGeneration = state.mGeneration;
+          state.mInFlight = true;
+          state.mCancel = {};
+          query.mGeneration = state.mGeneration;
+          query.mCancel = state.mCancel.get_token();
+        }
+        if (state.mQueriedRuntimesGeneration != state.mRuntimesGeneration) {
+          state.mQueriedRuntimesGeneration = state.mRuntimesGeneration;
+          state.mRuntimesCancel = {};
+          query.mRuntimesGeneration = state.mRuntimesGeneration;
+          query.mRuntimesCancel = state.mRuntimesCancel.get_token();
+          query.mRuntimes = state.mRuntimes
+            | std::views::transform(&State::Runtime::mRuntime)
+            | std::ranges::to<std::vector>();
+        }
+      }
+      if (token.stop_requested()) {
+        for (auto&& state: mStates | std::views::values) {
+          state.mCancel.request_stop();
+          state.mRuntimesCancel.request_stop();
+        }
+        break;
+      }
+    }
+
+    const auto deadline = Clock::now() + mTimeout;
+    for (auto&& query: queries) {
+      const auto arch = query.mArchitecture;
+      if (query.mRuntimesGeneration) {
+        // If the previous batch is still running, it has been cancelled
+        if (auto it = pendingRuntimes.find(arch); it != pendingRuntimes.end()) {
+          it->second.get();
+          pendingRuntimes.erase(it);
+        }
+        if (!query.mRuntimes.empty()) {
+          pendingRuntimes.emplace(
+            arch,
+            std::async(
+              std::launch::async,
+              &LoaderDataService::QueryRuntimes,
+              this,
+              *query.mRuntimesGeneration,
+              arch,
+              std::move(query.mRuntimes),
+              query.mRuntimesCancel));
+        }
+      }
+
+      if (!query.mGeneration) {
+        continue;
+      }
+      const auto generation = *query.mGeneration;
+      // The previous query has already been published, but its thread may
+      // not have quite finished
+      if (auto it = pending.find(arch); it != pending.end()) {
+        it->second.get();
+        pending.erase(it);
+      }
+
+      auto& server = mServers.at(arch);
+      const auto fingerprint = mSpawner->GetServerFingerprint(arch);
+      const auto cacheFingerprint
+        = mCache ? LoaderDataCache::GetFingerprint(arch, fingerprint) : 0;
+      if (server.mServer && server.mFingerprint != fingerprint) {
+        server.mServer.reset();
+      }
+      if (!server.mServer) {
+        // Spawn one at a time, so the helpers don't inherit each other's
+        // pipes
+        const std::unique_lock spawnLock(mSpawnMutex);
+        auto spawned = mSpawner->SpawnServer(arch, std::nullopt);
+        if (!spawned) {
+          Publish(
+            generation,
+            arch,
+            std::unexpected {std::move(spawned).error()},
+            cacheFingerprint);
+          continue;
+        }
+        server = {std::move(*spawned), fingerprint};
+      }
+      // Query each on its own thread, so a slow helper does not delay the
+      // others' results
+      auto future = std::async(
+        std::launch::async,
+        [=, this, &server, cancel = query.mCancel] {
+          const auto onPartial = [=, this](auto data) {
+            this->PublishPartial(generation, arch, std::move(data));
+          };
+          this->Publish(
+            generation,
+            arch,
+            Collect(arch, server, deadline, cancel, onPartial),
+            cacheFingerprint);
+        });
+      pending.emplace(arch, std::move(future));
+    }
+  }
+
+  for (auto&& future: pending | std::views::values) {
+    future.get();
+  }
+  for (auto&& future: pendingRuntimes | std::views::values) {
+    future.get();
+  }
+}
+
+LoaderDataService::Result LoaderDataService::Collect(
+  const Architecture arch,
+  Server& server,
+  const Clock::time_point deadline,
+  const std::stop_token cancel,
+  const std::function<void(std::shared_ptr<const LoaderData>)>& onPartial) {
+  const auto fail = [&server](LoaderData::Error error) -> Result {
+    // Start a new one next time
+    server.mServer.reset();
+    server.mEnvironment.reset();
+    server.mPendingResponses = 0;
+    return std::unexpected {std::move(error)};
+  };
+
+  if (const auto sent = server.mServer->SendQuery(); !sent) {
+    return fail(sent.error());
+  }
+  ++server.mPendingResponses;
+
+  while (true) {
+    const auto output = server.mServer->ReadResponse(deadline, cancel);
+    if (!output) {
+      if (holds_alternative<LoaderData::PendingError>(output.error())) {
+        // Cancelled; keep the helper, as it is still responding
+        return std::unexpected {output.error()};
+      }
+      return fail(output.error());
+    }
+
+    auto decoded = LoaderDataFormat::Decode(
+      *output, server.mEnvironment ? &*server.mEnvironment : nullptr);
+    if (!decoded) {
+      // We may be out of sync with the helper's output
+      return fail(std::move(decoded).error());
+    }
+    auto ret = std::make_shared<LoaderData>(std::move(*decoded));
+    if (!server.mEnvironment) {
+      server.mEnvironment = ret->mEnvironmentVariablesBeforeLoader;
+    }
+#ifndef NDEBUG
+    if (ret->mArchitecture != arch) [[unlikely]] {
+      throw std::runtime_error(
+        fmt::format(
+          "Architecture mismatch on loader data - got {}, expected {}",
+          magic_enum::enum_name(ret->mArchitecture),
+          magic_enum::enum_name(arch)));
+    }
+#endif
+    // Skip what's left of any cancelled queries' responses
+    if (ret->mIsComplete) {
+      if (--server.mPendingResponses == 0) {
+        return ret;
+      }
+    } else if (server.mPendingResponses == 1) {
+      onPartial(std::move(ret));
+    }
+  }
+}
+
+void LoaderDataService::PublishPartial(
+  const uint64_t generation,
+  const Architecture arch,
+  std::shared_ptr<const LoaderData> data) {
+  {
+    const std::unique_lock lock(mMutex);
+    auto& state = mStates.at(arch);
+    // Keep the previous result if it is already up to date, e.g. from the
+    // cache
+    if (
+      generation != state.mGeneration
+      || state.mResultGeneration == generation) {
+      return;
+    }
+    // The layers and environment are current, but listing the extensions
+    // needs the runtime, so keep the previous ones until the second phase
+    if (state.mResult && *state.mResult) {
+      const auto& previous = **state.mResult;
+      auto merged = std::make_shared<LoaderData>(*previous);
+      merged->mQueryLayersResult = data->mQueryLayersResult;
+      merged->mEnabledLayerNames = data->mEnabledLayerNames;
+      merged->mEnvironmentVariablesBeforeLoader
+        = data->mEnvironmentVariablesBeforeLoader;
+      merged->mIsComplete = false;
+      merged->mIsRefreshing = false;
+      data = std::move(merged);
+    }
+    state.mResult = std::move(data);
+    state.mResultGeneration = generation;
+    state.mCachedFingerprint = std::nullopt;
+    Republish(arch, state);
+  }
+  mCondition.notify_all();
+  mOnUpdateSignal();
+}
+
+void LoaderDataService::Publish(
+  const uint64_t generation,
+  const Architecture arch,
+  Result result,
+  const std::size_t cacheFingerprint) {
+  bool changed = false;
+  bool save = false;
+  {
+    const std::unique_lock lock(mMutex);
+    auto& state = mStates.at(arch);
+    state.mInFlight = false;
+    // Otherwise, there is a newer query to come; keep the previous result
+    // until then
+    if (generation == state.mGeneration) {
+      const auto wasRefreshing = state.mResultGeneration != generation;
+      const auto isSame = result && state.mResult && *state.mResult
+        && **result == ***state.mResult;
+      changed = wasRefreshing || !isSame;
+      save = mCache && result
+        && !(isSame && state.mCachedFingerprint == cacheFingerprint);
+
+      // Keep the existing pointer if the data is the same, so readers holding
+      // it are not left with a duplicate
+      if (!isSame) {
+        state.mResult = std::move(result);
+        state.mCachedFingerprint = std::nullopt;
+      }
+      state.mResultGeneration = generation;
+      if (changed) {
+        Republish(arch, state);
+      }
+      if (save) {
+        state.mCachedFingerprint = cacheFingerprint;
+        // Copy the pointer so we can save after releasing the lock
+        result = *state.mResult;
+      }
+    }
+  }
+  // Wake up the thread even if the result is obsolete, as the architecture
+  // can now be queried again
+  mCondition.notify_all();
+  if (save) {
+    mCache->Store(arch, cacheFingerprint, **result);
+  }
+  if (changed) {
+    mOnUpdateSignal();
+  }
+}
+
+void LoaderDataService::QueryRuntimes(
+  const uint64_t generation,
+  const Architecture arch,
+  std::vector<std::filesystem::path> runtimes,
+  const std::stop_token cancel) {
+  std::vector<std::future<void>> queries;
+  for (std::size_t i = 0; i < runtimes.size(); ++i) {
+    queries.push_back(
+      std::async(std::launch::async, [=, this, &runtimes] {
+        this->PublishRuntime(
+          generation, arch, i, QueryRuntime(arch, runtimes.at(i), cancel));
+      }));
+  }
+  for (auto&& query: queries) {
+    query.get();
+  }
+}
+
+LoaderDataService::Result LoaderDataService::QueryRuntime(
+  const Architecture arch,
+  const std::filesystem::path& runtime,
+  const std::stop_token cancel) {
+  {
+    std::unique_lock lock(mMutex);
+    const auto haveSlot = mCondition.wait(lock, cancel, [this] {
+      return mRuntimeQueriesRunning < mMaxConcurrentRuntimeQueries;
+    });
+    if (!haveSlot) {
+      return std::unexpected {LoaderData::PendingError {}};
+    }
+    ++mRuntimeQueriesRunning;
+  }
+
+  Result ret {std::unexpected {LoaderData::PendingError {}}};
+  {
+    std::unique_lock spawnLock(mSpawnMutex);
+    auto spawned = mSpawner->SpawnServer(arch, runtime);
+    spawnLock.unlock();
+    if (spawned) {
+      // Not kept, as each of these has loaded a different runtime
+      Server server {std::move(*spawned)};
+      ret = Collect(
+        arch, server, Clock::now() + mTimeout, cancel, [](auto&&) {});
+    } else {
+      ret = std::unexpected {std::move(spawned).error()};
+    }
+  }
+
+  {
+    const std::unique_lock lock(mMutex);
+    --mRuntimeQueriesRunning;
+  }
+  mCondition.notify_all();
+  return ret;
+}
+
+void LoaderDataService::PublishRuntime(
+  const uint64_t generation,
+  const Architecture arch,
+  const std::size_t index,
+  Result result) {
+  {
+    const std::unique_lock lock(mMutex);
+    auto& state = mStates.at(arch);
+    // `SetRuntimes()` also increments the generation, so `index` is still
+    // valid if this matches
+    if (generation != state.mRuntimesGeneration) {
+      return;
+    }
+    auto& runtime = state.mRuntimes.at(index);
+    runtime.mResult = std::move(result);
+    runtime.mResultGeneration = generation;
+    RepublishRuntimes(arch, state);
+  }
+  mCondition.notify_all();
+  mOnUpdateSignal();
+}
+
+}// namespace FredEmmott::OpenXRLayers
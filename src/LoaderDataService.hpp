@@ -0,0 +1,351 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <boost/signals2.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Architectures.hpp"
+#include "LoaderData.hpp"
+#include "LoaderDataCache.hpp"
+
+namespace FredEmmott::OpenXRLayers {
+
+/** A `loader-data` helper running in server mode.
+ *
+ * Each request is the line `query`. The helper responds with two frames, as
+ * described in `LoaderDataFormat`:
+ *
+ * 1. the enabled layers and the environment, without loading the runtime;
+ *    `LoaderData::mIsComplete` is false
+ * 2. everything, including the available extensions. Listing those loads the
+ *    runtime, which is usually the slowest part, and which may modify the
+ *    environment, and so which layers are enabled
+ *
+ * The helper exits when its stdin is closed; it is also killed when this is
+ * destroyed.
+ */
+class LoaderDataServer {
+ public:
+  static constexpr std::string_view CommandLineFlag {"--server"};
+  static constexpr std::string_view QueryRequest {"query"};
+
+  virtual ~LoaderDataServer() = default;
+
+  /** Ask the helper to query the loader again.
+   *
+   * If the helper has exited, this returns a `LoaderData::BadExitCodeError`.
+   */
+  [[nodiscard]]
+  virtual std::expected<void, LoaderData::Error> SendQuery() = 0;
+
+  /** Wait for the next response frame, and return its payload.
+   *
+   * If the helper does not respond by `deadline`, it is killed, and this
+   * returns a `LoaderData::TimeoutError`. If it exits, this returns a
+   * `LoaderData::BadExitCodeError`.
+   *
+   * If `cancel` is triggered first, this returns a `LoaderData::PendingError`,
+   * and the helper keeps running; the server can still be used, and the next
+   * call continues reading the same response.
+   *
+   * The server can not be used again after any other error.
+   */
+  [[nodiscard]]
+  virtual std::expected<std::string, LoaderData::Error> ReadResponse(
+    std::chrono::steady_clock::time_point deadline,
+    std::stop_token cancel)
+    = 0;
+};
+
+/// Starts `loader-data` helpers; implemented by each platform
+class LoaderDataSpawner {
+ public:
+  virtual ~LoaderDataSpawner() = default;
+
+  /** If `runtime` is set, the helper uses that runtime manifest instead of
+   * the active runtime, via `XR_RUNTIME_JSON`.
+   *
+   * This may be called from any thread, but not concurrently.
+   */
+  [[nodiscard]]
+  virtual std::expected<std::unique_ptr<LoaderDataServer>, LoaderData::Error>
+  SpawnServer(
+    Architecture,
+    const std::optional<std::filesystem::path>& runtime)
+    = 0;
+
+  /** Identifies the state a server depends on, e.g. its environment, the
+   * active runtime, and the helper itself.
+   *
+   * Servers are restarted when this changes; everything else - e.g. layers
+   * being added, removed, or toggled - is picked up by querying again.
+   */
+  [[nodiscard]]
+  virtual std::size_t GetServerFingerprint(Architecture) = 0;
+
+  /// e.g. `openxr-loader-data-x64.dll`
+  [[nodiscard]]
+  static std::filesystem::path GetHelperFileName(Architecture);
+};
+
+/** Queries the `loader-data` helpers in the background, and caches the
+ * results.
+ *
+ * There is a long-lived helper per architecture, so a refresh does not need
+ * to pay for process creation, helper verification, or loading the runtime.
+ * The helpers are queried concurrently, and each result is available as soon
+ * as its helper responds. Helpers that take longer than the timeout are
+ * killed, and restarted for the next refresh.
+ *
+ * Invalidations only affect the specified architectures, and are debounced,
+ * so a burst of changes leads to a single refresh. If a query is in flight
+ * when its architecture is invalidated again, it is cancelled; the helper is
+ * kept, and the rest of its response is skipped by the next query.
+ *
+ * While an architecture is being refreshed, its previous data is still
+ * returned, with `LoaderData::mIsRefreshing` set. The first phase of the
+ * helper's response replaces it as soon as it is available, with
+ * `LoaderData::mIsComplete` unset; the extensions and the runtime's changes
+ * to the environment are kept from the previous data, if any, until the
+ * second phase.
+ *
+ * Results are published as immutable snapshots that are swapped atomically,
+ * so readers never wait for the service's lock or copy the data.
+ *
+ * If there is a `LoaderDataCache`, results are saved to it, and matching
+ * results from a previous launch are used until the helpers respond; they
+ * are only replaced - and `OnUpdate()` is only invoked - if the helpers'
+ * results differ.
+ *
+ * Other runtimes can also be queried, with `SetRuntimes()`; each of these
+ * loads a runtime, so they use short-lived helpers, and only a limited number
+ * run at once.
+ *
+ * Spawning is platform-specific, e.g. the Windows helpers need to be
+ * de-elevated; see `LoaderDataSpawner`.
+ */
+class LoaderDataService final {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  /// `cache` may be null
+  LoaderDataService(
+    std::unique_ptr<LoaderDataSpawner>,
+    std::unique_ptr<LoaderDataCache> cache,
+    Architectures,
+    Clock::duration timeout,
+    Clock::duration debounce,
+    std::size_t maxConcurrentRuntimeQueries);
+  ~LoaderDataService();
+
+  LoaderDataService(const LoaderDataService&) = delete;
+  LoaderDataService(LoaderDataService&&) = delete;
+  LoaderDataService& operator=(const LoaderDataService&) = delete;
+  LoaderDataService& operator=(LoaderDataService&&) = delete;
+
+  using Result
+    = std::expected<std::shared_ptr<const LoaderData>, LoaderData::Error>;
+
+  /** The latest data, even if it is being refreshed.
+   *
+   * `LoaderData::PendingError` if there is no data yet, or if the previous
+   * attempt failed and is being retried.
+   *
+   * Lock-free; this does not wait for the service's threads.
+   */
+  [[nodiscard]]
+  Result Get(Architecture) const;
+  /** Wait for up-to-date, complete data.
+   *
+   * If `timeout` passes first, same as `Get()`.
+   */
+  [[nodiscard]]
+  Result Wait(Architecture, Clock::time_point timeout);
+
+  /// Query the helpers for these architectures again
+  void Invalidate(Architectures);
+
+  using RuntimeResults = std::vector<RuntimeLoaderData>;
+  /** Also query the loader with each of these runtimes.
+   *
+   * Each is queried by its own helper, with `XR_RUNTIME_JSON` set to
+   * `RuntimeLoaderData::mRuntime`; `mResult` is ignored. From then on, they
+   * are queried again whenever the architecture is invalidated.
+   *
+   * Does nothing if the runtimes have not changed. Otherwise, this does not
+   * affect the main query, or its helper; only the runtimes are queried.
+   */
+  void SetRuntimes(Architecture, RuntimeResults);
+  /** Like `Get()`, for each runtime passed to `SetRuntimes()`.
+   *
+   * Each is a complete result; the first phase of the helpers' responses is
+   * not used.
+   */
+  [[nodiscard]]
+  std::shared_ptr<const RuntimeResults> GetRuntimes(Architecture) const;
+  /// Like `Wait()`, for every runtime passed to `SetRuntimes()`
+  [[nodiscard]]
+  std::shared_ptr<const RuntimeResults> WaitForRuntimes(
+    Architecture,
+    Clock::time_point timeout);
+
+  /// Invoked on the service's threads whenever a result is available
+  boost::signals2::scoped_connection OnUpdate(
+    std::function<void()> callback) noexcept {
+    return mOnUpdateSignal.connect(std::move(callback));
+  }
+
+ private:
+  struct State {
+    // Incremented by `Invalidate()`
+    uint64_t mGeneration {1};
+    // The generation of the most recent query
+    uint64_t mQueriedGeneration {};
+    bool mInFlight {false};
+    std::stop_source mCancel;
+
+    std::optional<Result> mResult;
+    uint64_t mResultGeneration {};
+    // The fingerprint of `mResult` in `mCache`, if it has been saved
+    std::optional<std::size_t> mCachedFingerprint;
+
+    struct Runtime {
+      std::filesystem::path mRuntime;
+      std::string mName;
+      std::optional<Result> mResult;
+      // Compared to `mRuntimesGeneration`
+      uint64_t mResultGeneration {};
+    };
+    // From `SetRuntimes()`
+    std::vector<Runtime> mRuntimes;
+    // Incremented by `Invalidate()` and `SetRuntimes()`; tracked separately
+    // so that changing the runtimes does not restart the main query
+    uint64_t mRuntimesGeneration {1};
+    // The generation of the most recent batch of runtime queries
+    uint64_t mQueriedRuntimesGeneration {};
+    std::stop_source mRuntimesCancel;
+  };
+
+  const std::unique_ptr<LoaderDataSpawner> mSpawner;
+  const std::unique_ptr<LoaderDataCache> mCache;
+  const Architectures mArchitectures;
+  const Clock::duration mTimeout;
+  const Clock::duration mDebounce;
+  const std::size_t mMaxConcurrentRuntimeQueries;
+
+  // `LoaderDataSpawner::SpawnServer()` must not be called concurrently
+  std::mutex mSpawnMutex;
+
+  std::mutex mMutex;
+  std::condition_variable_any mCondition;
+  // Not modified after construction, other than the values
+  std::unordered_map<Architecture, State> mStates;
+  // What `Get()` returns; only stored while holding `mMutex`, but loaded
+  // without it. Not modified after construction, other than the values
+  std::unordered_map<Architecture, std::atomic<std::shared_ptr<const Result>>>
+    mPublished;
+  // What `GetRuntimes()` returns; as `mPublished`
+  std::unordered_map<
+    Architecture,
+    std::atomic<std::shared_ptr<const RuntimeResults>>>
+    mPublishedRuntimes;
+  Clock::time_point mLastInvalidation {};
+  // Helpers started for `SetRuntimes()` that have not exited yet
+  std::size_t mRuntimeQueriesRunning {};
+
+  boost::signals2::signal<void()> mOnUpdateSignal;
+
+  struct Server {
+    std::unique_ptr<LoaderDataServer> mServer;
+    std::size_t mFingerprint {};
+    // From the server's first frame; later frames only include its hash
+    std::optional<Environment> mEnvironment;
+    // Queries whose complete frame has not been read yet. Only the last one
+    // is current; the others were cancelled, and their frames are skipped
+    std::size_t mPendingResponses {};
+  };
+  // Not modified after construction, other than the values. Only used by the
+  // service's threads, and each entry is only used by one thread at a time
+  std::unordered_map<Architecture, Server> mServers;
+
+  // Last, so it is stopped before anything else is destroyed
+  std::jthread mThread;
+
+  /// What to publish for a result
+  [[nodiscard]]
+  static Result GetPublishedResult(
+    const std::optional<Result>&,
+    bool isRefreshing);
+  /// Update `mPublished` from `mStates`; requires `mMutex`
+  void Republish(Architecture, const State&);
+  /// Start a new generation, including the runtimes; requires `mMutex`
+  void MarkStale(Architecture, State&);
+  /// Start a new generation of just the runtimes; requires `mMutex`
+  void MarkRuntimesStale(Architecture, State&);
+  /// Update `mPublishedRuntimes` from `mStates`; requires `mMutex`
+  void RepublishRuntimes(Architecture, const State&);
+
+  void ThreadMain(std::stop_token);
+  /// Publish any matching results from `mCache`
+  void LoadCache();
+  /// Architectures that need querying, once the debounce interval has passed
+  [[nodiscard]]
+  std::vector<Architecture> WaitForStaleArchitectures(
+    std::unique_lock<std::mutex>&,
+    std::stop_token);
+  /// Passes the first phase to `onPartial`, and returns the complete result
+  [[nodiscard]]
+  Result Collect(
+    Architecture,
+    Server&,
+    Clock::time_point deadline,
+    std::stop_token cancel,
+    const std::function<void(std::shared_ptr<const LoaderData>)>& onPartial);
+  void PublishPartial(
+    uint64_t generation,
+    Architecture,
+    std::shared_ptr<const LoaderData>);
+  void Publish(
+    uint64_t generation,
+    Architecture,
+    Result,
+    std::size_t cacheFingerprint);
+
+  /// Query and publish each runtime, concurrently
+  void QueryRuntimes(
+    uint64_t generation,
+    Architecture,
+    std::vector<std::filesystem::path> runtimes,
+    std::stop_token cancel);
+  /// Waits until fewer than `mMaxConcurrentRuntimeQueries` are running
+  [[nodiscard]]
+  Result QueryRuntime(
+    Architecture,
+    const std::filesystem::path& runtime,
+    std::stop_token cancel);
+  void PublishRuntime(
+    uint64_t generation,
+    Architecture,
+    std::size_t index,
+    Result);
+};
+
+}// namespace FredEmmott::OpenXRLayers
@@ -2,12 +2,28 @@
 // SPDX-License-Identifier: MIT
 #include "OverridePathsAPILayerStore.hpp"
 
+#include <future>
+#include <optional>
 #include <ranges>
+#include <unordered_set>
 
 namespace FredEmmott::OpenXRLayers {
 
 OverridePathsAPILayerStore::OverridePathsAPILayerStore(Platform& platform)
-  : mPlatform {platform} {}
+  : mPlatform {platform} {
+  const auto dirs = mPlatform.GetOverridePaths();
+  if (!dirs) {
+    return;
+  }
+  for (auto&& dir: *dirs) {
+    std::error_code ec;
+    if (!std::filesystem::is_directory(dir, ec)) {
+      continue;
+    }
+    mWatchers.push_back(mPlatform.WatchDirectory(
+      dir, [this](const std::filesystem::path&) { this->NotifyChange(); }));
+  }
+}
 
 OverridePathsAPILayerStore::~OverridePathsAPILayerStore() = default;
 
@@ -22,32 +38,34 @@ std::vector<APILayer> OverridePathsAPILayerStore::GetAPILayers()
   const noexcept {
   const auto dirs = mPlatform.GetOverridePaths();
   if ((!dirs) || dirs->empty()) {
+    const std::unique_lock lock(mCacheMutex);
+    mScanErrors.clear();
     return {};
   }
   std::unordered_set<std::string> enabledLayers;
   enabledLayers.insert_range(mPlatform.GetEnabledExplicitAPILayers());
 
+  const auto scans = Scan(*dirs);
+  std::vector<ScanError> errors;
+  for (auto&& [dir, scan]: std::views::zip(*dirs, scans)) {
+    if (scan.mError) {
+      errors.push_back({dir, scan.mError});
+    }
+  }
+  {
+    const std::unique_lock lock(mCacheMutex);
+    mScanErrors = std::move(errors);
+  }
+
   std::vector<APILayer> ret;
 
-  for (auto&& dir: *dirs) {
-    for (auto&& path: std::filesystem::directory_iterator(dir)) {
-      if (!path.is_regular_file()) {
-        continue;
-      }
-      // As of 2026-02-01, this case-sensitive check is the same as the OpenXR
-      // loader:
-      // https://github.com/KhronosGroup/OpenXR-SDK-Source/blob/21714cf0ec46c67f2597d467a34a9004dbf380aa/src/loader/manifest_file.cpp#L80
-      if (path.path().extension() != ".json") {
-        continue;
-      }
-      ret.emplace_back(this, path.path(), APILayer::Value::Disabled);
+  for (auto&& scan: scans) {
+    for (auto&& manifest: scan.mManifests) {
+      ret.emplace_back(this, manifest.mPath, APILayer::Value::Disabled);
       auto& it = ret.back();
-      const APILayerDetails details(it.mManifestPath);
+      it.mArchitectures = manifest.mArchitectures;
 
-      it.mArchitectures
-        = mPlatform.GetSharedLibraryArchitectures(details.mLibraryPath);
-
-      if (enabledLayers.contains(details.mName)) {
+      if (enabledLayers.contains(manifest.mName)) {
         it.mValue = APILayer::Value::Enabled;
       }
     }
@@ -60,4 +78,141 @@ Architectures OverridePathsAPILayerStore::GetArchitectures() const noexcept {
   return mPlatform.GetArchitectures();
 }
 
-}// namespace FredEmmott::OpenXRLayers
\ No newline at end of file
+std::vector<OverridePathsAPILayerStore::ScanError>
+OverridePathsAPILayerStore::GetScanErrors() const noexcept {
+  const std::unique_lock lock(mCacheMutex);
+  return mScanErrors;
+}
+
+std::vector<OverridePathsAPILayerStore::DirectoryScan>
+OverridePathsAPILayerStore::Scan(
+  const std::vector<std::filesystem::path>& dirs) const {
+  // Copied so that the scans don't need to hold the lock
+  std::vector<std::optional<DirectoryScan>> previous;
+  previous.reserve(dirs.size());
+  {
+    const std::unique_lock lock(mCacheMutex);
+    for (auto&& dir: dirs) {
+      const auto it = mCache.find(dir);
+      if (it == mCache.end()) {
+        previous.emplace_back(std::nullopt);
+      } else {
+        previous.emplace_back(it->second);
+      }
+    }
+  }
+
+  auto scanOne = [this, &dirs, &previous](const std::size_t i) {
+    return Scan(dirs.at(i), previous.at(i) ? &*previous.at(i) : nullptr);
+  };
+
+  std::vector<DirectoryScan> ret;
+  ret.reserve(dirs.size());
+  if (dirs.size() == 1) {
+    ret.push_back(scanOne(0));
+  } else {
+    std::vector<std::future<DirectoryScan>> futures;
+    futures.reserve(dirs.size());
+    for (std::size_t i = 0; i < dirs.size(); ++i) {
+      futures.push_back(std::async(std::launch::async, scanOne, i));
+    }
+    for (auto&& future: futures) {
+      ret.push_back(future.get());
+    }
+  }
+
+  const std::unique_lock lock(mCacheMutex);
+  for (auto&& [dir, scan]: std::views::zip(dirs, ret)) {
+    mCache.insert_or_assign(dir, scan);
+  }
+  return ret;
+}
+
+OverridePathsAPILayerStore::DirectoryScan OverridePathsAPILayerStore::Scan(
+  const std::filesystem::path& dir,
+  const DirectoryScan* const previous) const {
+  DirectoryScan ret;
+  // The loader ignores empty entries, e.g. from a trailing `;`
+  if (dir.empty()) {
+    return ret;
+  }
+
+  const auto status = std::filesystem::status(dir, ret.mError);
+  if (ret.mError) {
+    return ret;
+  }
+  if (!std::filesystem::is_directory(status)) {
+    ret.mError = std::make_error_code(
+      std::filesystem::exists(status) ? std::errc::not_a_directory
+                                      : std::errc::no_such_file_or_directory);
+    return ret;
+  }
+
+  // Adding, removing, or renaming a file changes the directory's change time,
+  // but modifying a file does not, so the manifests are checked separately
+  ret.mChangeTime = mPlatform.GetFileChangeTime(dir);
+  if (
+    previous && (!previous->mError)
+    && previous->mChangeTime == ret.mChangeTime) {
+    ret.mManifests.reserve(previous->mManifests.size());
+    for (auto&& manifest: previous->mManifests) {
+      ret.mManifests.push_back(Load(manifest.mPath, &manifest));
+    }
+    return ret;
+  }
+
+  std::unordered_map<std::filesystem::path, const Manifest*> previousManifests;
+  if (previous) {
+    for (auto&& manifest: previous->mManifests) {
+      previousManifests.emplace(manifest.mPath, &manifest);
+    }
+  }
+
+  std::filesystem::directory_iterator it(dir, ret.mError);
+  for (; (!ret.mError) && it != std::filesystem::directory_iterator {};
+       it.increment(ret.mError)) {
+    std::error_code ec;
+    if (!it->is_regular_file(ec)) {
+      continue;
+    }
+    const auto& path = it->path();
+    // As of 2026-02-01, this case-sensitive check is the same as the OpenXR
+    // loader:
+    // https://github.com/KhronosGroup/OpenXR-SDK-Source/blob/21714cf0ec46c67f2597d467a34a9004dbf380aa/src/loader/manifest_file.cpp#L80
+    if (path.extension() != ".json") {
+      continue;
+    }
+    const auto cached = previousManifests.find(path);
+    ret.mManifests.push_back(Load(
+      path,
+      (cached == previousManifests.end()) ? nullptr : cached->second));
+  }
+  return ret;
+}
+
+OverridePathsAPILayerStore::Manifest OverridePathsAPILayerStore::Load(
+  const std::filesystem::path& path,
+  const Manifest* const previous) const {
+  // Read before parsing, so a change during parsing invalidates the cache
+  const auto manifestChangeTime = mPlatform.GetFileChangeTime(path);
+  if (
+    previous && previous->mManifestChangeTime == manifestChangeTime
+    && (previous->mLibraryPath.empty()
+        || previous->mLibraryChangeTime
+          == mPlatform.GetFileChangeTime(previous->mLibraryPath))) {
+    return *previous;
+  }
+
+  const APILayerDetails details(path);
+  return {
+    .mPath = path,
+    .mManifestChangeTime = manifestChangeTime,
+    .mLibraryChangeTime = details.mLibraryFilesystemChangeTime,
+    .mName = details.mName,
+    .mLibraryPath = details.mLibraryPath,
+    .mArchitectures
+    = mPlatform.GetSharedLibraryArchitectures(details.mLibraryPath),
+  };
+}
+
+}// namespace FredEmmott::OpenXRLayers
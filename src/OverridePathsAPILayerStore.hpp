@@ -2,13 +2,30 @@
 // SPDX-License-Identifier: MIT
 #pragma once
 
+#include <filesystem>
+#include <mutex>
+#include <system_error>
+#include <unordered_map>
+
 #include "APILayerStore.hpp"
 #include "Platform.hpp"
+#include "portability/filesystem.hpp"
 
 namespace FredEmmott::OpenXRLayers {
 
+/** Layers in the directories listed in `XR_API_LAYER_PATH`.
+ *
+ * Directory scans are cached by the directory's change time, and the parts of
+ * each manifest we need are cached by the manifest's and library's change
+ * times, so repeated queries only need to check the timestamps.
+ */
 class OverridePathsAPILayerStore : public virtual APILayerStore {
  public:
+  struct ScanError {
+    std::filesystem::path mPath;
+    std::error_code mError;
+  };
+
   OverridePathsAPILayerStore() = delete;
   explicit OverridePathsAPILayerStore(Platform& platform);
   ~OverridePathsAPILayerStore() override;
@@ -18,7 +35,43 @@ class OverridePathsAPILayerStore : public virtual APILayerStore {
   std::vector<APILayer> GetAPILayers() const noexcept override;
   Architectures GetArchitectures() const noexcept override;
 
+  /** Directories in `XR_API_LAYER_PATH` that could not be read.
+   *
+   * From the most recent `GetAPILayers()`; this does not scan them again.
+   */
+  [[nodiscard]]
+  std::vector<ScanError> GetScanErrors() const noexcept;
+
  private:
+  struct Manifest {
+    std::filesystem::path mPath;
+    std::filesystem::file_time_type mManifestChangeTime;
+    std::filesystem::file_time_type mLibraryChangeTime;
+
+    std::string mName;
+    std::filesystem::path mLibraryPath;
+    Architectures mArchitectures;
+  };
+  struct DirectoryScan {
+    std::filesystem::file_time_type mChangeTime;
+    std::error_code mError;
+    /// In directory order
+    std::vector<Manifest> mManifests;
+  };
+
   Platform& mPlatform;
+  std::vector<std::unique_ptr<DirectoryWatcher>> mWatchers;
+
+  mutable std::mutex mCacheMutex;
+  mutable std::unordered_map<std::filesystem::path, DirectoryScan> mCache;
+  mutable std::vector<ScanError> mScanErrors;
+
+  /// Scan each directory, in parallel if there's more than one
+  std::vector<DirectoryScan> Scan(
+    const std::vector<std::filesystem::path>& dirs) const;
+  DirectoryScan Scan(
+    const std::filesystem::path& dir,
+    const DirectoryScan* previous) const;
+  Manifest Load(const std::filesystem::path&, const Manifest* previous) const;
 };
 }// namespace FredEmmott::OpenXRLayers
@@ -6,11 +6,11 @@
 #include <expected>
 #include <filesystem>
 #include <functional>
+#include <memory>
 #include <optional>
+#include <span>
 #include <unordered_set>
 
-#include <imgui.h>
-
 #include "APILayerSignature.hpp"
 #include "Architectures.hpp"
 #include "LoaderData.hpp"
@@ -19,11 +19,6 @@ namespace FredEmmott::OpenXRLayers {
 class APILayerStore;
 class ReadWriteAPILayerStore;
 
-struct DPIChangeInfo {
-  float mDPIScaling {};
-  std::optional<ImVec2> mRecommendedSize;
-};
-
 struct Runtime {
   struct ManifestData {
     enum class Error {
@@ -59,6 +54,20 @@ struct AvailableRuntime : Runtime {
   Discoverability mDiscoverability;
 };
 
+/// Stops watching the directory when destroyed
+class DirectoryWatcher {
+ public:
+  virtual ~DirectoryWatcher() = default;
+};
+
+/// A read-only view of a file's contents; unmapped when destroyed
+class MappedFile {
+ public:
+  virtual ~MappedFile() = default;
+  [[nodiscard]]
+  virtual std::span<const std::byte> GetData() const noexcept = 0;
+};
+
 // Platform-specific functions implemented in PlatformGUI_P*.cpp
 class Platform {
  public:
@@ -66,6 +75,11 @@ class Platform {
   virtual ~Platform();
 
   virtual void GUIMain(std::function<void()> drawFrame) = 0;
+  /** Draw another frame by `when`, even if there is no input.
+   *
+   * Should be called from `drawFrame`.
+   */
+  virtual void RequestFrame(std::chrono::steady_clock::time_point when) = 0;
 
   /// Unlike `std::filesystem::last_write_time()`, this should
   /// return the actual time the file was modified on disk, e.g. when it
@@ -75,9 +89,25 @@ class Platform {
 
   virtual std::expected<APILayerSignature, APILayerSignature::Error>
   GetSharedLibrarySignature(const std::filesystem::path&) = 0;
-  virtual std::expected<LoaderData, LoaderData::Error> GetLoaderData(
-    Architecture) = 0;
-  virtual std::expected<LoaderData, LoaderData::Error> WaitForLoaderData(
+  /// Does not block or copy; safe to call every frame
+  virtual std::expected<std::shared_ptr<const LoaderData>, LoaderData::Error>
+  GetLoaderData(Architecture) = 0;
+  virtual std::expected<std::shared_ptr<const LoaderData>, LoaderData::Error>
+  WaitForLoaderData(
+    Architecture,
+    std::chrono::steady_clock::time_point timeout) = 0;
+  /** Also query the loader with each of `GetAvailableRuntimes()`, instead of
+   * only the active runtime.
+   *
+   * From then on, these are kept up to date like `GetLoaderData()`, and
+   * `OnLoaderData()` is also invoked when they change.
+   */
+  virtual void QueryAvailableRuntimes() = 0;
+  /// Does not block or copy; empty until `QueryAvailableRuntimes()`
+  virtual std::shared_ptr<const std::vector<RuntimeLoaderData>>
+  GetAvailableRuntimesLoaderData(Architecture) = 0;
+  virtual std::shared_ptr<const std::vector<RuntimeLoaderData>>
+  WaitForAvailableRuntimesLoaderData(
     Architecture,
     std::chrono::steady_clock::time_point timeout) = 0;
   virtual std::vector<std::filesystem::path> GetNewAPILayerJSONPaths() = 0;
@@ -86,6 +116,23 @@ class Platform {
   virtual std::vector<std::string> GetEnabledExplicitAPILayers() = 0;
   virtual float GetDPIScaling() = 0;
 
+  /// Per-user storage for settings, backups, and rules; created if needed
+  virtual std::filesystem::path GetUserDataDirectory() = 0;
+  /** Invoke `callback` whenever a file in the directory changes.
+   *
+   * The callback is passed the file name relative to the directory, and may
+   * be invoked from any thread.
+   */
+  [[nodiscard]]
+  virtual std::unique_ptr<DirectoryWatcher> WatchDirectory(
+    const std::filesystem::path& directory,
+    std::function<void(const std::filesystem::path&)> callback) = 0;
+  /// The directory containing this program, and any data files we ship
+  virtual std::filesystem::path GetExecutableDirectory() = 0;
+  /// nullptr if the file does not exist, is empty, or can not be mapped
+  [[nodiscard]]
+  virtual std::unique_ptr<MappedFile> MapFile(const std::filesystem::path&) = 0;
+
   virtual std::vector<AvailableRuntime> GetAvailableRuntimes(Architecture) = 0;
   std::optional<Runtime> GetActiveRuntime(
     Architecture = GetBuildArchitecture());
@@ -0,0 +1,134 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#include "RuntimeMatrix.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <tuple>
+#include <utility>
+
+#include "APILayerStore.hpp"
+#include "Config.hpp"
+#include "Platform.hpp"
+
+namespace FredEmmott::OpenXRLayers {
+
+namespace {
+
+RuntimeMatrix::Cell GetCell(
+  const APILayer& layer,
+  const APILayerDetails& details,
+  const Architecture arch,
+  const RuntimeLoaderData& runtime) {
+  using enum RuntimeMatrix::Cell;
+  if (!layer.mSource->GetArchitectures().contains(arch)) {
+    return NotApplicable;
+  }
+
+  const auto& result = runtime.mResult;
+  if (!result) {
+    return holds_alternative<LoaderData::PendingError>(result.error())
+      ? Pending
+      : Failed;
+  }
+  const auto& data = **result;
+
+  if (std::ranges::contains(data.mEnabledLayerNames, details.mName)) {
+    return Loaded;
+  }
+
+  // As in `SkippedByLoaderLinter`
+  const auto& disableEnv = details.mDisableEnvironment;
+  if (!disableEnv.empty()) {
+    const auto change
+      = FindChange(data.mEnvironmentVariableChanges, disableEnv);
+    if (change && !change->mBefore) {
+      return BlockedByRuntime;
+    }
+  }
+  return NotLoaded;
+}
+
+}// namespace
+
+RuntimeMatrix::RuntimeMatrix(
+  const std::vector<APILayer>& layers,
+  const APILayerDetailsMap& allDetails) {
+  std::vector<std::tuple<const APILayer&, const APILayerDetails&>> rows;
+  for (auto&& layer: layers) {
+    if (!layer.IsEnabled() || layer.GetKind() != APILayer::Kind::Implicit) {
+      continue;
+    }
+    const auto details = allDetails.find(layer.GetManifestPath());
+    if (
+      details == allDetails.end()
+      || details->second->mState != APILayerDetails::State::Loaded) {
+      continue;
+    }
+    rows.emplace_back(layer, *details->second);
+    mLayers.push_back(layer.GetDisplayPath());
+  }
+
+  auto& platform = Platform::Get();
+  // Keep the snapshots alive while we use the columns
+  std::vector<std::shared_ptr<const std::vector<RuntimeLoaderData>>> snapshots;
+  std::vector<const RuntimeLoaderData*> columns;
+  for (const auto arch: platform.GetArchitectures().enumerate()) {
+    const auto& runtimes
+      = snapshots.emplace_back(platform.GetAvailableRuntimesLoaderData(arch));
+    for (auto&& runtime: *runtimes) {
+      columns.push_back(&runtime);
+      mRuntimes.push_back({
+        .mArchitecture = arch,
+        .mName = runtime.mName,
+        .mIsRefreshing = runtime.mResult && (*runtime.mResult)->mIsRefreshing,
+      });
+    }
+  }
+
+  mCells.reserve(rows.size() * columns.size());
+  for (auto&& [layer, details]: rows) {
+    for (std::size_t i = 0; i < columns.size(); ++i) {
+      mCells.push_back(
+        GetCell(layer, details, mRuntimes.at(i).mArchitecture, *columns[i]));
+    }
+  }
+}
+
+std::string_view RuntimeMatrix::GetGlyph(const Cell cell) {
+  switch (cell) {
+    case Cell::NotApplicable:
+      return {};
+    case Cell::Pending:
+      return Config::GLYPH_PENDING;
+    case Cell::Failed:
+      return Config::GLYPH_ERROR;
+    case Cell::Loaded:
+      return Config::GLYPH_ENABLED;
+    case Cell::BlockedByRuntime:
+      return Config::GLYPH_BLOCKED;
+    case Cell::NotLoaded:
+      return Config::GLYPH_DISABLED;
+  }
+  std::unreachable();
+}
+
+std::string_view RuntimeMatrix::GetDescription(const Cell cell) {
+  switch (cell) {
+    case Cell::NotApplicable:
+      return "not applicable";
+    case Cell::Pending:
+      return "pending";
+    case Cell::Failed:
+      return "could not query the runtime";
+    case Cell::Loaded:
+      return "loaded";
+    case Cell::BlockedByRuntime:
+      return "blocked by the runtime";
+    case Cell::NotLoaded:
+      return "not loaded";
+  }
+  std::unreachable();
+}
+
+}// namespace FredEmmott::OpenXRLayers
@@ -0,0 +1,78 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "APILayer.hpp"
+#include "Architectures.hpp"
+#include "LayerTable.hpp"
+
+namespace FredEmmott::OpenXRLayers {
+
+/** Whether each enabled implicit layer is loaded by each available runtime.
+ *
+ * This is built from `Platform::GetAvailableRuntimesLoaderData()`, so it has
+ * no runtimes until `Platform::QueryAvailableRuntimes()` has been called.
+ */
+class RuntimeMatrix final {
+ public:
+  enum class Cell : uint8_t {
+    /// The layer's store does not include the runtime's architecture
+    NotApplicable,
+    Pending,
+    /// The runtime could not be queried
+    Failed,
+    Loaded,
+    /// The runtime set the layer's `disable_environment` variable
+    BlockedByRuntime,
+    /// Not loaded for any other reason
+    NotLoaded,
+  };
+
+  struct Runtime {
+    Architecture mArchitecture {};
+    std::string mName;
+    bool mIsRefreshing {false};
+  };
+
+  RuntimeMatrix(const std::vector<APILayer>&, const APILayerDetailsMap&);
+
+  /// Display paths of the rows
+  [[nodiscard]]
+  const std::vector<std::string>& GetLayers() const noexcept {
+    return mLayers;
+  }
+
+  /// The columns
+  [[nodiscard]]
+  const std::vector<Runtime>& GetRuntimes() const noexcept {
+    return mRuntimes;
+  }
+
+  [[nodiscard]]
+  Cell Get(const std::size_t layer, const std::size_t runtime) const {
+    return mCells.at((layer * mRuntimes.size()) + runtime);
+  }
+
+  [[nodiscard]]
+  bool empty() const noexcept {
+    return mLayers.empty() || mRuntimes.empty();
+  }
+
+  [[nodiscard]]
+  static std::string_view GetGlyph(Cell);
+  [[nodiscard]]
+  static std::string_view GetDescription(Cell);
+
+ private:
+  std::vector<std::string> mLayers;
+  std::vector<Runtime> mRuntimes;
+  // Row-major
+  std::vector<Cell> mCells;
+};
+
+}// namespace FredEmmott::OpenXRLayers
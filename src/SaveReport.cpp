@@ -13,8 +13,11 @@
 
 #include "APILayerStore.hpp"
 #include "Config.hpp"
+#include "LayerRelations.hpp"
+#include "LayerRules.hpp"
 #include "Linter.hpp"
 #include "Platform.hpp"
+#include "RuntimeMatrix.hpp"
 
 namespace FredEmmott::OpenXRLayers {
 
@@ -31,13 +34,16 @@ static std::string GenerateReportText(const APILayerStore* store) {
     "{}\n"
     "--------------------------------",
     store->GetDisplayName());
-  const auto layers = store->GetAPILayers();
+  const auto snapshot = store->GetSnapshot();
+  const auto& layers = snapshot->mLayers;
   if (layers.empty()) {
     ret += "\nNo layers.";
     return ret;
   }
 
-  const auto errors = RunAllLinters(store, layers);
+  APILayerDetailsMap allDetails;
+  LoadAPILayerDetails(allDetails, layers);
+  const auto errors = RunAllLinters(store, layers, allDetails);
 
   for (const auto& layer: layers) {
     using Value = APILayer::Value;
@@ -53,10 +59,10 @@ static std::string GenerateReportText(const APILayerStore* store) {
         value = Config::GLYPH_ERROR;
         break;
     }
-    ret += std::format("\n{} {}", value, layer.GetKey().mValue);
+    ret += std::format("\n{} {}", value, layer.GetKey().GetValue());
 
-    if (!layer.mManifestPath.empty()) {
-      const APILayerDetails details {layer.mManifestPath};
+    if (!layer.GetManifestPath().empty()) {
+      const auto& details = *allDetails.at(layer.GetManifestPath());
       if (details.mState != APILayerDetails::State::Loaded) {
         ret += fmt::format(
           "\n\t- {} {}", Config::GLYPH_ERROR, details.StateAsString());
@@ -144,6 +150,43 @@ static std::string GenerateReportText(const APILayerStore* store) {
       }
     }
   }
+
+  LayerRelations::Layers loadedLayers;
+  for (auto&& layer: layers) {
+    const auto& details = allDetails.at(layer.GetManifestPath());
+    if (details->mState == APILayerDetails::State::Loaded) {
+      loadedLayers.emplace_back(layer, details);
+    }
+  }
+  const auto relations = DescribeRelations(
+    LayerRelations {*GetLayerRules(), loadedLayers}, loadedLayers);
+  if (!relations.empty()) {
+    ret += "\n\nLayer relations:";
+    for (auto&& relation: relations) {
+      ret += fmt::format("\n\t- {}", relation);
+    }
+  }
+
+  const RuntimeMatrix matrix {layers, allDetails};
+  if (!matrix.empty()) {
+    ret += "\n\nLayers loaded by each runtime:";
+    const auto& runtimes = matrix.GetRuntimes();
+    for (auto&& [row, layer]: std::views::enumerate(matrix.GetLayers())) {
+      ret += fmt::format("\n\t{}", layer);
+      for (auto&& [column, runtime]: std::views::enumerate(runtimes)) {
+        const auto cell = matrix.Get(row, column);
+        if (cell == RuntimeMatrix::Cell::NotApplicable) {
+          continue;
+        }
+        ret += fmt::format(
+          "\n\t\t- {} {} ({}): {}",
+          RuntimeMatrix::GetGlyph(cell),
+          runtime.mName,
+          magic_enum::enum_name(runtime.mArchitecture),
+          RuntimeMatrix::GetDescription(cell));
+      }
+    }
+  }
   return ret;
 }
 
@@ -268,63 +311,77 @@ static std::string GenerateLoaderDataText(
               std::bit_cast<uint32_t>(e.mExitCode));
             ;
           },
-          [](const LoaderData::InvalidJSONError& e) {
-            return std::format("Invalid JSON: {}", e.mExplanation);
+          [](const LoaderData::InvalidResponseError& e) {
+            return std::format("Invalid response: {}", e.mExplanation);
+          },
+          [](const LoaderData::TimeoutError& e) {
+            return std::format("Timed out after {}", e.mTimeout);
           },
         },
         result.error()));
   }
 
-  const auto& data = *result;
+  const auto& data = **result;
+  if (data.mIsRefreshing) {
+    ret += "⚠️ Still refreshing; this may be out of date\n\n";
+  }
+  if (!data.mIsComplete) {
+    ret
+      += "⚠️ The runtime has not been loaded yet; extensions may be missing "
+         "or out of date\n\n";
+  }
   nlohmann::json json = data;
   json.erase("environmentVariables");
 
-  const auto& before = data.mEnvironmentVariablesBeforeLoader;
-  const auto& after = data.mEnvironmentVariablesAfterLoader;
-  std::vector<std::string> allEnvVars;
-  allEnvVars.append_range(std::views::keys(before));
-  allEnvVars.append_range(std::views::keys(after));
-  std::ranges::sort(allEnvVars);
-  {
-    auto [first, last] = std::ranges::unique(allEnvVars);
-    allEnvVars.erase(first, last);
-  }
-
+  const auto& changes = data.mEnvironmentVariableChanges;
   auto outEnvVars = nlohmann::json::array();
 
-  for (auto&& key: allEnvVars) {
-    const bool censor = (!key.starts_with("XR_")) && (!key.contains("_XR_"));
-
-    if (!after.contains(key)) {
-      assert(before.contains(key));
-      const auto value = censor ? "[*****]" : before.at(key);
+  const auto getValue
+    = [](const std::string_view key, const std::string_view value) {
+        const bool censor
+          = (!key.starts_with("XR_")) && (!key.contains("_XR_"));
+        return censor ? std::string {"[*****]"} : std::string {value};
+      };
+  const auto appendChange = [&](const EnvironmentChange& change) {
+    const auto& key = change.mName;
+    if (!change.mAfter) {
       outEnvVars.emplace_back(
-        std::format("⚠️➖ unset by runtime: {}={}", key, value));
-      continue;
+        std::format(
+          "⚠️➖ unset by runtime: {}={}", key, getValue(key, *change.mBefore)));
+      return;
     }
 
-    if (!before.contains(key)) {
-      assert(after.contains(key));
-      const auto value = censor ? "[*****]" : after.at(key);
+    if (!change.mBefore) {
       outEnvVars.emplace_back(
-        std::format("⚠️➕ added by runtime: {}={}", key, value));
-      continue;
-    }
-
-    const auto beforeValue = censor ? "[*****]" : before.at(key);
-    if (before.at(key) == after.at(key)) {
-      outEnvVars.emplace_back(std::format("{}={}", key, beforeValue));
-      continue;
+        std::format(
+          "⚠️➕ added by runtime: {}={}", key, getValue(key, *change.mAfter)));
+      return;
     }
 
-    const auto afterValue = censor ? "[*****]" : after.at(key);
     outEnvVars.emplace_back(
       std::format(
         "⚠️🔄 modified by runtime: -{}={} +{}={}",
         key,
-        beforeValue,
+        getValue(key, *change.mBefore),
         key,
-        afterValue));
+        getValue(key, *change.mAfter)));
+  };
+
+  // Both are sorted by name, so merge them in one pass
+  auto change = changes.begin();
+  for (auto&& [key, value]:
+       data.mEnvironmentVariablesBeforeLoader.GetVariables()) {
+    for (; change != changes.end() && change->mName < key; ++change) {
+      appendChange(*change);
+    }
+    if (change != changes.end() && change->mName == key) {
+      appendChange(*change++);
+      continue;
+    }
+    outEnvVars.emplace_back(std::format("{}={}", key, getValue(key, value)));
+  }
+  for (; change != changes.end(); ++change) {
+    appendChange(*change);
   }
 
   json["environmentVariables"] = outEnvVars;
@@ -347,6 +404,11 @@ std::string GenerateReport() {
       std::chrono::current_zone(), std::chrono::system_clock::now()));
 
   auto& platform = Platform::Get();
+  // Each runtime is loaded by its own helper, so start them first
+  platform.QueryAvailableRuntimes();
+  const auto deadline
+    = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+
   for (const auto arch: platform.GetArchitectures().enumerate()) {
     text += GenerateActiveRuntimeText(arch, platform.GetActiveRuntime(arch));
   }
@@ -355,12 +417,14 @@ std::string GenerateReport() {
       arch, platform.GetAvailableRuntimes(arch));
   }
 
+  // Used by `GenerateReportText()`
+  for (const auto arch: platform.GetArchitectures().enumerate()) {
+    platform.WaitForAvailableRuntimesLoaderData(arch, deadline);
+  }
   for (const auto store: APILayerStore::Get()) {
     text += GenerateReportText(store);
   }
 
-  const auto deadline
-    = std::chrono::steady_clock::now() + std::chrono::seconds(10);
   for (const auto arch: platform.GetArchitectures().enumerate()) {
     text += GenerateLoaderDataText(platform, arch, deadline);
   }
@@ -0,0 +1,81 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "StoreChangeQueue.hpp"
+
+#include <algorithm>
+
+namespace FredEmmott::OpenXRLayers {
+
+StoreChangeQueue::StoreChangeQueue(
+  const std::span<APILayerStore* const> stores,
+  const Clock::duration debounce,
+  const Clock::duration maxLatency)
+  : mDebounce(debounce),
+    mMaxLatency(maxLatency) {
+  for (auto&& store: stores) {
+    mSlots.emplace_back(store);
+  }
+}
+
+void StoreChangeQueue::Push(
+  const APILayerStore* const store,
+  const uint64_t generation) noexcept {
+  const auto it = std::ranges::find(mSlots, store, &Slot::mStore);
+  if (it == mSlots.end()) {
+    return;
+  }
+  auto& slot = *it;
+
+  auto previous = slot.mGeneration.load(std::memory_order_relaxed);
+  while (previous < generation
+         && !slot.mGeneration.compare_exchange_weak(
+           previous, generation, std::memory_order_relaxed)) {
+  }
+  const auto now = Clock::now().time_since_epoch().count();
+  slot.mLastEvent.store(now, std::memory_order_relaxed);
+  // Only set by the first event since the last drain
+  Clock::rep noFirstEvent {0};
+  slot.mFirstEvent.compare_exchange_strong(
+    noFirstEvent, now, std::memory_order_relaxed);
+  // Release, so that the consumer sees the generation and time once it sees
+  // the new count
+  slot.mEventCount.fetch_add(1, std::memory_order_release);
+}
+
+StoreChangeQueue::DrainResult StoreChangeQueue::Drain(
+  const Clock::time_point now) {
+  DrainResult ret;
+  for (auto&& slot: mSlots) {
+    const auto eventCount = slot.mEventCount.load(std::memory_order_acquire);
+    if (eventCount == slot.mDrainedEventCount) {
+      continue;
+    }
+
+    const Clock::time_point lastEvent {
+      Clock::duration {slot.mLastEvent.load(std::memory_order_relaxed)}};
+    // Unset if the event raced with the previous drain; the next event will
+    // set it
+    const auto firstEventRep = slot.mFirstEvent.load(std::memory_order_relaxed);
+    const auto firstEvent = firstEventRep
+      ? Clock::time_point {Clock::duration {firstEventRep}}
+      : lastEvent;
+    const auto dueAt
+      = std::min(lastEvent + mDebounce, firstEvent + mMaxLatency);
+    if (now < dueAt) {
+      ret.mNextDrain = std::min(ret.mNextDrain.value_or(dueAt), dueAt);
+      continue;
+    }
+
+    ret.mChanges.push_back({
+      .mStore = slot.mStore,
+      .mGeneration = slot.mGeneration.load(std::memory_order_relaxed),
+      .mEventCount = eventCount - slot.mDrainedEventCount,
+    });
+    slot.mDrainedEventCount = eventCount;
+    slot.mFirstEvent.store(0, std::memory_order_relaxed);
+  }
+  return ret;
+}
+
+}// namespace FredEmmott::OpenXRLayers
@@ -0,0 +1,88 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace FredEmmott::OpenXRLayers {
+class APILayerStore;
+
+/** Coalesces change notifications from several stores for one consumer.
+ *
+ * Producers - e.g. registry watcher callbacks on thread-pool threads - call
+ * `Push()`, which only updates atomics in a per-store slot, so it never
+ * blocks or allocates.
+ *
+ * The consumer calls `Drain()`, e.g. once per frame. Each store is reported at
+ * most once per drain, and only after it has been quiet for the debounce
+ * interval, so a burst of changes from an installer leads to a single reload.
+ *
+ * A store that never goes quiet is still reported once `maxLatency` has passed
+ * since its first undrained change.
+ */
+class StoreChangeQueue final {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Change {
+    const APILayerStore* mStore {nullptr};
+    /// The highest generation pushed for this store
+    uint64_t mGeneration {};
+    /// How many notifications were coalesced into this change
+    uint64_t mEventCount {};
+  };
+
+  struct DrainResult {
+    std::vector<Change> mChanges;
+    /// When to drain again, if any stores have changes that are not yet due
+    std::optional<Clock::time_point> mNextDrain;
+  };
+
+  StoreChangeQueue(
+    std::span<APILayerStore* const> stores,
+    Clock::duration debounce,
+    Clock::duration maxLatency);
+
+  StoreChangeQueue(const StoreChangeQueue&) = delete;
+  StoreChangeQueue(StoreChangeQueue&&) = delete;
+  StoreChangeQueue& operator=(const StoreChangeQueue&) = delete;
+  StoreChangeQueue& operator=(StoreChangeQueue&&) = delete;
+
+  /// Thread-safe and lock-free; unknown stores are ignored
+  void Push(const APILayerStore*, uint64_t generation) noexcept;
+
+  /// Must only be called from one thread at a time
+  [[nodiscard]]
+  DrainResult Drain(Clock::time_point now = Clock::now());
+
+ private:
+  struct Slot {
+    explicit Slot(const APILayerStore* store) : mStore(store) {}
+
+    const APILayerStore* const mStore;
+
+    // Written by producers
+    std::atomic<uint64_t> mGeneration {0};
+    std::atomic<uint64_t> mEventCount {0};
+    std::atomic<Clock::rep> mLastEvent {0};
+    // The first event since the last drain; 0 if none
+    std::atomic<Clock::rep> mFirstEvent {0};
+
+    // Only used by the consumer
+    uint64_t mDrainedEventCount {0};
+  };
+
+  const Clock::duration mDebounce;
+  const Clock::duration mMaxLatency;
+  // Not modified after construction, so lookups do not need a lock; std::deque
+  // as the atomics can not be moved
+  std::deque<Slot> mSlots;
+};
+
+}// namespace FredEmmott::OpenXRLayers
@@ -0,0 +1,310 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "UserLayerRules.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <array>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <optional>
+#include <ranges>
+#include <unordered_map>
+
+#include "Platform.hpp"
+
+namespace FredEmmott::OpenXRLayers {
+
+namespace {
+constexpr auto RulesFileName = "rules.json";
+
+constexpr std::array RuleProperties {
+  std::pair {"above", &LayerRules::mAbove},
+  std::pair {"below", &LayerRules::mBelow},
+  std::pair {"facets", &LayerRules::mFacets},
+  std::pair {"conflicts", &LayerRules::mConflicts},
+  std::pair {"conflictsPerApp", &LayerRules::mConflictsPerApp},
+};
+
+struct CompiledRules {
+  std::vector<LayerRules> mRules;
+  std::vector<std::string> mDiagnostics;
+};
+
+class RulesCompiler {
+ public:
+  RulesCompiler() {
+    mResult.mRules = GetBuiltinLayerRules();
+    for (auto&& rule: mResult.mRules) {
+      AddExplicitFacet(rule.mID);
+      for (auto&& [_, property]: RuleProperties) {
+        for (auto&& facet: std::invoke(property, rule) | std::views::keys) {
+          AddExplicitFacet(facet);
+        }
+      }
+    }
+  }
+
+  CompiledRules Compile(const nlohmann::json& json) && {
+    if (!json.is_object()) {
+      Diagnose("the top level must be an object");
+      return std::move(mResult);
+    }
+
+    for (auto&& [key, value]: json.items()) {
+      if (key == "facets") {
+        CompileFacets(value);
+      } else if (key != "rules") {
+        Diagnose("unknown property '{}'", key);
+      }
+    }
+    // After facets, so that rules can use facets declared in the same file
+    if (json.contains("rules")) {
+      CompileRules(json.at("rules"));
+    }
+    return std::move(mResult);
+  }
+
+  CompiledRules Fail(const std::string_view message) && {
+    mResult.mDiagnostics.emplace_back(message);
+    return std::move(mResult);
+  }
+
+ private:
+  CompiledRules mResult;
+  std::unordered_map<std::string, Facet> mExplicitFacets;
+
+  template <class... Args>
+  void Diagnose(std::format_string<Args...> format, Args&&... args) {
+    mResult.mDiagnostics.push_back(
+      std::format(format, std::forward<Args>(args)...));
+  }
+
+  void AddExplicitFacet(const Facet& facet) {
+    if (facet.GetKind() == Facet::Kind::Explicit) {
+      mExplicitFacets.emplace(std::string {facet.GetID()}, facet);
+    }
+  }
+
+  void CompileFacets(const nlohmann::json& facets) {
+    if (!facets.is_object()) {
+      Diagnose("'facets' must be an object");
+      return;
+    }
+    for (auto&& [id, description]: facets.items()) {
+      if (!id.starts_with('#')) {
+        Diagnose("facets.{}: facet IDs must start with '#'", id);
+        continue;
+      }
+      if (!description.is_string()) {
+        Diagnose("facets.{}: the description must be a string", id);
+        continue;
+      }
+      if (mExplicitFacets.contains(id)) {
+        Diagnose("facets.{}: this facet is already defined", id);
+        continue;
+      }
+      mExplicitFacets.emplace(id, Facet {id, description.get<std::string>()});
+    }
+  }
+
+  std::optional<Facet> ParseFacet(
+    const std::string_view where,
+    const std::string& id) {
+    if (id.starts_with('#')) {
+      const auto it = mExplicitFacets.find(id);
+      if (it == mExplicitFacets.end()) {
+        Diagnose(
+          "{}: '{}' is not a built-in facet, and is not declared in 'facets'",
+          where,
+          id);
+        return std::nullopt;
+      }
+      return it->second;
+    }
+    if (id.starts_with("XR_APILAYER_")) {
+      return LayerID {id};
+    }
+    if (id.starts_with("XR_")) {
+      return ExtensionID {id};
+    }
+    Diagnose(
+      "{}: '{}' is not a facet ('#...'), layer ('XR_APILAYER_...'), or "
+      "extension ('XR_...')",
+      where,
+      id);
+    return std::nullopt;
+  }
+
+  void CompileRules(const nlohmann::json& rules) {
+    if (!rules.is_object()) {
+      Diagnose("'rules' must be an object");
+      return;
+    }
+    for (auto&& [id, value]: rules.items()) {
+      const auto where = std::format("rules.{}", id);
+      auto rule = CompileRule(where, id, value);
+      if (!rule) {
+        continue;
+      }
+
+      auto& allRules = mResult.mRules;
+      const auto it
+        = std::ranges::find(allRules, rule->mID, &LayerRules::mID);
+      if (it == allRules.end()) {
+        allRules.push_back(std::move(*rule));
+        continue;
+      }
+      for (auto&& [_, property]: RuleProperties) {
+        std::invoke(property, *it).merge(std::invoke(property, *rule));
+      }
+    }
+  }
+
+  std::optional<LayerRules> CompileRule(
+    const std::string_view where,
+    const std::string& id,
+    const nlohmann::json& value) {
+    const auto ruleID = ParseFacet(where, id);
+    if (!ruleID) {
+      return std::nullopt;
+    }
+    if (ruleID->GetKind() == Facet::Kind::Extension) {
+      Diagnose("{}: rules can only be defined for layers and facets", where);
+      return std::nullopt;
+    }
+    if (!value.is_object()) {
+      Diagnose("{}: rules must be objects", where);
+      return std::nullopt;
+    }
+
+    LayerRules ret {.mID = *ruleID};
+    for (auto&& [key, facets]: value.items()) {
+      const auto property
+        = std::ranges::find(RuleProperties, key, [](const auto& it) {
+            return std::string_view {it.first};
+          });
+      if (property == RuleProperties.end()) {
+        Diagnose(
+          "{}.{}: unknown property; expected 'above', 'below', 'facets', "
+          "'conflicts', or 'conflictsPerApp'",
+          where,
+          key);
+        continue;
+      }
+      const bool isFacets = (property->second == &LayerRules::mFacets);
+      if (isFacets && ruleID->GetKind() != Facet::Kind::Layer) {
+        // Otherwise, facets could provide each other, forever
+        Diagnose("{}.{}: only layers can provide facets", where, key);
+        continue;
+      }
+      if (!facets.is_array()) {
+        Diagnose("{}.{}: must be an array", where, key);
+        continue;
+      }
+
+      auto& facetMap = std::invoke(property->second, ret);
+      for (std::size_t i = 0; i < facets.size(); ++i) {
+        const auto itemWhere = std::format("{}.{}[{}]", where, key, i);
+        const auto& item = facets.at(i);
+        if (!item.is_string()) {
+          Diagnose("{}: must be a string", itemWhere);
+          continue;
+        }
+        const auto facet = ParseFacet(itemWhere, item.get<std::string>());
+        if (!facet) {
+          continue;
+        }
+        if (facet->GetID() == ruleID->GetID()) {
+          Diagnose("{}: a rule can not refer to itself", itemWhere);
+          continue;
+        }
+        if (isFacets && facet->GetKind() != Facet::Kind::Explicit) {
+          Diagnose(
+            "{}: only '#' facets can be provided; extensions should be listed "
+            "in the layer's manifest",
+            itemWhere);
+          continue;
+        }
+        facetMap.emplace(*facet, FacetTrace {});
+      }
+    }
+    return ret;
+  }
+};
+
+CompiledRules LoadRules(const std::filesystem::path& path) {
+  if (!std::filesystem::exists(path)) {
+    return RulesCompiler {}.Compile(nlohmann::json::object());
+  }
+
+  std::ifstream f(path);
+  if (!f) {
+    return RulesCompiler {}.Fail("the file could not be read");
+  }
+
+  try {
+    const auto json = nlohmann::json::parse(
+      f,
+      /* callback = */ nullptr,
+      /* allow_exceptions = */ true,
+      /* ignore_comments = */ true);
+    return RulesCompiler {}.Compile(json);
+  } catch (const nlohmann::json::exception& e) {
+    return RulesCompiler {}.Fail(
+      std::format("the file is not valid JSON: {}", e.what()));
+  }
+}
+
+}// namespace
+
+UserLayerRules& UserLayerRules::Get() {
+  static UserLayerRules sInstance;
+  return sInstance;
+}
+
+UserLayerRules::UserLayerRules()
+  : mDirectory(Platform::Get().GetUserDataDirectory()) {
+  mWatcher = Platform::Get().WatchDirectory(
+    mDirectory, [this](const std::filesystem::path& fileName) {
+      if (fileName != RulesFileName) {
+        return;
+      }
+      mIsStale = true;
+      mOnChangeSignal();
+    });
+}
+
+UserLayerRules::~UserLayerRules() = default;
+
+std::filesystem::path UserLayerRules::GetPath() const {
+  return mDirectory / RulesFileName;
+}
+
+void UserLayerRules::ReloadIfStale() {
+  const std::unique_lock lock(mMutex);
+  if (!mIsStale.exchange(false)) {
+    return;
+  }
+
+  auto [rules, diagnostics] = LoadRules(this->GetPath());
+  mRuleSet = std::make_shared<const LayerRuleSet>(std::move(rules));
+  mDiagnostics = std::move(diagnostics);
+}
+
+std::shared_ptr<const LayerRuleSet> UserLayerRules::GetRuleSet() {
+  this->ReloadIfStale();
+  const std::unique_lock lock(mMutex);
+  return mRuleSet;
+}
+
+std::vector<std::string> UserLayerRules::GetDiagnostics() {
+  this->ReloadIfStale();
+  const std::unique_lock lock(mMutex);
+  return mDiagnostics;
+}
+
+}// namespace FredEmmott::OpenXRLayers
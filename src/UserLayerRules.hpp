@@ -0,0 +1,93 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <boost/signals2.hpp>
+
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "LayerRules.hpp"
+
+namespace FredEmmott::OpenXRLayers {
+class DirectoryWatcher;
+
+/** Additional rules from `rules.json` in the user data directory.
+ *
+ * For example:
+ *
+ * ```json
+ * {
+ *   "facets": {
+ *     "#CapturesFrames": "captures frames"
+ *   },
+ *   "rules": {
+ *     "XR_APILAYER_ACME_capture": {
+ *       "above": ["XR_APILAYER_NOVENDOR_OBSMirror"],
+ *       "below": ["#CompositionLayers", "XR_EXT_hand_tracking"],
+ *       "facets": ["#CapturesFrames"],
+ *       "conflicts": [],
+ *       "conflictsPerApp": []
+ *     }
+ *   }
+ * }
+ * ```
+ *
+ * Facets starting with `#` are explicit facets, which must be either built-in
+ * or declared in `facets`; facets starting with `XR_APILAYER_` are layers,
+ * and any other facet starting with `XR_` is an extension.
+ *
+ * Rules for an ID that already has built-in rules are merged with the
+ * built-in rules.
+ *
+ * The file is reloaded when it changes.
+ */
+class UserLayerRules final {
+ public:
+  static UserLayerRules& Get();
+
+  UserLayerRules(const UserLayerRules&) = delete;
+  UserLayerRules(UserLayerRules&&) = delete;
+  UserLayerRules& operator=(const UserLayerRules&) = delete;
+  UserLayerRules& operator=(UserLayerRules&&) = delete;
+
+  [[nodiscard]]
+  std::filesystem::path GetPath() const;
+
+  /// The built-in rules combined with the rules from the file
+  [[nodiscard]]
+  std::shared_ptr<const LayerRuleSet> GetRuleSet();
+  /// Human-readable problems with the rules file
+  [[nodiscard]]
+  std::vector<std::string> GetDiagnostics();
+
+  /// Invoked from any thread when the rules file changes
+  boost::signals2::scoped_connection OnChange(
+    std::function<void()> callback) noexcept {
+    return mOnChangeSignal.connect(std::move(callback));
+  }
+
+ private:
+  UserLayerRules();
+  ~UserLayerRules();
+
+  std::filesystem::path mDirectory;
+  boost::signals2::signal<void()> mOnChangeSignal;
+
+  std::atomic<bool> mIsStale {true};
+  std::mutex mMutex;
+  std::shared_ptr<const LayerRuleSet> mRuleSet;
+  std::vector<std::string> mDiagnostics;
+
+  // Last, so that it is destroyed before anything the callback uses
+  std::unique_ptr<DirectoryWatcher> mWatcher;
+
+  void ReloadIfStale();
+};
+
+}// namespace FredEmmott::OpenXRLayers
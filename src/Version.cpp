@@ -0,0 +1,218 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "Version.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <format>
+#include <limits>
+#include <ranges>
+
+namespace FredEmmott::OpenXRLayers {
+
+namespace {
+constexpr std::array<uint64_t, 3> ComponentMax {
+  std::numeric_limits<uint16_t>::max(),
+  std::numeric_limits<uint16_t>::max(),
+  std::numeric_limits<uint32_t>::max(),
+};
+constexpr auto MaxPacked = std::numeric_limits<uint64_t>::max();
+
+std::string_view Trim(std::string_view value) {
+  const auto first = value.find_first_not_of(" \t");
+  if (first == std::string_view::npos) {
+    return {};
+  }
+  const auto last = value.find_last_not_of(" \t");
+  return value.substr(first, last - first + 1);
+}
+
+/// A version where trailing components may be missing or `*`
+struct VersionPattern {
+  std::array<uint64_t, 3> mComponents {};
+  std::size_t mCount {};
+
+  /// Missing components are 0
+  [[nodiscard]]
+  Version GetLowest() const noexcept {
+    return {
+      static_cast<uint16_t>(mComponents[0]),
+      static_cast<uint16_t>(mComponents[1]),
+      static_cast<uint32_t>(mComponents[2]),
+    };
+  }
+
+  /// Missing components are their maximum value
+  [[nodiscard]]
+  Version GetHighest() const noexcept {
+    auto components = mComponents;
+    for (auto i = mCount; i < components.size(); ++i) {
+      components[i] = ComponentMax[i];
+    }
+    return {
+      static_cast<uint16_t>(components[0]),
+      static_cast<uint16_t>(components[1]),
+      static_cast<uint32_t>(components[2]),
+    };
+  }
+};
+
+std::optional<VersionPattern> ParsePattern(
+  std::string_view text,
+  const bool allowWildcards) {
+  if (text.empty()) {
+    return std::nullopt;
+  }
+
+  VersionPattern ret;
+  bool haveWildcard = false;
+  for (auto&& range: std::views::split(text, '.')) {
+    const std::string_view component {range.begin(), range.end()};
+    if (haveWildcard) {
+      // Only `*` can follow `*`
+      if (component != "*") {
+        return std::nullopt;
+      }
+      continue;
+    }
+    if (component == "*" && allowWildcards) {
+      haveWildcard = true;
+      continue;
+    }
+    if (ret.mCount == ret.mComponents.size() || component.empty()) {
+      return std::nullopt;
+    }
+
+    uint64_t value {};
+    const auto end = component.data() + component.size();
+    const auto [ptr, ec] = std::from_chars(component.data(), end, value);
+    if (ec != std::errc {} || ptr != end || value > ComponentMax[ret.mCount]) {
+      return std::nullopt;
+    }
+    ret.mComponents[ret.mCount++] = value;
+  }
+  return ret;
+}
+
+using Interval = VersionRange::Interval;
+
+std::expected<Interval, std::string> ParseComparison(
+  const std::string_view comparison) {
+  // Longest first, so that `<=` isn't parsed as `<`
+  constexpr std::array Operators {"<=", ">=", "<", ">", "="};
+  std::string_view op {"="};
+  std::string_view operand {comparison};
+  for (const std::string_view it: Operators) {
+    if (comparison.starts_with(it)) {
+      op = it;
+      operand = comparison.substr(it.size());
+      break;
+    }
+  }
+
+  const auto pattern = ParsePattern(operand, /* allowWildcards = */ true);
+  if (!pattern) {
+    return std::unexpected {
+      std::format("'{}' is not a valid version", operand)};
+  }
+  const auto lowest = pattern->GetLowest().GetPacked();
+  const auto highest = pattern->GetHighest().GetPacked();
+
+  // Empty intervals have mMin > mMax
+  constexpr Interval Empty {1, 0};
+  if (op == "=") {
+    return Interval {lowest, highest};
+  }
+  if (op == "<") {
+    return lowest == 0 ? Empty : Interval {0, lowest - 1};
+  }
+  if (op == "<=") {
+    return Interval {0, highest};
+  }
+  if (op == ">") {
+    return highest == MaxPacked ? Empty : Interval {highest + 1, MaxPacked};
+  }
+  return Interval {lowest, MaxPacked};
+}
+
+}// namespace
+
+std::optional<Version> Version::Parse(const std::string_view value) {
+  const auto pattern = ParsePattern(Trim(value), /* allowWildcards = */ false);
+  if (!pattern) {
+    return std::nullopt;
+  }
+  return pattern->GetLowest();
+}
+
+std::string Version::ToString() const {
+  return std::format("{}.{}.{}", GetMajor(), GetMinor(), GetPatch());
+}
+
+std::expected<VersionRange, std::string> VersionRange::Parse(
+  const std::string_view expression) {
+  // Otherwise, there are no alternatives, so this would match nothing
+  if (Trim(expression).empty()) {
+    return std::unexpected {std::string {"empty version range"}};
+  }
+
+  VersionRange ret;
+  for (auto&& range: std::views::split(expression, std::string_view {"||"})) {
+    const std::string_view alternative {range.begin(), range.end()};
+
+    Interval interval {0, MaxPacked};
+    bool haveComparison = false;
+    for (auto&& word: std::views::split(alternative, ' ')) {
+      const std::string_view comparison {word.begin(), word.end()};
+      if (comparison.empty()) {
+        continue;
+      }
+      haveComparison = true;
+
+      const auto compiled = ParseComparison(comparison);
+      if (!compiled) {
+        return std::unexpected {compiled.error()};
+      }
+      interval.mMin = std::max(interval.mMin, compiled->mMin);
+      interval.mMax = std::min(interval.mMax, compiled->mMax);
+    }
+    if (!haveComparison) {
+      return std::unexpected {
+        std::format("'{}' contains an empty alternative", expression)};
+    }
+    if (interval.mMin <= interval.mMax) {
+      ret.mIntervals.push_back(interval);
+    }
+  }
+
+  // Sort and merge overlapping or adjacent intervals
+  std::ranges::sort(ret.mIntervals, {}, &Interval::mMin);
+  std::vector<Interval> merged;
+  for (auto&& it: ret.mIntervals) {
+    if (
+      (!merged.empty())
+      && (merged.back().mMax == MaxPacked
+          || it.mMin <= merged.back().mMax + 1)) {
+      merged.back().mMax = std::max(merged.back().mMax, it.mMax);
+      continue;
+    }
+    merged.push_back(it);
+  }
+  ret.mIntervals = std::move(merged);
+
+  return ret;
+}
+
+bool VersionRange::Contains(const Version version) const noexcept {
+  const auto packed = version.GetPacked();
+  // First interval starting after `packed`; only the one before can match
+  auto it = std::ranges::upper_bound(mIntervals, packed, {}, &Interval::mMin);
+  if (it == mIntervals.begin()) {
+    return false;
+  }
+  return packed <= std::ranges::prev(it)->mMax;
+}
+
+}// namespace FredEmmott::OpenXRLayers
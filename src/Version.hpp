@@ -0,0 +1,112 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <compare>
+#include <cstdint>
+#include <expected>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace FredEmmott::OpenXRLayers {
+
+/** A version number packed into 64 bits.
+ *
+ * This uses the same layout as `XR_MAKE_VERSION()`: a 16-bit major version,
+ * 16-bit minor version, and 32-bit patch version, so versions can be compared
+ * as integers.
+ */
+class Version final {
+ public:
+  constexpr Version() = default;
+  constexpr Version(
+    const uint16_t major,
+    const uint16_t minor = 0,
+    const uint32_t patch = 0)
+    : mPacked(
+        (static_cast<uint64_t>(major) << 48)
+        | (static_cast<uint64_t>(minor) << 32) | patch) {}
+
+  static constexpr Version FromPacked(const uint64_t packed) noexcept {
+    Version ret;
+    ret.mPacked = packed;
+    return ret;
+  }
+
+  /** Parse `major[.minor[.patch]]`, e.g. "1" or "1.0.32".
+   *
+   * Returns nullopt if there is anything else in the string, or if a
+   * component is too large.
+   */
+  static std::optional<Version> Parse(std::string_view);
+
+  [[nodiscard]]
+  constexpr uint64_t GetPacked() const noexcept {
+    return mPacked;
+  }
+
+  [[nodiscard]]
+  constexpr uint16_t GetMajor() const noexcept {
+    return static_cast<uint16_t>(mPacked >> 48);
+  }
+
+  [[nodiscard]]
+  constexpr uint16_t GetMinor() const noexcept {
+    return static_cast<uint16_t>(mPacked >> 32);
+  }
+
+  [[nodiscard]]
+  constexpr uint32_t GetPatch() const noexcept {
+    return static_cast<uint32_t>(mPacked);
+  }
+
+  /// `major.minor.patch`
+  [[nodiscard]]
+  std::string ToString() const;
+
+  constexpr auto operator<=>(const Version&) const noexcept = default;
+
+ private:
+  uint64_t mPacked {};
+};
+
+/** A set of versions, compiled from an expression such as `<1.2.0 || =2.0.*`.
+ *
+ * - `||` separates alternatives
+ * - within an alternative, space-separated comparisons must all match
+ * - comparisons are `<`, `<=`, `>`, `>=`, or `=`; `=` is the default
+ * - trailing components can be omitted or `*`, so `=2.0.*`, `=2.0`, and `2.0`
+ *   are equivalent, and `<2` is equivalent to `<2.0.0`
+ *
+ * The expression is compiled to a sorted list of non-overlapping packed
+ * intervals, so matching is just integer comparisons.
+ */
+class VersionRange final {
+ public:
+  /// Inclusive range of packed versions
+  struct Interval {
+    uint64_t mMin {};
+    uint64_t mMax {};
+
+    constexpr bool operator==(const Interval&) const noexcept = default;
+  };
+
+  VersionRange() = default;
+  static std::expected<VersionRange, std::string> Parse(std::string_view);
+
+  [[nodiscard]]
+  bool Contains(Version) const noexcept;
+
+  [[nodiscard]]
+  std::span<const Interval> GetIntervals() const noexcept {
+    return mIntervals;
+  }
+
+ private:
+  std::vector<Interval> mIntervals;
+};
+
+}// namespace FredEmmott::OpenXRLayers
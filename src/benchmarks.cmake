@@ -0,0 +1,36 @@
+include_guard(GLOBAL)
+
+include(lib.cmake)
+
+# Not in CMAKE_RUNTIME_OUTPUT_DIRECTORY, as that is what we ship
+set(BENCHMARKS_OUTPUT_DIRECTORY "${CMAKE_BINARY_DIR}/benchmarks")
+
+# Each benchmark is a standalone executable that prints its timings; they are
+# not registered with CTest, as timings are only meaningful in release builds
+# on a quiet machine. See benchmarks/Benchmark.hpp
+function(add_lib_benchmark NAME)
+  add_executable("${NAME}" ${ARGN})
+  target_link_libraries("${NAME}" PRIVATE lib)
+  set_target_properties(
+    "${NAME}"
+    PROPERTIES
+    RUNTIME_OUTPUT_DIRECTORY "${BENCHMARKS_OUTPUT_DIRECTORY}"
+  )
+  if (UNIX)
+    target_sources("${NAME}" PRIVATE tests/NoPlatform.cpp)
+  endif ()
+endfunction()
+
+add_lib_benchmark(layer-table-benchmark benchmarks/LayerTableBenchmark.cpp)
+add_lib_benchmark(
+  loader-data-format-benchmark
+  benchmarks/LoaderDataFormatBenchmark.cpp
+)
+add_lib_benchmark(
+  loader-data-service-benchmark
+  benchmarks/LoaderDataServiceBenchmark.cpp
+)
+add_lib_benchmark(
+  store-change-queue-benchmark
+  benchmarks/StoreChangeQueueBenchmark.cpp
+)
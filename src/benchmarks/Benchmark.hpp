@@ -0,0 +1,59 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string_view>
+
+namespace FredEmmott::OpenXRLayers::Benchmarks {
+
+using Clock = std::chrono::steady_clock;
+
+// How long to repeat each benchmark for; the mean is reported
+constexpr auto MinDuration = std::chrono::milliseconds(500);
+
+/// Stop the compiler from discarding a result that is otherwise unused
+template <class T>
+void DoNotOptimize(const T& value) {
+  static const void* volatile sSink {};
+  sSink = &value;
+  std::atomic_signal_fence(std::memory_order_seq_cst);
+}
+
+/// Print the mean time per iteration, and return it in nanoseconds
+inline double Report(
+  const std::string_view name,
+  const Clock::duration elapsed,
+  const uint64_t iterations) {
+  const auto ns
+    = std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+  std::printf(
+    "%-48.*s %14.1f ns/iter %10llu iterations\n",
+    static_cast<int>(name.size()),
+    name.data(),
+    ns,
+    static_cast<unsigned long long>(iterations));
+  return ns;
+}
+
+/// Call `fn` repeatedly for at least `MinDuration`, then print the mean time
+template <class F>
+double Measure(const std::string_view name, F&& fn) {
+  // Warm up caches and any lazily-initialized state
+  fn();
+
+  uint64_t iterations = 0;
+  const auto start = Clock::now();
+  auto elapsed = Clock::duration {};
+  while (elapsed < MinDuration) {
+    fn();
+    ++iterations;
+    elapsed = Clock::now() - start;
+  }
+  return Report(name, elapsed, iterations);
+}
+
+}// namespace FredEmmott::OpenXRLayers::Benchmarks
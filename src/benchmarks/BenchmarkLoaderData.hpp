@@ -0,0 +1,64 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <cstddef>
+#include <format>
+#include <map>
+#include <string>
+
+#include "LoaderData.hpp"
+
+namespace FredEmmott::OpenXRLayers::Benchmarks {
+
+/** Loader data the size of a typical Windows response.
+ *
+ * The environment is most of it, as with real helpers: around a hundred
+ * variables, including a long `PATH`.
+ */
+inline LoaderData MakeLoaderData() {
+  constexpr std::size_t VariableCount = 100;
+  constexpr std::size_t PathEntries = 40;
+  constexpr std::size_t LayerCount = 8;
+  constexpr std::size_t ExtensionCount = 40;
+
+  std::map<std::string, std::string> variables;
+  for (std::size_t i = 0; i < VariableCount; ++i) {
+    variables.emplace(
+      std::format("BENCHMARK_VARIABLE_{:03}", i),
+      std::format("C:\\Program Files\\Benchmark Vendor {}\\Value", i));
+  }
+  std::string path;
+  for (std::size_t i = 0; i < PathEntries; ++i) {
+    path += std::format("C:\\Program Files\\Benchmark Tool {}\\bin;", i);
+  }
+  variables.emplace("PATH", std::move(path));
+  variables.emplace("XR_ENABLE_API_LAYERS", "XR_APILAYER_BENCHMARK_layer_0");
+
+  LoaderData ret {
+    .mQueryExtensionsResult = XR_SUCCESS,
+    .mQueryLayersResult = XR_SUCCESS,
+    .mEnvironmentVariablesBeforeLoader = Environment {variables},
+    .mEnvironmentVariableChanges = {
+      {
+        .mName = "BENCHMARK_RUNTIME_VARIABLE",
+        .mAfter = "1",
+      },
+      {
+        .mName = "XR_ENABLE_API_LAYERS",
+        .mBefore = "XR_APILAYER_BENCHMARK_layer_0",
+      },
+    },
+  };
+  for (std::size_t i = 0; i < LayerCount; ++i) {
+    ret.mEnabledLayerNames.push_back(
+      std::format("XR_APILAYER_BENCHMARK_layer_{}", i));
+  }
+  for (std::size_t i = 0; i < ExtensionCount; ++i) {
+    ret.mAvailableExtensionNames.push_back(
+      std::format("XR_BENCHMARK_extension_{}", i));
+  }
+  return ret;
+}
+
+}// namespace FredEmmott::OpenXRLayers::Benchmarks
@@ -0,0 +1,39 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "APILayerStore.hpp"
+
+namespace FredEmmott::OpenXRLayers::Benchmarks {
+
+/// An empty store, for benchmarks that need layers or store pointers
+class BenchmarkStore final : public APILayerStore {
+ public:
+  explicit BenchmarkStore(
+    const APILayer::Kind kind = APILayer::Kind::Explicit)
+    : mKind(kind) {}
+
+  APILayer::Kind GetKind() const noexcept override {
+    return mKind;
+  }
+
+  std::string GetDisplayName() const noexcept override {
+    return "Benchmark";
+  }
+
+  std::vector<APILayer> GetAPILayers() const noexcept override {
+    return {};
+  }
+
+  Architectures GetArchitectures() const noexcept override {
+    return Platform::GetBuildArchitecture();
+  }
+
+ private:
+  APILayer::Kind mKind;
+};
+
+}// namespace FredEmmott::OpenXRLayers::Benchmarks
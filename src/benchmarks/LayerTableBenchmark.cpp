@@ -0,0 +1,186 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <filesystem>
+#include <format>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "BenchmarkStore.hpp"
+#include "LayerTable.hpp"
+
+/** Builds `LayerTable`s for 10, 100, and 10,000 layers, and filters them.
+ *
+ * Tables are built for every lint pass, and for every fix preview; details are
+ * shared with the `APILayerDetailsMap`, so this should scale with the number
+ * of layers, not with the size of their manifests.
+ *
+ * For comparison, the same scans are also run over a
+ * `std::vector<std::tuple<APILayer, APILayerDetails>>`, which is what linters
+ * used before `LayerTable`.
+ */
+namespace FredEmmott::OpenXRLayers::Benchmarks {
+namespace {
+
+// Typical of layers that wrap several vendor extensions
+constexpr std::size_t ExtensionsPerLayer = 8;
+
+using TupleLayers = std::vector<std::tuple<APILayer, APILayerDetails>>;
+
+std::string MakeName(const std::size_t index) {
+  return std::format("XR_APILAYER_BENCHMARK_layer_{}", index);
+}
+
+/// Details as if loaded from a manifest, without touching the filesystem
+std::shared_ptr<const APILayerDetails> MakeDetails(const std::size_t index) {
+  // Does not exist, so the constructor returns before reading anything
+  APILayerDetails ret {std::filesystem::path {}};
+  // Some manifests are broken, so not every enabled layer is loaded
+  ret.mState = (index % 5) ? APILayerDetails::State::Loaded
+                           : APILayerDetails::State::InvalidJson;
+  ret.mName = MakeName(index);
+  ret.mLibraryPath = std::format("/opt/benchmark/layer_{}.so", index);
+  ret.mDescription = std::format("Benchmark layer {}", index);
+  ret.mAPIVersion = "1.0";
+  ret.mImplementationVersion = "1";
+  for (std::size_t i = 0; i < ExtensionsPerLayer; ++i) {
+    ret.mExtensions.push_back(
+      Extension {
+        .mName = std::format("XR_BENCHMARK_extension_{}_{}", index, i),
+        .mVersion = "1",
+      });
+  }
+  return std::make_shared<const APILayerDetails>(std::move(ret));
+}
+
+/// Print the tuple time divided by the `LayerTable` time; below 1 is slower
+void ReportSpeedup(const double tupleNs, const double tableNs) {
+  std::printf("%48s %14.2fx speedup over tuples\n", "", tupleNs / tableNs);
+}
+
+/// Run the same scan over both layouts, and report them together
+template <class TupleScan, class TableScan>
+void Compare(
+  const std::string_view name,
+  const std::size_t layerCount,
+  TupleScan&& tupleScan,
+  TableScan&& tableScan) {
+  const auto tupleNs
+    = Measure(std::format("Tuples/{}/{}", layerCount, name), [&] {
+        DoNotOptimize(tupleScan());
+      });
+  const auto tableNs
+    = Measure(std::format("LayerTable/{}/{}", layerCount, name), [&] {
+        DoNotOptimize(tableScan());
+      });
+  ReportSpeedup(tupleNs, tableNs);
+}
+
+void Benchmark(
+  const std::span<const BenchmarkStore, 2> stores,
+  const std::size_t layerCount) {
+  std::vector<APILayer> layers;
+  APILayerDetailsMap details;
+  TupleLayers tuples;
+  for (std::size_t i = 0; i < layerCount; ++i) {
+    const auto& layer = layers.emplace_back(
+      // Alternate between implicit and explicit layers
+      &stores[i % 2],
+      std::format("/opt/benchmark/layer_{}.json", i),
+      // Every third layer is disabled, so subsets are not the whole table
+      (i % 3) ? APILayer::Value::Enabled : APILayer::Value::Disabled);
+    const auto& layerDetails
+      = details.emplace(layer.GetManifestPath(), MakeDetails(i))
+          .first->second;
+    tuples.emplace_back(layer, *layerDetails);
+  }
+
+  Measure(std::format("LayerTable/{}", layerCount), [&] {
+    const LayerTable table {layers, details};
+    DoNotOptimize(table);
+  });
+
+  const LayerTable table {layers, details};
+  Measure(std::format("LayerTable/{}/Subset", layerCount), [&] {
+    const auto subset
+      = table.Subset(table.Select(LayerTable::Enabled & LayerTable::Loaded));
+    DoNotOptimize(subset);
+  });
+
+  Compare(
+    "CountEnabled",
+    layerCount,
+    [&] {
+      return std::ranges::count_if(tuples, [](const auto& row) {
+        return std::get<0>(row).IsEnabled();
+      });
+    },
+    [&] { return table.Count(LayerTable::Enabled); });
+
+  Compare(
+    "CountEnabledAndLoaded",
+    layerCount,
+    [&] {
+      return std::ranges::count_if(tuples, [](const auto& row) {
+        const auto& [layer, layerDetails] = row;
+        return layer.IsEnabled()
+          && layerDetails.mState == APILayerDetails::State::Loaded;
+      });
+    },
+    [&] { return table.Count(LayerTable::Enabled & LayerTable::Loaded); });
+
+  Compare(
+    "CountImplicit",
+    layerCount,
+    [&] {
+      return std::ranges::count_if(tuples, [](const auto& row) {
+        return std::get<0>(row).GetKind() == APILayer::Kind::Implicit;
+      });
+    },
+    [&] { return table.Count(LayerTable::Implicit); });
+
+  // The last layer, so both scan every row
+  const auto name = MakeName(layerCount - 1);
+  Compare(
+    "FindByName",
+    layerCount,
+    [&] {
+      return std::ranges::find_if(
+               tuples,
+               [&name](const auto& row) {
+                 return std::get<1>(row).mName == name;
+               })
+        - tuples.begin();
+    },
+    [&] {
+      // Interning is part of the lookup
+      const auto nameIDs = table.GetNameIDs();
+      return std::ranges::find(nameIDs, APILayer::Key {name})
+        - nameIDs.begin();
+    });
+}
+
+}// namespace
+}// namespace FredEmmott::OpenXRLayers::Benchmarks
+
+int main() {
+  using namespace FredEmmott::OpenXRLayers;
+  using namespace FredEmmott::OpenXRLayers::Benchmarks;
+  const std::array stores {
+    BenchmarkStore {APILayer::Kind::Explicit},
+    BenchmarkStore {APILayer::Kind::Implicit},
+  };
+  for (const auto layerCount: {10uz, 100uz, 10'000uz}) {
+    Benchmark(stores, layerCount);
+  }
+  return 0;
+}
@@ -0,0 +1,73 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <nlohmann/json.hpp>
+
+#include <cstddef>
+#include <cstdio>
+#include <format>
+#include <string>
+#include <string_view>
+
+#include "Benchmark.hpp"
+#include "BenchmarkLoaderData.hpp"
+#include "LoaderDataFormat.hpp"
+
+/** Encodes and decodes a typical `loader-data` response.
+ *
+ * The GUI decodes two of these per architecture for every refresh. Frames
+ * after a helper's first only include the environment's hash, so that is
+ * measured separately.
+ *
+ * For comparison, this also measures parsing the same data as JSON, which is
+ * what the helpers used to write.
+ */
+namespace FredEmmott::OpenXRLayers::Benchmarks {
+namespace {
+
+using namespace LoaderDataFormat;
+
+std::string GetPayload(std::string frame) {
+  return frame.substr(FrameHeaderSize);
+}
+
+/// Print the throughput for `bytes` taking `ns`
+void ReportThroughput(const std::size_t bytes, const double ns) {
+  // Bytes per nanosecond is gigabytes per second
+  std::printf(
+    "%48s %14.1f MB/s %13zu bytes\n", "", (bytes / ns) * 1000, bytes);
+}
+
+}// namespace
+}// namespace FredEmmott::OpenXRLayers::Benchmarks
+
+int main() {
+  using namespace FredEmmott::OpenXRLayers;
+  using namespace FredEmmott::OpenXRLayers::Benchmarks;
+
+  const auto data = MakeLoaderData();
+  const auto& environment = data.mEnvironmentVariablesBeforeLoader;
+  const auto full = GetPayload(EncodeFrame(data, EnvironmentEncoding::Full));
+  const auto hashOnly
+    = GetPayload(EncodeFrame(data, EnvironmentEncoding::HashOnly));
+  const auto json = nlohmann::json(data).dump();
+
+  Measure("LoaderDataFormat/Encode/Full", [&] {
+    DoNotOptimize(EncodeFrame(data, EnvironmentEncoding::Full));
+  });
+  Measure("LoaderDataFormat/Encode/HashOnly", [&] {
+    DoNotOptimize(EncodeFrame(data, EnvironmentEncoding::HashOnly));
+  });
+
+  ReportThroughput(full.size(), Measure("LoaderDataFormat/Decode/Full", [&] {
+    DoNotOptimize(Decode(full, nullptr));
+  }));
+  ReportThroughput(
+    hashOnly.size(), Measure("LoaderDataFormat/Decode/HashOnly", [&] {
+      DoNotOptimize(Decode(hashOnly, &environment));
+    }));
+  ReportThroughput(json.size(), Measure("JSON/Parse", [&] {
+    DoNotOptimize(nlohmann::json::parse(json).get<LoaderData>());
+  }));
+  return 0;
+}
@@ -0,0 +1,204 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "BenchmarkLoaderData.hpp"
+#include "LoaderDataFormat.hpp"
+#include "LoaderDataService.hpp"
+#include "Platform.hpp"
+
+/** Reads loader data from many threads at once, while it is republished.
+ *
+ * The GUI reads it for each architecture every frame, and linters read it from
+ * their own threads. `LoaderDataService::Get()` returns the published
+ * snapshot, so it should not slow down as readers are added, or while results
+ * are being published.
+ *
+ * For comparison, this also measures copying the data while holding a mutex,
+ * which is what readers did before the snapshots.
+ */
+namespace FredEmmott::OpenXRLayers::Benchmarks {
+namespace {
+
+using namespace std::chrono_literals;
+
+constexpr auto Arch = Platform::GetBuildArchitecture();
+constexpr std::array<std::size_t, 5> ReaderCounts {1, 2, 4, 16, 64};
+// How often the data is replaced while it is being read
+constexpr auto PublishInterval = 1ms;
+
+/// Responds immediately with the same data, without a process or pipes
+class BenchmarkLoaderDataServer final : public LoaderDataServer {
+ public:
+  BenchmarkLoaderDataServer() {
+    auto data = MakeLoaderData();
+    data.mIsComplete = false;
+    mResponse = LoaderDataFormat::EncodeFrame(
+      data, LoaderDataFormat::EnvironmentEncoding::Full);
+    data.mIsComplete = true;
+    mResponse += LoaderDataFormat::EncodeFrame(
+      data, LoaderDataFormat::EnvironmentEncoding::HashOnly);
+  }
+
+  std::expected<void, LoaderData::Error> SendQuery() override {
+    mBuffer += mResponse;
+    return {};
+  }
+
+  std::expected<std::string, LoaderData::Error> ReadResponse(
+    std::chrono::steady_clock::time_point,
+    std::stop_token) override {
+    auto frame = LoaderDataFormat::TakeFrame(mBuffer);
+    if (!frame) {
+      return std::unexpected {std::move(frame).error()};
+    }
+    if (!*frame) {
+      return std::unexpected {LoaderData::BadExitCodeError {}};
+    }
+    return std::move(**frame);
+  }
+
+ private:
+  std::string mResponse;
+  std::string mBuffer;
+};
+
+class BenchmarkLoaderDataSpawner final : public LoaderDataSpawner {
+ public:
+  std::expected<std::unique_ptr<LoaderDataServer>, LoaderData::Error>
+  SpawnServer(
+    Architecture,
+    const std::optional<std::filesystem::path>&) override {
+    return std::make_unique<BenchmarkLoaderDataServer>();
+  }
+
+  std::size_t GetServerFingerprint(Architecture) override {
+    return 0;
+  }
+};
+
+/** Call `read` on `readers` threads for `MinDuration`, while `publish` is
+ * called every `PublishInterval` on another thread.
+ */
+template <class Read, class Publish>
+void MeasureConcurrent(
+  const std::string_view name,
+  const std::size_t readers,
+  Read&& read,
+  Publish&& publish) {
+  std::atomic<bool> stop {false};
+  std::atomic<uint64_t> readCount {0};
+
+  std::jthread publisher {[&] {
+    while (!stop.load(std::memory_order_relaxed)) {
+      publish();
+      std::this_thread::sleep_for(PublishInterval);
+    }
+  }};
+  std::vector<std::jthread> threads;
+  const auto start = Clock::now();
+  for (std::size_t i = 0; i < readers; ++i) {
+    threads.emplace_back([&] {
+      uint64_t count {};
+      while (!stop.load(std::memory_order_relaxed)) {
+        read();
+        ++count;
+      }
+      readCount += count;
+    });
+  }
+
+  std::this_thread::sleep_for(MinDuration);
+  stop = true;
+  const auto elapsed = Clock::now() - start;
+  threads.clear();
+
+  // Across all readers, so this only improves with more readers if they
+  // don't contend; per reader, it would mostly measure the scheduler on
+  // machines with fewer cores than readers
+  Report(std::format("{}/{} readers", name, readers), elapsed, readCount);
+}
+
+void BenchmarkService(const std::size_t readers) {
+  LoaderDataService service {
+    std::make_unique<BenchmarkLoaderDataSpawner>(),
+    nullptr,
+    Architectures {Arch},
+    /* timeout = */ 5s,
+    /* debounce = */ 0ms,
+    /* maxConcurrentRuntimeQueries = */ 1,
+  };
+  if (!service.Wait(Arch, Clock::now() + 5s)) {
+    std::fprintf(stderr, "LoaderDataService did not respond\n");
+    return;
+  }
+
+  std::atomic<uint64_t> updates {0};
+  const auto connection = service.OnUpdate([&updates] { ++updates; });
+  MeasureConcurrent(
+    "LoaderDataService/Get",
+    readers,
+    [&service] {
+      const auto result = service.Get(Arch);
+      DoNotOptimize((*result)->mEnabledLayerNames.size());
+    },
+    [&service] { service.Invalidate(Arch); });
+  std::printf(
+    "%llu updates published\n",
+    static_cast<unsigned long long>(updates.load()));
+}
+
+void BenchmarkMutexCopy(const std::size_t readers) {
+  std::mutex mutex;
+  LoaderData published = MakeLoaderData();
+  const auto replacement = MakeLoaderData();
+
+  MeasureConcurrent(
+    "Mutex+Copy",
+    readers,
+    [&] {
+      LoaderData copy;
+      {
+        const std::unique_lock lock(mutex);
+        copy = published;
+      }
+      DoNotOptimize(copy.mEnabledLayerNames.size());
+    },
+    [&] {
+      const std::unique_lock lock(mutex);
+      published = replacement;
+    });
+}
+
+}// namespace
+}// namespace FredEmmott::OpenXRLayers::Benchmarks
+
+int main() {
+  using namespace FredEmmott::OpenXRLayers::Benchmarks;
+
+  for (auto&& readers: ReaderCounts) {
+    BenchmarkService(readers);
+  }
+  for (auto&& readers: ReaderCounts) {
+    BenchmarkMutexCopy(readers);
+  }
+  return 0;
+}
@@ -0,0 +1,107 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "BenchmarkStore.hpp"
+#include "StoreChangeQueue.hpp"
+
+/** Measures `StoreChangeQueue` under a change storm.
+ *
+ * Several producers push changes for the same few stores as fast as they can,
+ * while the consumer drains once per frame. The stores are never quiet for the
+ * debounce interval, so they are only reported because of the latency bound.
+ */
+namespace FredEmmott::OpenXRLayers::Benchmarks {
+namespace {
+
+using namespace std::chrono_literals;
+
+constexpr auto Debounce = 250ms;
+constexpr auto MaxLatency = 1s;
+constexpr auto StormDuration = 5s;
+constexpr auto FrameInterval = 16ms;
+constexpr std::size_t ProducerCount = 4;
+
+void BenchmarkPush(StoreChangeQueue& queue, const APILayerStore* store) {
+  uint64_t generation {};
+  Measure("StoreChangeQueue/Push/Uncontended", [&] {
+    queue.Push(store, ++generation);
+  });
+}
+
+void BenchmarkStorm(std::span<APILayerStore* const> stores) {
+  StoreChangeQueue queue {stores, Debounce, MaxLatency};
+
+  std::atomic<bool> stop {false};
+  std::atomic<uint64_t> pushCount {0};
+  std::vector<std::jthread> producers;
+  const auto start = Clock::now();
+  for (std::size_t i = 0; i < ProducerCount; ++i) {
+    producers.emplace_back([&, store = stores[i % stores.size()]] {
+      uint64_t generation {};
+      while (!stop.load(std::memory_order_relaxed)) {
+        queue.Push(store, ++generation);
+      }
+      pushCount += generation;
+    });
+  }
+
+  std::unordered_map<const APILayerStore*, Clock::time_point> lastReports;
+  Clock::duration maxGap {};
+  uint64_t reportCount {};
+  while (Clock::now() - start < StormDuration) {
+    std::this_thread::sleep_for(FrameInterval);
+    const auto now = Clock::now();
+    for (auto&& change: queue.Drain(now).mChanges) {
+      const auto [it, inserted] = lastReports.try_emplace(change.mStore, start);
+      maxGap = std::max(maxGap, now - it->second);
+      it->second = now;
+      ++reportCount;
+    }
+  }
+  stop = true;
+  const auto elapsed = Clock::now() - start;
+  producers.clear();
+
+  // Per producer, so this is the time each `Push()` takes under contention
+  Report("StoreChangeQueue/Push/Storm", elapsed, pushCount / ProducerCount);
+  std::printf(
+    "%llu reports for %zu stores; longest without a report: %lldms "
+    "(bound: %lldms, plus up to a frame)\n",
+    static_cast<unsigned long long>(reportCount),
+    stores.size(),
+    static_cast<long long>(
+      std::chrono::duration_cast<std::chrono::milliseconds>(maxGap).count()),
+    static_cast<long long>(
+      std::chrono::duration_cast<std::chrono::milliseconds>(MaxLatency)
+        .count()));
+}
+
+}// namespace
+}// namespace FredEmmott::OpenXRLayers::Benchmarks
+
+int main() {
+  using namespace FredEmmott::OpenXRLayers;
+  using namespace FredEmmott::OpenXRLayers::Benchmarks;
+
+  std::array<BenchmarkStore, 2> storage;
+  const std::array<APILayerStore*, 2> stores {&storage[0], &storage[1]};
+
+  {
+    StoreChangeQueue queue {stores, Debounce, MaxLatency};
+    BenchmarkPush(queue, stores.front());
+  }
+  BenchmarkStorm(stores);
+  return 0;
+}
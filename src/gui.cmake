@@ -1,4 +1,5 @@
 include(lib.cmake)
+include(known-layers.cmake)
 
 find_package(imgui CONFIG REQUIRED)
 
@@ -8,6 +9,7 @@ add_executable(
   GUI.cpp GUI.hpp
 )
 target_link_libraries(gui PRIVATE lib linters)
+add_dependencies(gui known-layers)
 
 set(OUTPUT_NAME "OpenXR-API-Layers-GUI")
 set_target_properties(
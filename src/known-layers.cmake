@@ -0,0 +1,37 @@
+include_guard(GLOBAL)
+
+# Host tool that compiles known-layers.json to the memory-mappable
+# known-layers.bin; see KnownLayersFormat.hpp
+add_executable(
+  known-layers-compiler
+  KnownLayersCompiler.cpp
+  KnownLayersFormat.hpp
+  Version.cpp Version.hpp
+)
+target_link_libraries(
+  known-layers-compiler
+  PRIVATE
+  nlohmann_json::nlohmann_json
+  magic_enum::magic_enum
+)
+target_include_directories(
+  known-layers-compiler
+  PRIVATE
+  "${CMAKE_CURRENT_SOURCE_DIR}"
+)
+# Not in CMAKE_RUNTIME_OUTPUT_DIRECTORY, as that is what we ship
+set_target_properties(
+  known-layers-compiler
+  PROPERTIES
+  RUNTIME_OUTPUT_DIRECTORY "${CMAKE_BINARY_DIR}/tools"
+)
+
+set(KNOWN_LAYERS_JSON "${CMAKE_CURRENT_SOURCE_DIR}/known-layers.json")
+set(KNOWN_LAYERS_BIN "${CMAKE_RUNTIME_OUTPUT_DIRECTORY}/known-layers.bin")
+add_custom_command(
+  OUTPUT "${KNOWN_LAYERS_BIN}"
+  COMMAND known-layers-compiler "${KNOWN_LAYERS_JSON}" "${KNOWN_LAYERS_BIN}"
+  DEPENDS known-layers-compiler "${KNOWN_LAYERS_JSON}"
+  VERBATIM
+)
+add_custom_target(known-layers DEPENDS "${KNOWN_LAYERS_BIN}")
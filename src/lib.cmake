@@ -12,18 +12,29 @@ add_library(
   APILayer.hpp
   APILayerDetails.cpp
   APILayerSignature.hpp
-  APILayerStore.hpp
+  APILayerStore.cpp APILayerStore.hpp
   Architectures.hpp
-  ConstexprString.hpp
+  ChangeJournal.cpp ChangeJournal.hpp
+  Compression.hpp
   EnabledExplicitAPILayerStore.cpp
   EnabledExplicitAPILayerStore.hpp
-  GUI.cpp
+  Environment.cpp Environment.hpp
+  FileLock.hpp
+  LayerStoreBackend.cpp LayerStoreBackend.hpp
+  LayerStoreTransaction.cpp LayerStoreTransaction.hpp
+  LayerTable.cpp LayerTable.hpp
   LoaderData.cpp LoaderData.hpp
+  LoaderDataCache.cpp LoaderDataCache.hpp
+  LoaderDataFormat.cpp LoaderDataFormat.hpp
+  LoaderDataService.cpp LoaderDataService.hpp
   OverridePathsAPILayerStore.cpp
   OverridePathsAPILayerStore.hpp
   SaveReport.cpp
+  StoreChangeQueue.cpp StoreChangeQueue.hpp
   Platform.cpp Platform.hpp
+  RuntimeMatrix.cpp RuntimeMatrix.hpp
   StringTemplateParameter.hpp
+  Version.cpp Version.hpp
 )
 
 # Using an OBJECT library instead of `STATIC`, because otherwise
@@ -33,13 +44,20 @@ add_library(
   OBJECT
   EXCLUDE_FROM_ALL
   Linter.cpp
+  KnownLayers.cpp KnownLayers.hpp
+  KnownLayersFormat.hpp
+  LayerRelations.cpp LayerRelations.hpp
   LayerRules.cpp
+  UserLayerRules.cpp UserLayerRules.hpp
   linters/BadInstallationLinter.cpp
   linters/DisabledByEnvironmentLinter.cpp
   linters/DuplicatesLinter.cpp
   linters/ExplicitLayerArchitecturesLinter.cpp
+  linters/KnownLayersLinter.cpp
   linters/OrderingLinter.cpp
+  linters/OverridePathsLinter.cpp
   linters/SkippedByLoaderLinter.cpp
+  linters/UserLayerRulesLinter.cpp
 )
 target_link_libraries(linters PUBLIC lib)
 target_include_directories(
@@ -54,23 +72,30 @@ target_link_libraries(
   nlohmann_json::nlohmann_json
   fmt::fmt-header-only
   OpenXR::headers
-  WIL::WIL
   config-hpp
-  imgui::imgui
   magic_enum::magic_enum
 )
 
 if (WIN32)
+  # WindowsPlatform also owns the window that the GUI draws into
+  target_link_libraries(lib PUBLIC WIL::WIL imgui::imgui)
   target_sources(
     lib
     PRIVATE
     windows/CheckForUpdates.cpp windows/CheckForUpdates.hpp
+    windows/RegistryLayerStoreBackend.cpp
+    windows/RegistryLayerStoreBackend.hpp
+    windows/WindowsCompression.cpp
+    windows/WindowsFileLock.cpp
+    windows/WindowsLoaderDataSpawner.cpp
+    windows/WindowsLoaderDataSpawner.hpp
     windows/WindowsAPILayerStore.cpp windows/WindowsAPILayerStore.hpp
     windows/WindowsPlatform.cpp windows/WindowsPlatform.hpp
   )
 
   set(
     WINDOWS_SDK_LIBRARIES
+    Cabinet
     Comctl32
     RuntimeObject
     Crypt32
@@ -92,13 +117,9 @@ if (WIN32)
     windows/WindowsPlatform.cpp
 
     linters/windows/NotADWORDLinter.cpp
-    linters/windows/OpenXRToolkitLinter.cpp
     linters/windows/OutdatedOpenKneeboardLinter.cpp
     linters/windows/ProgramFilesLinter.cpp
-    linters/windows/UltraleapLastLinter.cpp
     linters/windows/UnsignedDllLinter.cpp
-    linters/windows/ViveLayersLinter.cpp
-    linters/windows/XRNeckSaferLinter.cpp
   )
 
   target_compile_definitions(
@@ -121,3 +142,13 @@ if (WIN32)
     )
   endif ()
 endif ()
+
+if (UNIX)
+  target_sources(
+    lib
+    PRIVATE
+    posix/PosixCompression.cpp
+    posix/PosixFileLock.cpp
+    posix/PosixLoaderDataSpawner.cpp posix/PosixLoaderDataSpawner.hpp
+  )
+endif ()
@@ -15,7 +15,7 @@ namespace FredEmmott::OpenXRLayers {
 class BadInstallationLinter final : public Linter {
   virtual std::vector<std::shared_ptr<LintError>> Lint(
     const APILayerStore*,
-    const std::vector<std::tuple<APILayer, APILayerDetails>>& layers) {
+    const LayerTable& layers) {
     std::vector<std::shared_ptr<LintError>> errors;
     for (const auto& [layer, details]: layers) {
       if (layer.mValue == APILayer::Value::EnabledButAbsent) {
@@ -24,15 +24,15 @@ class BadInstallationLinter final : public Linter {
           std::make_shared<InvalidLayerLintError>(
             fmt::format(
               "`{}` is in XR_ENABLE_API_LAYERS, but is not installed",
-              layer.GetKey().mValue),
+              layer.GetKey().GetValue()),
             layer));
         continue;
       }
-      if (layer.mManifestPath.empty()) {
+      if (layer.GetManifestPath().empty()) {
         errors.push_back(
           std::make_shared<InvalidLayerLintError>(
             fmt::format(
-              "Layer `{}` has empty manifest path", layer.GetKey().mValue),
+              "Layer `{}` has empty manifest path", layer.GetKey().GetValue()),
             layer));
         continue;
       }
@@ -42,7 +42,7 @@ class BadInstallationLinter final : public Linter {
           std::make_shared<InvalidLayerLintError>(
             fmt::format(
               "Unable to load details from the manifest file `{}`",
-              layer.mManifestPath.string()),
+              layer.GetDisplayPath()),
             layer));
         continue;
       }
@@ -52,7 +52,7 @@ class BadInstallationLinter final : public Linter {
           std::make_shared<InvalidLayerLintError>(
             fmt::format(
               "Layer does not specify an implementation in `{}`",
-              layer.mManifestPath.string()),
+              layer.GetDisplayPath()),
             layer));
         continue;
       }
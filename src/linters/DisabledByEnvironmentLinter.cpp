@@ -9,7 +9,7 @@ namespace FredEmmott::OpenXRLayers {
 class DisabledByEnvironmentLinter final : public Linter {
   virtual std::vector<std::shared_ptr<LintError>> Lint(
     const APILayerStore*,
-    const std::vector<std::tuple<APILayer, APILayerDetails>>& layers) {
+    const LayerTable& layers) {
     std::vector<std::shared_ptr<LintError>> errors;
 
     for (const auto& [layer, details]: layers) {
@@ -28,7 +28,7 @@ class DisabledByEnvironmentLinter final : public Linter {
             fmt::format(
               "Layer `{}` is disabled, because required environment variable "
               "`{}` is not set",
-              layer.mManifestPath.string(),
+              layer.GetDisplayPath(),
               enableEnv),
             LayerKeySet {layer}));
       }
@@ -39,7 +39,7 @@ class DisabledByEnvironmentLinter final : public Linter {
           std::make_shared<LintError>(
             fmt::format(
               "Layer `{}` does not define a `disable_environment` key",
-              layer.mManifestPath.string()),
+              layer.GetDisplayPath()),
             LayerKeySet {layer}));
         continue;
       }
@@ -50,7 +50,7 @@ class DisabledByEnvironmentLinter final : public Linter {
           std::make_shared<LintError>(
             fmt::format(
               "Layer `{}` is disabled by environment variable `{}`",
-              layer.mManifestPath.string(),
+              layer.GetDisplayPath(),
               disableEnv),
             LayerKeySet {layer}));
       }
@@ -15,22 +15,13 @@ class DuplicatesLinter final : public Linter {
  public:
   virtual std::vector<std::shared_ptr<LintError>> Lint(
     const APILayerStore*,
-    const std::vector<std::tuple<APILayer, APILayerDetails>>& layers) {
-    std::unordered_map<std::string, LayerKeySet> byName;
-    for (const auto& [layer, details]: layers) {
-      if (!layer.IsEnabled()) {
-        continue;
-      }
-
-      if (details.mState != APILayerDetails::State::Loaded) {
-        continue;
-      }
-
-      if (byName.contains(details.mName)) {
-        byName.at(details.mName).emplace(layer);
-      } else {
-        byName[details.mName] = {layer};
-      }
+    const LayerTable& layers) {
+    const auto names = layers.GetNameIDs();
+    const auto paths = layers.GetPathIDs();
+    constexpr auto filter = LayerTable::Enabled & LayerTable::Loaded;
+    std::unordered_map<APILayer::Key, LayerKeySet> byName;
+    for (const auto i: layers.Select(filter)) {
+      byName[names[i]].emplace(paths[i]);
     }
 
     std::vector<std::shared_ptr<LintError>> errors;
@@ -39,9 +30,10 @@ class DuplicatesLinter final : public Linter {
         continue;
       }
 
-      auto text = fmt::format("Multiple copies of {} are enabled:", name);
+      auto text
+        = fmt::format("Multiple copies of {} are enabled:", name.GetValue());
       for (auto&& key: keys) {
-        text += fmt::format("\n- {}", key.mValue);
+        text += fmt::format("\n- {}", key.GetValue());
       }
 
       errors.push_back(std::make_shared<LintError>(text, keys));
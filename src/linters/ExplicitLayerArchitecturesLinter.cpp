@@ -42,14 +42,14 @@ static std::string to_string(const Architectures architectures) {
 class ExplicitLayerArchitecturesLinter final : public Linter {
   std::vector<std::shared_ptr<LintError>> Lint(
     const APILayerStore* const store,
-    const std::vector<std::tuple<APILayer, APILayerDetails>>& layers) override {
+    const LayerTable& layers) override {
     if (store->GetKind() != APILayer::Kind::Explicit) {
       return {};
     }
     std::vector<std::shared_ptr<LintError>> errors;
     const auto storeArchitectures = store->GetArchitectures();
     for (auto&& layer: std::views::elements<0>(layers)) {
-      if (layer.mManifestPath.empty()) {
+      if (layer.GetManifestPath().empty()) {
         continue;
       }
       if (!layer.IsEnabled()) {
@@ -66,7 +66,7 @@ class ExplicitLayerArchitecturesLinter final : public Linter {
           "Layer `{}` is enabled via the XR_ENABLE_API_LAYERS environment "
           "variable, but is only available on {}; {} applications may have "
           "errors or crash.",
-          layer.GetKey().mValue,
+          layer.GetKey().GetValue(),
           to_string(layer.mArchitectures),
           to_string(Architectures {static_cast<Architecture>(missing)})),
         {layer}));
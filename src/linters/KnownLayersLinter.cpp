@@ -0,0 +1,159 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <optional>
+#include <ranges>
+
+#include "APILayerStore.hpp"
+#include "KnownLayers.hpp"
+#include "Linter.hpp"
+#include "Platform.hpp"
+
+namespace FredEmmott::OpenXRLayers {
+
+namespace {
+
+class MoveToEndLintError final : public FixableLintError {
+ public:
+  MoveToEndLintError(const std::string& description, const APILayer& layer)
+    : FixableLintError(description, {layer}),
+      mLayer(layer) {}
+
+  std::vector<APILayer> Fix(const std::vector<APILayer>& allLayers) override {
+    auto ret = allLayers;
+    const auto it = std::ranges::find(ret, mLayer);
+    if (it != ret.end()) {
+      std::rotate(it, std::next(it), ret.end());
+    }
+    return ret;
+  }
+
+ private:
+  APILayer::Key mLayer;
+};
+
+// The active runtime's name, if it is *not* one of `allowed`
+std::optional<std::string> GetDisallowedRuntime(
+  const Architectures architectures,
+  const std::vector<std::string_view>& allowed) {
+  const auto arch = architectures.get_only();
+  if (arch == Architecture::Invalid) {
+    return std::nullopt;
+  }
+  const auto runtime = Platform::Get().GetActiveRuntime(arch);
+  if (!(runtime && runtime->mManifestData)) {
+    return std::nullopt;
+  }
+  const auto& name = runtime->mManifestData->mName;
+  if (std::ranges::contains(allowed, name)) {
+    return std::nullopt;
+  }
+  return name;
+}
+
+/** Format the entry's advisory text.
+ *
+ * Advisories can use these `fmt` named arguments:
+ * - `{name}`: the layer name
+ * - `{vendor}`: the vendor from the database
+ * - `{path}`: the manifest path
+ * - `{version}`: the implementation version
+ * - `{runtime}`: the active runtime, if it is not one of the required runtimes
+ */
+std::string FormatAdvisory(
+  const KnownLayers::Entry& entry,
+  const APILayer& layer,
+  const APILayerDetails& details,
+  const std::string_view runtime) {
+  try {
+    return fmt::format(
+      fmt::runtime(entry.mAdvisory),
+      fmt::arg("name", details.mName),
+      fmt::arg("vendor", entry.mVendor),
+      fmt::arg("path", layer.GetDisplayPath()),
+      fmt::arg("version", details.mImplementationVersion),
+      fmt::arg("runtime", runtime));
+  } catch (const fmt::format_error&) {
+    return std::string {entry.mAdvisory};
+  }
+}
+
+}// namespace
+
+// Check layers against the known layers database
+class KnownLayersLinter final : public Linter {
+ public:
+  std::vector<std::shared_ptr<LintError>> Lint(
+    const APILayerStore* store,
+    const LayerTable& layers) override {
+    const auto db = KnownLayers::Get();
+    if (db->size() == 0) {
+      return {};
+    }
+
+    const auto architectures = store->GetArchitectures();
+    const auto lastEnabled = layers.FindLast(LayerTable::Enabled);
+
+    std::vector<std::shared_ptr<LintError>> errors;
+    for (std::size_t i = 0; i < layers.size(); ++i) {
+      const auto& [layer, details] = layers[i];
+      const auto entry = db->Find(details.mName);
+      if (!entry) {
+        continue;
+      }
+      const auto isEnabled = layers.Matches(i, LayerTable::Enabled);
+      if (!(isEnabled || entry->mIncludeDisabled)) {
+        continue;
+      }
+      if (
+        entry->mArchitectures != Architectures {Architecture::Invalid}
+        && !entry->mArchitectures.contains(architectures)) {
+        continue;
+      }
+      if (!entry->mBadVersions.empty()) {
+        const auto& version = details.mParsedImplementationVersion;
+        if (!(version && entry->IsBadVersion(*version))) {
+          continue;
+        }
+      }
+      if (entry->mMustBeLast && i == lastEnabled) {
+        continue;
+      }
+
+      std::string runtime;
+      if (!entry->mRequiredRuntimes.empty()) {
+        const auto disallowed
+          = GetDisallowedRuntime(architectures, entry->mRequiredRuntimes);
+        if (!disallowed) {
+          continue;
+        }
+        runtime = *disallowed;
+      }
+
+      const auto description = FormatAdvisory(*entry, layer, details, runtime);
+      using enum KnownLayersFormat::Action;
+      switch (entry->mAction) {
+        case Disable:
+          errors.push_back(
+            std::make_shared<KnownBadLayerLintError>(description, layer));
+          break;
+        case Remove:
+          errors.push_back(
+            std::make_shared<InvalidLayerLintError>(description, layer));
+          break;
+        case MoveToEnd:
+          errors.push_back(
+            std::make_shared<MoveToEndLintError>(description, layer));
+          break;
+      }
+    }
+    return errors;
+  }
+};
+
+static KnownLayersLinter gInstance;
+
+}// namespace FredEmmott::OpenXRLayers
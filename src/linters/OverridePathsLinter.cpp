@@ -0,0 +1,38 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <format>
+
+#include "Linter.hpp"
+#include "OverridePathsAPILayerStore.hpp"
+
+namespace FredEmmott::OpenXRLayers {
+
+// Report `XR_API_LAYER_PATH` directories that can't be read; the loader
+// silently skips them
+class OverridePathsLinter final : public Linter {
+ public:
+  std::vector<std::shared_ptr<LintError>> Lint(
+    const APILayerStore* store,
+    const LayerTable&) override {
+    const auto overridePaths
+      = dynamic_cast<const OverridePathsAPILayerStore*>(store);
+    if (!overridePaths) {
+      return {};
+    }
+
+    std::vector<std::shared_ptr<LintError>> errors;
+    for (auto&& [path, error]: overridePaths->GetScanErrors()) {
+      errors.push_back(std::make_shared<LintError>(
+        std::format(
+          "Can't read `XR_API_LAYER_PATH` directory `{}`: {}",
+          path.string(),
+          error.message()),
+        LayerKeySet {}));
+    }
+    return errors;
+  }
+};
+
+static OverridePathsLinter gInstance;
+}// namespace FredEmmott::OpenXRLayers
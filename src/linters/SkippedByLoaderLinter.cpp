@@ -13,7 +13,7 @@ class SkippedByLoaderLinter final : public Linter {
  public:
   virtual std::vector<std::shared_ptr<LintError>> Lint(
     const APILayerStore* store,
-    const std::vector<std::tuple<APILayer, APILayerDetails>>& layers) {
+    const LayerTable& layers) {
     std::vector<std::shared_ptr<LintError>> errors;
 
     for (const auto arch: store->GetArchitectures().enumerate()) {
@@ -26,11 +26,13 @@ class SkippedByLoaderLinter final : public Linter {
   static void Lint(
     std::back_insert_iterator<std::vector<std::shared_ptr<LintError>>> out,
     const Architecture arch,
-    const std::vector<std::tuple<APILayer, APILayerDetails>>& layers) {
-    const auto loaderData = Platform::Get().GetLoaderData(arch);
-    if (!loaderData) {
+    const LayerTable& layers) {
+    const auto result = Platform::Get().GetLoaderData(arch);
+    // Don't report layers that may already have been fixed
+    if (!result || (*result)->mIsRefreshing) {
       return;
     }
+    const auto& loaderData = *result;
 
     const auto runtime = Platform::Get().GetActiveRuntime();
     if (!runtime) {
@@ -72,14 +74,13 @@ class SkippedByLoaderLinter final : public Linter {
         if (std::getenv(disableEnv.c_str())) {
           continue;
         }
-        if (
-          loaderData->mEnvironmentVariablesAfterLoader.contains(disableEnv)
-          && !loaderData->mEnvironmentVariablesBeforeLoader.contains(
-            disableEnv)) {
+        const auto change
+          = FindChange(loaderData->mEnvironmentVariableChanges, disableEnv);
+        if (change && !change->mBefore) {
           *out = std::make_shared<LintError>(
             fmt::format(
               "Layer `{}` is blocked by your current OpenXR runtime ('{}')",
-              layer.mManifestPath.string(),
+              layer.GetDisplayPath(),
               runtimeManifest->mName),
             LayerKeySet {layer});
           continue;
@@ -90,7 +91,7 @@ class SkippedByLoaderLinter final : public Linter {
         fmt::format(
           "Layer `{}` appears enabled, but is not loaded by OpenXR; it may "
           "be blocked by your OpenXR runtime ('{}')",
-          layer.mManifestPath.string(),
+          layer.GetDisplayPath(),
           runtimeManifest->mName),
         LayerKeySet {layer});
     }
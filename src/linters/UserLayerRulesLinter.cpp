@@ -0,0 +1,32 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <format>
+
+#include "Linter.hpp"
+#include "UserLayerRules.hpp"
+
+namespace FredEmmott::OpenXRLayers {
+
+// Report problems with the user's rules file
+class UserLayerRulesLinter final : public Linter {
+ public:
+  std::vector<std::shared_ptr<LintError>> Lint(
+    const APILayerStore*,
+    const LayerTable&) override {
+    auto& rules = UserLayerRules::Get();
+    const auto path = rules.GetPath();
+
+    std::vector<std::shared_ptr<LintError>> errors;
+    for (auto&& diagnostic: rules.GetDiagnostics()) {
+      errors.push_back(std::make_shared<LintError>(
+        std::format(
+          "Rules from {} may be ignored: {}", path.string(), diagnostic),
+        LayerKeySet {}));
+    }
+    return errors;
+  }
+};
+
+static UserLayerRulesLinter gInstance;
+}// namespace FredEmmott::OpenXRLayers
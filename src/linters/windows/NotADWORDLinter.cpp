@@ -11,7 +11,7 @@ namespace FredEmmott::OpenXRLayers {
 class NotADWORDLinter final : public Linter {
   virtual std::vector<std::shared_ptr<LintError>> Lint(
     const APILayerStore*,
-    const std::vector<std::tuple<APILayer, APILayerDetails>>& layers) {
+    const LayerTable& layers) {
     std::vector<std::shared_ptr<LintError>> ret;
     for (const auto& [layer, details]: layers) {
       if (layer.mValue != APILayer::Value::Win32_NotDWORD) {
@@ -23,7 +23,7 @@ class NotADWORDLinter final : public Linter {
             "OpenXR requires that layer registry values are DWORDs; `{}` has a "
             "different type. This can cause various issues with other layers "
             "or games.",
-            layer.mManifestPath.string()),
+            layer.GetDisplayPath()),
           layer));
     }
     return ret;
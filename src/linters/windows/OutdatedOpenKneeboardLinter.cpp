@@ -16,10 +16,14 @@ namespace FredEmmott::OpenXRLayers {
 // These old versions used MSIX, which can lead to ACL issues. While
 // installing a new version will automatically clean these up,
 // it's then still possible to co-install an old msix afterwards.
+//
+// The even older `XR_APILAYER_NOVENDOR_OpenKneeboard` name is in the known
+// layers database instead; this linter only has the heuristics that the
+// database can not express.
 class OutdatedOpenKneeboardLinter final : public Linter {
   virtual std::vector<std::shared_ptr<LintError>> Lint(
     const APILayerStore* store,
-    const std::vector<std::tuple<APILayer, APILayerDetails>>& layers) {
+    const LayerTable& layers) {
     const auto winStore = dynamic_cast<const WindowsAPILayerStore*>(store);
     if (
       (!winStore)
@@ -30,16 +34,11 @@ class OutdatedOpenKneeboardLinter final : public Linter {
 
     std::vector<std::shared_ptr<LintError>> errors;
     for (const auto& [layer, details]: layers) {
-      bool outdated = false;
-      if (details.mName == "XR_APILAYER_NOVENDOR_OpenKneeboard") {
-        outdated = true;
-      } else if (details.mName != "XR_APILAYER_FREDEMMOTT_OpenKneeboard") {
+      if (details.mName != "XR_APILAYER_FREDEMMOTT_OpenKneeboard") {
         continue;
       }
 
-      if (winStore->GetRootKey() == HKEY_CURRENT_USER) {
-        outdated = true;
-      }
+      bool outdated = (winStore->GetRootKey() == HKEY_CURRENT_USER);
 
       if (!outdated) {
         const std::string path = details.mLibraryPath.string();
@@ -60,7 +59,7 @@ class OutdatedOpenKneeboardLinter final : public Linter {
             "{} is from an extremely outdated version of OpenKneeboard, which "
             "may cause issues. Remove this API layer, install updates, and "
             "remove any left over old versions from 'Add or Remove Programs'.",
-            layer.mManifestPath.string()),
+            layer.GetDisplayPath()),
           layer));
     }
     return errors;
@@ -17,7 +17,7 @@ namespace FredEmmott::OpenXRLayers {
 class ProgramFilesLinter final : public Linter {
   std::vector<std::shared_ptr<LintError>> Lint(
     const APILayerStore* store,
-    const std::vector<std::tuple<APILayer, APILayerDetails>>& layers) override {
+    const LayerTable& layers) override {
     const auto winStore = dynamic_cast<const WindowsAPILayerStore*>(store);
     if (!winStore) {
       return {};
@@ -13,7 +13,7 @@ namespace FredEmmott::OpenXRLayers {
 class UnsignedDllLinter final : public Linter {
   virtual std::vector<std::shared_ptr<LintError>> Lint(
     const APILayerStore*,
-    const std::vector<std::tuple<APILayer, APILayerDetails>>& layers) {
+    const LayerTable& layers) {
     std::vector<std::shared_ptr<LintError>> errors;
     for (const auto& [layer, details]: layers) {
       if (!layer.IsEnabled()) {
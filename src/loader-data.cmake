@@ -26,7 +26,7 @@ else ()
     set(TARGET_ARCH_DEFAULT x86)
   endif ()
   if (NOT TARGET_ARCH)
-    cmake(WARNING "CMAKE_CXX_COMPILER_ARCHITECTURE_ID is not set; assuming ${TARGET_ARCH_DEFAULT}")
+    message(WARNING "CMAKE_CXX_COMPILER_ARCHITECTURE_ID is not set; assuming ${TARGET_ARCH_DEFAULT}")
   endif ()
 endif ()
 set(TARGET_ARCH "${TARGET_ARCH_DEFAULT}" CACHE STRING "Target architecture")
@@ -52,4 +52,6 @@ if (WIN32)
     windows/wWinMain-loader-data.cpp
     "${CODEGEN_BUILD_DIR}/create-report-version.rc"
   )
+else ()
+  target_sources(loader-data PRIVATE posix/main-loader-data.cpp)
 endif ()
\ No newline at end of file
@@ -0,0 +1,22 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "Compression.hpp"
+
+namespace FredEmmott::OpenXRLayers::Compression {
+
+Compressed Compress(const std::string_view data) {
+  return {Algorithm::None, std::string {data}};
+}
+
+std::optional<std::string> Decompress(
+  const Algorithm algorithm,
+  const std::string_view data,
+  const std::size_t decompressedSize) {
+  if (algorithm != Algorithm::None || data.size() != decompressedSize) {
+    return std::nullopt;
+  }
+  return std::string {data};
+}
+
+}// namespace FredEmmott::OpenXRLayers::Compression
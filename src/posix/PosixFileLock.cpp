@@ -0,0 +1,39 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "FileLock.hpp"
+
+#include <cerrno>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+namespace FredEmmott::OpenXRLayers {
+
+struct FileLock::Impl {
+  int mFD {-1};
+};
+
+FileLock::FileLock(const std::filesystem::path& path) {
+  const auto fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (fd == -1) {
+    return;
+  }
+  while (flock(fd, LOCK_EX) == -1) {
+    if (errno != EINTR) {
+      close(fd);
+      return;
+    }
+  }
+  mImpl.reset(new Impl {fd});
+}
+
+FileLock::~FileLock() {
+  if (mImpl) {
+    // Also releases the lock
+    close(mImpl->mFD);
+  }
+}
+
+}// namespace FredEmmott::OpenXRLayers
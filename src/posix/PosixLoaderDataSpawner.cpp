@@ -0,0 +1,342 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "posix/PosixLoaderDataSpawner.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <format>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "LoaderDataFormat.hpp"
+
+extern char** environ;
+
+namespace FredEmmott::OpenXRLayers {
+
+namespace {
+
+class UniqueFD final {
+ public:
+  UniqueFD() = default;
+  explicit UniqueFD(const int fd) : mFD(fd) {}
+  ~UniqueFD() {
+    reset();
+  }
+
+  UniqueFD(const UniqueFD&) = delete;
+  UniqueFD& operator=(const UniqueFD&) = delete;
+  UniqueFD(UniqueFD&& other) noexcept : mFD(std::exchange(other.mFD, -1)) {}
+  UniqueFD& operator=(UniqueFD&& other) noexcept {
+    reset(std::exchange(other.mFD, -1));
+    return *this;
+  }
+
+  [[nodiscard]]
+  int get() const noexcept {
+    return mFD;
+  }
+
+  void reset(const int fd = -1) noexcept {
+    if (mFD >= 0) {
+      close(mFD);
+    }
+    mFD = fd;
+  }
+
+  explicit operator bool() const noexcept {
+    return mFD >= 0;
+  }
+
+ private:
+  int mFD {-1};
+};
+
+template <class T>
+std::unexpected<T> UnexpectedErrno(const int error = errno) {
+  return std::unexpected {
+    T {{error, std::generic_category()}},
+  };
+}
+
+class PosixLoaderDataServer final : public LoaderDataServer {
+ public:
+  static constexpr std::chrono::milliseconds CancellationPollInterval {50};
+
+  PosixLoaderDataServer(
+    const pid_t pid,
+    UniqueFD stdinWritePipe,
+    UniqueFD stdoutReadPipe)
+    : mPID(pid),
+      mStdinWritePipe(std::move(stdinWritePipe)),
+      mStdoutReadPipe(std::move(stdoutReadPipe)) {}
+
+  ~PosixLoaderDataServer() override {
+    if (mPID > 0) {
+      kill(mPID, SIGKILL);
+      Reap();
+    }
+  }
+
+  std::expected<void, LoaderData::Error> SendQuery() override {
+    ThrowIfExited();
+    const auto request = std::format("{}\n", QueryRequest);
+    if (!WriteAll(request)) {
+      return std::unexpected {Exited()};
+    }
+    return {};
+  }
+
+  std::expected<std::string, LoaderData::Error> ReadResponse(
+    const std::chrono::steady_clock::time_point deadline,
+    const std::stop_token cancel) override {
+    ThrowIfExited();
+    const auto started = std::chrono::steady_clock::now();
+
+    while (true) {
+      auto frame = LoaderDataFormat::TakeFrame(mBuffer);
+      if (!frame) {
+        return std::unexpected {std::move(frame).error()};
+      }
+      if (*frame) {
+        return std::move(**frame);
+      }
+
+      // Anything already read stays in `mBuffer` for the next call
+      if (cancel.stop_requested()) {
+        return std::unexpected {LoaderData::PendingError {}};
+      }
+
+      const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(
+        deadline - std::chrono::steady_clock::now());
+      if (remaining.count() <= 0) {
+        kill(mPID, SIGKILL);
+        Reap();
+        const auto timeout
+          = std::chrono::ceil<std::chrono::milliseconds>(deadline - started);
+        return std::unexpected {LoaderData::TimeoutError {timeout}};
+      }
+
+      pollfd fd {.fd = mStdoutReadPipe.get(), .events = POLLIN};
+      // Wake up periodically to check for cancellation
+      const auto timeoutMS = static_cast<int>(
+        std::min<int64_t>(remaining.count(), CancellationPollInterval.count()));
+      const auto ready = poll(&fd, 1, timeoutMS);
+      if (ready < 0 && errno != EINTR) {
+        return std::unexpected {Exited()};
+      }
+      if (ready <= 0) {
+        continue;
+      }
+
+      // Responses are usually tens of kilobytes
+      char buffer[64 * 1024];
+      const auto bytesRead
+        = read(mStdoutReadPipe.get(), buffer, sizeof(buffer));
+      if (bytesRead < 0 && errno == EINTR) {
+        continue;
+      }
+      if (bytesRead <= 0) {
+        return std::unexpected {Exited()};
+      }
+      mBuffer.append(buffer, static_cast<std::size_t>(bytesRead));
+    }
+  }
+
+ private:
+  pid_t mPID {-1};
+  UniqueFD mStdinWritePipe;
+  UniqueFD mStdoutReadPipe;
+  // Output after the last complete response
+  std::string mBuffer;
+
+  void ThrowIfExited() const {
+    if (mPID <= 0) {
+      throw std::logic_error("LoaderDataServer used after the helper exited");
+    }
+  }
+
+  bool WriteAll(std::string_view data) {
+    while (!data.empty()) {
+      const auto written
+        = write(mStdinWritePipe.get(), data.data(), data.size());
+      if (written < 0 && errno == EINTR) {
+        continue;
+      }
+      if (written <= 0) {
+        return false;
+      }
+      data.remove_prefix(static_cast<std::size_t>(written));
+    }
+    return true;
+  }
+
+  LoaderData::BadExitCodeError Exited() {
+    mStdinWritePipe.reset();
+    mStdoutReadPipe.reset();
+    const auto status = Reap();
+    if (!WIFEXITED(status)) {
+      // Report signals like a shell does
+      return {128 + static_cast<uint32_t>(WTERMSIG(status))};
+    }
+    return {static_cast<uint32_t>(WEXITSTATUS(status))};
+  }
+
+  int Reap() {
+    int status {};
+    while (waitpid(mPID, &status, 0) < 0 && errno == EINTR) {
+    }
+    mPID = -1;
+    return status;
+  }
+};
+
+}// namespace
+
+PosixLoaderDataSpawner::PosixLoaderDataSpawner(
+  std::filesystem::path helperDirectory)
+  : mHelperDirectory(std::move(helperDirectory)) {
+  // Otherwise, writing to a helper that has exited kills us instead of
+  // failing with `EPIPE`
+  signal(SIGPIPE, SIG_IGN);
+}
+
+PosixLoaderDataSpawner::~PosixLoaderDataSpawner() = default;
+
+std::expected<std::unique_ptr<LoaderDataServer>, LoaderData::Error>
+PosixLoaderDataSpawner::SpawnServer(
+  const Architecture arch,
+  const std::optional<std::filesystem::path>& runtime) {
+  const auto helper = mHelperDirectory / GetHelperFileName(arch);
+  if (!exists(helper)) {
+    return std::unexpected {
+      LoaderData::CanNotFindHelperExecutableError {helper}};
+  }
+
+  int stdinFDs[2];
+  if (pipe(stdinFDs) != 0) {
+    return UnexpectedErrno<LoaderData::PipeCreationError>();
+  }
+  UniqueFD stdinRead {stdinFDs[0]};
+  UniqueFD stdinWrite {stdinFDs[1]};
+  int stdoutFDs[2];
+  if (pipe(stdoutFDs) != 0) {
+    return UnexpectedErrno<LoaderData::PipeCreationError>();
+  }
+  UniqueFD stdoutRead {stdoutFDs[0]};
+  UniqueFD stdoutWrite {stdoutFDs[1]};
+  // None of these should be inherited as-is; the helper's ends are duplicated
+  // to stdin and stdout, which clears the flag on the copies
+  for (auto&& fd: {
+         stdinRead.get(),
+         stdinWrite.get(),
+         stdoutRead.get(),
+         stdoutWrite.get(),
+       }) {
+    if (fcntl(fd, F_SETFD, FD_CLOEXEC) != 0) {
+      return UnexpectedErrno<LoaderData::PipeAttributeError>();
+    }
+  }
+
+  posix_spawn_file_actions_t actions;
+  posix_spawn_file_actions_init(&actions);
+  posix_spawn_file_actions_adddup2(&actions, stdinRead.get(), STDIN_FILENO);
+  posix_spawn_file_actions_adddup2(&actions, stdoutWrite.get(), STDOUT_FILENO);
+
+  const auto helperString = helper.string();
+  std::string flag {LoaderDataServer::CommandLineFlag};
+  char* const argv[] {
+    const_cast<char*>(helperString.c_str()),
+    flag.data(),
+    nullptr,
+  };
+
+  char** envp = environ;
+  std::vector<std::string> overriddenEnvironment;
+  std::vector<char*> overriddenEnvp;
+  if (runtime) {
+    constexpr std::string_view RuntimeVariable {"XR_RUNTIME_JSON="};
+    for (auto it = environ; it && *it; ++it) {
+      if (!std::string_view {*it}.starts_with(RuntimeVariable)) {
+        overriddenEnvironment.emplace_back(*it);
+      }
+    }
+    overriddenEnvironment.push_back(
+      std::format("{}{}", RuntimeVariable, runtime->string()));
+    for (auto&& entry: overriddenEnvironment) {
+      overriddenEnvp.push_back(entry.data());
+    }
+    overriddenEnvp.push_back(nullptr);
+    envp = overriddenEnvp.data();
+  }
+
+  pid_t pid {};
+  const auto error
+    = posix_spawn(&pid, helperString.c_str(), &actions, nullptr, argv, envp);
+  posix_spawn_file_actions_destroy(&actions);
+  if (error != 0) {
+    return UnexpectedErrno<LoaderData::CanNotSpawnError>(error);
+  }
+
+  return std::make_unique<PosixLoaderDataServer>(
+    pid, std::move(stdinWrite), std::move(stdoutRead));
+}
+
+std::size_t PosixLoaderDataSpawner::GetServerFingerprint(
+  const Architecture arch) {
+  // The helpers inherit our environment, which includes `XR_RUNTIME_JSON`
+  std::string fingerprint;
+  for (auto it = environ; it && *it; ++it) {
+    fingerprint += *it;
+    fingerprint += '\0';
+  }
+
+  const auto appendFile = [&fingerprint](const std::filesystem::path& path) {
+    fingerprint += path.string();
+    fingerprint += '\0';
+    std::error_code ec;
+    const auto changed = std::filesystem::last_write_time(path, ec);
+    if (!ec) {
+      fingerprint += std::to_string(changed.time_since_epoch().count());
+    }
+    fingerprint += '\0';
+  };
+
+  // Otherwise, the active runtime is usually a symlink to the runtime's
+  // manifest
+  std::vector<std::filesystem::path> configDirs;
+  if (const auto configHome = getenv("XDG_CONFIG_HOME")) {
+    configDirs.emplace_back(configHome);
+  } else if (const auto home = getenv("HOME")) {
+    configDirs.emplace_back(std::filesystem::path {home} / ".config");
+  }
+  configDirs.emplace_back("/etc/xdg");
+  configDirs.emplace_back("/etc");
+  for (auto&& dir: configDirs) {
+    std::error_code ec;
+    const auto runtime = std::filesystem::canonical(
+      dir / "openxr" / "1" / "active_runtime.json", ec);
+    if (!ec) {
+      appendFile(runtime);
+    }
+  }
+  // e.g. if the app has been updated while running
+  appendFile(mHelperDirectory / GetHelperFileName(arch));
+
+  return std::hash<std::string> {}(fingerprint);
+}
+
+}// namespace FredEmmott::OpenXRLayers
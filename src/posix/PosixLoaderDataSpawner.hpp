@@ -0,0 +1,33 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <filesystem>
+
+#include "LoaderDataService.hpp"
+
+namespace FredEmmott::OpenXRLayers {
+
+/** Runs the helpers with `posix_spawn()`, talking to them over pipes.
+ *
+ * The helpers inherit this process's environment, other than
+ * `XR_RUNTIME_JSON` if a runtime is specified.
+ */
+class PosixLoaderDataSpawner final : public LoaderDataSpawner {
+ public:
+  PosixLoaderDataSpawner() = delete;
+  /// `helperDirectory` contains the `openxr-loader-data-*` executables
+  explicit PosixLoaderDataSpawner(std::filesystem::path helperDirectory);
+  ~PosixLoaderDataSpawner() override;
+
+  std::expected<std::unique_ptr<LoaderDataServer>, LoaderData::Error>
+  SpawnServer(
+    Architecture,
+    const std::optional<std::filesystem::path>& runtime) override;
+  std::size_t GetServerFingerprint(Architecture) override;
+
+ private:
+  std::filesystem::path mHelperDirectory;
+};
+
+}// namespace FredEmmott::OpenXRLayers
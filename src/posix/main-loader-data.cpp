@@ -0,0 +1,20 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "LoaderDataMain.hpp"
+
+#include <string_view>
+
+#include "LoaderDataService.hpp"
+
+int main(int argc, char** argv) {
+  using namespace FredEmmott::OpenXRLayers;
+  if (
+    argc > 1
+    && std::string_view {argv[1]} == LoaderDataServer::CommandLineFlag) {
+    LoaderDataServerMain();
+    return 0;
+  }
+  LoaderDataMain();
+  return 0;
+}
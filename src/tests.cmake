@@ -0,0 +1,49 @@
+include_guard(GLOBAL)
+
+include(lib.cmake)
+
+# Not in CMAKE_RUNTIME_OUTPUT_DIRECTORY, as that is what we ship
+set(TESTS_OUTPUT_DIRECTORY "${CMAKE_BINARY_DIR}/tests")
+
+# Each test is a standalone executable that exits with a non-zero status on
+# failure; see tests/Check.hpp
+function(add_lib_test NAME)
+  add_executable("${NAME}" ${ARGN})
+  target_link_libraries("${NAME}" PRIVATE lib)
+  set_target_properties(
+    "${NAME}"
+    PROPERTIES
+    RUNTIME_OUTPUT_DIRECTORY "${TESTS_OUTPUT_DIRECTORY}"
+  )
+  if (UNIX)
+    target_sources("${NAME}" PRIVATE tests/NoPlatform.cpp)
+  endif ()
+  add_test(NAME "${NAME}" COMMAND "${NAME}")
+endfunction()
+
+add_lib_test(change-journal-tests tests/ChangeJournalTests.cpp)
+add_lib_test(layer-store-backend-tests tests/LayerStoreBackendTests.cpp)
+add_lib_test(loader-data-format-tests tests/LoaderDataFormatTests.cpp)
+add_lib_test(version-tests tests/VersionTests.cpp)
+
+if (UNIX)
+  # Speaks the `loader-data` server protocol, without the OpenXR loader
+  add_executable(
+    loader-data-stub-helper
+    tests/LoaderDataStubHelper.cpp
+  )
+  target_link_libraries(loader-data-stub-helper PRIVATE lib)
+  set_target_properties(
+    loader-data-stub-helper
+    PROPERTIES
+    RUNTIME_OUTPUT_DIRECTORY "${TESTS_OUTPUT_DIRECTORY}"
+  )
+
+  add_lib_test(loader-data-service-tests tests/LoaderDataServiceTests.cpp)
+  target_compile_definitions(
+    loader-data-service-tests
+    PRIVATE
+    "STUB_HELPER_PATH=\"$<TARGET_FILE:loader-data-stub-helper>\""
+  )
+  add_dependencies(loader-data-service-tests loader-data-stub-helper)
+endif ()
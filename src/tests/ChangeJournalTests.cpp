@@ -0,0 +1,288 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ChangeJournal.hpp"
+#include "Check.hpp"
+#include "Config.hpp"
+
+/** Records changes to a journal, and checks what another instance - as after
+ * a restart - reads back.
+ */
+namespace FredEmmott::OpenXRLayers::Tests {
+namespace {
+
+using Entries = ChangeJournal::Entries;
+
+constexpr auto StoreName = "Test-Store";
+
+class TemporaryJournal final {
+ public:
+  TemporaryJournal()
+    : mDirectory(
+        std::filesystem::temp_directory_path()
+        / std::format("change-journal-tests-{}", std::random_device {}())) {
+    std::filesystem::create_directories(mDirectory);
+  }
+
+  ~TemporaryJournal() {
+    std::error_code ec;
+    std::filesystem::remove_all(mDirectory, ec);
+  }
+
+  TemporaryJournal(const TemporaryJournal&) = delete;
+  TemporaryJournal& operator=(const TemporaryJournal&) = delete;
+
+  [[nodiscard]]
+  std::filesystem::path GetPath() const {
+    return mDirectory / "journal.tsv";
+  }
+
+ private:
+  std::filesystem::path mDirectory;
+};
+
+/// `b.json` is not a DWORD, e.g. a string written by another tool
+Entries MakeEntries(const uint32_t aDisabled) {
+  return {
+    {"/layers/a.json", aDisabled},
+    {"/layers/b.json", std::nullopt},
+    {"/layers/c.json", 0},
+  };
+}
+
+uint64_t Record(ChangeJournal& journal, const Entries& before, Entries after) {
+  const ChangeJournal::StoreChange change {StoreName, before, std::move(after)};
+  return journal.Record({&change, 1});
+}
+
+std::size_t CountExternal(const ChangeJournal& journal) {
+  return std::ranges::count(
+    journal.GetHistory(StoreName),
+    ChangeJournal::Kind::External,
+    &ChangeJournal::Summary::mKind);
+}
+
+void TestNotDWORDSurvivesRestart() {
+  const TemporaryJournal temp;
+  uint64_t id {};
+  {
+    ChangeJournal journal {temp.GetPath()};
+    id = Record(journal, MakeEntries(0), MakeEntries(1));
+    CHECK(id != 0);
+  }
+
+  ChangeJournal journal {temp.GetPath()};
+  CHECK(journal.GetStateBefore(StoreName, id) == MakeEntries(0));
+  CHECK(journal.GetStateAfter(StoreName, id) == MakeEntries(1));
+
+  // The first change is a full copy, as the store was not known yet; the
+  // reloaded state must match what is in the store, so there is no other
+  CHECK(Record(journal, MakeEntries(1), MakeEntries(0)) != 0);
+  CHECK(CountExternal(journal) == 1);
+}
+
+void TestMovedNotDWORD() {
+  const TemporaryJournal temp;
+  ChangeJournal journal {temp.GetPath()};
+
+  // Moving a value means deleting and re-appending it, and only DWORDs can be
+  // written, so the store now has a DWORD
+  const auto before = MakeEntries(0);
+  const Entries after {before.at(0), before.at(2), before.at(1)};
+  const Entries written {before.at(0), before.at(2), {"/layers/b.json", 1}};
+  const auto id = Record(journal, before, after);
+  CHECK(journal.GetStateAfter(StoreName, id) == written);
+
+  // ... so reading the store back is not an external change
+  auto next = written;
+  next.at(0).mDisabled = 1;
+  CHECK(Record(journal, written, next) != 0);
+  CHECK(CountExternal(journal) == 1);
+}
+
+void TestNotDWORDSurvivesCompaction() {
+  const TemporaryJournal temp;
+  {
+    ChangeJournal journal {temp.GetPath()};
+    for (std::size_t i = 0; i <= Config::JOURNAL_MAX_ENTRIES; ++i) {
+      const auto disabled = static_cast<uint32_t>(i % 2);
+      Record(journal, MakeEntries(disabled), MakeEntries(1 - disabled));
+    }
+    CHECK(journal.GetHistory(StoreName).size() < Config::JOURNAL_MAX_ENTRIES);
+  }
+
+  ChangeJournal journal {temp.GetPath()};
+  const auto history = journal.GetHistory(StoreName);
+  CHECK(!history.empty());
+  const auto latest = journal.GetStateAfter(StoreName, history.back().mID);
+  CHECK(latest.has_value());
+  CHECK(latest->at(1).mDisabled == std::nullopt);
+
+  const auto externalCount = CountExternal(journal);
+  auto next = *latest;
+  next.at(0).mDisabled = 1 - *next.at(0).mDisabled;
+  CHECK(Record(journal, *latest, next) != 0);
+  CHECK(CountExternal(journal) == externalCount);
+}
+
+/// Records after a rejected header must not be added to the previous entry
+void TestRejectedHeadersDropTheirRecords() {
+  const TemporaryJournal temp;
+  uint64_t id {};
+  {
+    ChangeJournal journal {temp.GetPath()};
+    id = Record(journal, MakeEntries(0), MakeEntries(1));
+  }
+  {
+    // The store is string 0, and `a.json` is string 1
+    std::ofstream f(temp.GetPath(), std::ios::binary | std::ios::app);
+    // Not after the previous ID
+    f << "T\t" << id << "\t0\tE\n"
+      << "D\t0\t1\n";
+    // Unknown kind
+    f << "T\t" << id + 1 << "\t0\tQ\n"
+      << "D\t0\t1\n";
+    // Wrong field count
+    f << "T\t" << id + 2 << "\t0\n"
+      << "D\t0\t1\n";
+    // Valid again
+    f << "T\t" << id + 3 << "\t0\tE\n"
+      << "S\t0\t1\t0\n";
+  }
+
+  ChangeJournal journal {temp.GetPath()};
+  CHECK(journal.GetStateAfter(StoreName, id) == MakeEntries(1));
+  CHECK(!journal.GetStateAfter(StoreName, id + 1));
+  CHECK(!journal.GetStateAfter(StoreName, id + 2));
+  CHECK(journal.GetStateAfter(StoreName, id + 3) == MakeEntries(0));
+  CHECK(journal.GetHistory(StoreName).back().mID == id + 3);
+}
+
+/// e.g. an elevated and a non-elevated instance
+void TestInstancesShareTheFile() {
+  const TemporaryJournal temp;
+  ChangeJournal first {temp.GetPath()};
+  ChangeJournal second {temp.GetPath()};
+
+  const auto a = Record(first, MakeEntries(0), MakeEntries(1));
+  // `second` must see the first change, or it would record a full copy, and
+  // reuse the IDs
+  const auto b = Record(second, MakeEntries(1), MakeEntries(0));
+  const auto c = Record(first, MakeEntries(0), MakeEntries(1));
+  CHECK(a < b && b < c);
+  CHECK(CountExternal(first) == 1);
+  CHECK(CountExternal(second) == 1);
+
+  const ChangeJournal reloaded {temp.GetPath()};
+  CHECK(reloaded.GetHistory(StoreName).size() == 4);
+  CHECK(reloaded.GetStateAfter(StoreName, a) == MakeEntries(1));
+  CHECK(reloaded.GetStateAfter(StoreName, b) == MakeEntries(0));
+  CHECK(reloaded.GetStateAfter(StoreName, c) == MakeEntries(1));
+
+  // Paths that only `second` has written must resolve to the same strings
+  auto moved = MakeEntries(1);
+  moved.push_back({"/layers/d.json", 0});
+  const auto d = Record(second, MakeEntries(1), moved);
+  CHECK(ChangeJournal {temp.GetPath()}.GetStateAfter(StoreName, d) == moved);
+  CHECK(Record(first, moved, MakeEntries(1)) != 0);
+  CHECK(CountExternal(first) == 1);
+}
+
+/// Another instance must notice that the file was rewritten
+void TestInstanceSeesCompaction() {
+  const TemporaryJournal temp;
+  ChangeJournal first {temp.GetPath()};
+  ChangeJournal second {temp.GetPath()};
+  CHECK(Record(second, MakeEntries(0), MakeEntries(1)) != 0);
+
+  auto latest = MakeEntries(1);
+  for (std::size_t i = 0; i <= Config::JOURNAL_MAX_ENTRIES; ++i) {
+    const auto disabled = static_cast<uint32_t>(i % 2);
+    Record(first, MakeEntries(1 - disabled), MakeEntries(disabled));
+    latest = MakeEntries(disabled);
+  }
+  const auto externalCount = CountExternal(first);
+
+  auto next = latest;
+  next.push_back({"/layers/d.json", 0});
+  const auto id = Record(second, latest, next);
+  CHECK(CountExternal(second) == externalCount);
+  CHECK(ChangeJournal {temp.GetPath()}.GetStateAfter(StoreName, id) == next);
+}
+
+std::vector<std::string> ReadLines(const std::filesystem::path& path) {
+  std::ifstream f(path, std::ios::binary);
+  std::vector<std::string> ret;
+  for (std::string line; std::getline(f, line);) {
+    ret.push_back(std::move(line));
+  }
+  return ret;
+}
+
+/// Full copies are compressed, but edits are appended as text; other than on
+/// Windows, the compressed data is the same as the text
+void TestOnlyCopiesAreCompressed() {
+  const TemporaryJournal temp;
+  ChangeJournal journal {temp.GetPath()};
+  Record(journal, MakeEntries(0), MakeEntries(1));
+  const auto afterCopy = ReadLines(temp.GetPath());
+  CHECK(afterCopy.front().starts_with("J\t"));
+  CHECK(std::ranges::any_of(afterCopy, [](const std::string& line) {
+    return line.starts_with("Z\t");
+  }));
+
+  const auto id = Record(journal, MakeEntries(1), MakeEntries(0));
+  const auto afterEdit = ReadLines(temp.GetPath());
+  CHECK(afterEdit.back().starts_with("S\t"));
+  CHECK(afterEdit.at(afterEdit.size() - 2).starts_with(
+    std::format("T\t{}\t", id)));
+}
+
+/// e.g. if a write was interrupted
+void TestTruncatedBlock() {
+  const TemporaryJournal temp;
+  {
+    ChangeJournal journal {temp.GetPath()};
+    Record(journal, MakeEntries(0), MakeEntries(1));
+  }
+  std::filesystem::resize_file(
+    temp.GetPath(), std::filesystem::file_size(temp.GetPath()) - 8);
+
+  uint64_t id {};
+  {
+    ChangeJournal journal {temp.GetPath()};
+    CHECK(journal.GetHistory(StoreName).empty());
+    id = Record(journal, MakeEntries(1), MakeEntries(0));
+  }
+
+  ChangeJournal journal {temp.GetPath()};
+  CHECK(CountExternal(journal) == 1);
+  CHECK(journal.GetStateBefore(StoreName, id) == MakeEntries(1));
+  CHECK(journal.GetStateAfter(StoreName, id) == MakeEntries(0));
+}
+
+}// namespace
+}// namespace FredEmmott::OpenXRLayers::Tests
+
+int main() {
+  using namespace FredEmmott::OpenXRLayers::Tests;
+  RUN_TEST(TestNotDWORDSurvivesRestart);
+  RUN_TEST(TestMovedNotDWORD);
+  RUN_TEST(TestNotDWORDSurvivesCompaction);
+  RUN_TEST(TestRejectedHeadersDropTheirRecords);
+  RUN_TEST(TestInstancesShareTheFile);
+  RUN_TEST(TestInstanceSeesCompaction);
+  RUN_TEST(TestOnlyCopiesAreCompressed);
+  RUN_TEST(TestTruncatedBlock);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,41 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+#include <source_location>
+#include <string_view>
+
+namespace FredEmmott::OpenXRLayers::Tests {
+
+/// Like `assert()`, but also checked in release builds
+inline void Check(
+  const bool condition,
+  const std::string_view expression,
+  const std::source_location& location = std::source_location::current()) {
+  if (condition) {
+    return;
+  }
+  std::fprintf(
+    stderr,
+    "%s:%u: check failed: %.*s\n",
+    location.file_name(),
+    static_cast<unsigned int>(location.line()),
+    static_cast<int>(expression.size()),
+    expression.data());
+  std::exit(EXIT_FAILURE);
+}
+
+/// Print the name of each test as it starts, so failures are easy to find
+inline void Run(const std::string_view name, void (*test)()) {
+  std::fprintf(
+    stderr, "%.*s\n", static_cast<int>(name.size()), name.data());
+  test();
+}
+
+}// namespace FredEmmott::OpenXRLayers::Tests
+
+#define CHECK(...) \
+  ::FredEmmott::OpenXRLayers::Tests::Check((__VA_ARGS__), #__VA_ARGS__)
+#define RUN_TEST(test) ::FredEmmott::OpenXRLayers::Tests::Run(#test, &test)
@@ -0,0 +1,184 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include "Check.hpp"
+#include "LayerStoreBackend.hpp"
+
+/** Checks that `DiffLayerStore()` and `ApplyLayerStoreEdits()` produce the
+ * requested entries with the fewest backend operations.
+ *
+ * These are what `ReadWriteAPILayerStore::SetAPILayers()` and
+ * `WriteAPILayers()` use to update the registry.
+ */
+namespace FredEmmott::OpenXRLayers::Tests {
+namespace {
+
+using Entry = LayerStoreBackend::Entry;
+
+class CountingLayerStoreBackend final : public LayerStoreBackend {
+ public:
+  explicit CountingLayerStoreBackend(std::vector<Entry> entries)
+    : mEntries(std::move(entries)) {}
+
+  std::size_t mSetCount {};
+  std::size_t mDeleteCount {};
+  /// If set, operations after this many fail
+  std::optional<std::size_t> mFailAfter;
+
+  std::vector<Entry> Read() const override {
+    return mEntries.Read();
+  }
+
+  bool Set(const std::filesystem::path& path, uint32_t disabled) override {
+    if (ShouldFail()) {
+      return false;
+    }
+    ++mSetCount;
+    return mEntries.Set(path, disabled);
+  }
+
+  bool Delete(const std::filesystem::path& path) override {
+    if (ShouldFail()) {
+      return false;
+    }
+    ++mDeleteCount;
+    return mEntries.Delete(path);
+  }
+
+  [[nodiscard]]
+  std::size_t GetOperationCount() const noexcept {
+    return mSetCount + mDeleteCount;
+  }
+
+ private:
+  MemoryLayerStoreBackend mEntries;
+
+  [[nodiscard]]
+  bool ShouldFail() const noexcept {
+    return mFailAfter && GetOperationCount() >= *mFailAfter;
+  }
+};
+
+std::vector<Entry> MakeEntries(const std::size_t count) {
+  std::vector<Entry> ret;
+  for (std::size_t i = 0; i < count; ++i) {
+    ret.push_back({std::format("/layers/{}.json", i), 0});
+  }
+  return ret;
+}
+
+/// Applies the diff, checks the result, and returns the backend
+CountingLayerStoreBackend Apply(
+  const std::vector<Entry>& before,
+  const std::vector<Entry>& after) {
+  CountingLayerStoreBackend backend {before};
+  CHECK(ApplyLayerStoreEdits(backend, DiffLayerStore(before, after)));
+  CHECK(backend.Read() == after);
+  return backend;
+}
+
+void TestUnchanged() {
+  const auto entries = MakeEntries(5);
+  CHECK(DiffLayerStore(entries, entries).empty());
+}
+
+void TestToggle() {
+  const auto before = MakeEntries(5);
+  auto after = before;
+  after.at(2).mDisabled = 1;
+
+  const auto backend = Apply(before, after);
+  CHECK(backend.mSetCount == 1);
+  CHECK(backend.mDeleteCount == 0);
+}
+
+void TestMoveToBottom() {
+  const auto before = MakeEntries(5);
+  auto after = before;
+  after.erase(after.begin());
+  after.push_back(before.front());
+
+  const auto backend = Apply(before, after);
+  CHECK(backend.mSetCount == 1);
+  CHECK(backend.mDeleteCount == 1);
+}
+
+void TestMoveToTop() {
+  const auto before = MakeEntries(5);
+  auto after = before;
+  after.pop_back();
+  after.insert(after.begin(), before.back());
+
+  // Entries can only be appended, so the entries that were above the moved
+  // entry are deleted and re-appended; the moved entry itself stays in place
+  const auto backend = Apply(before, after);
+  CHECK(backend.mSetCount == 4);
+  CHECK(backend.mDeleteCount == 4);
+}
+
+void TestAddAndRemove() {
+  const auto before = MakeEntries(5);
+  auto after = before;
+  after.erase(after.begin() + 1);
+  after.push_back({"/layers/new.json", 0});
+
+  const auto backend = Apply(before, after);
+  CHECK(backend.mSetCount == 1);
+  CHECK(backend.mDeleteCount == 1);
+}
+
+void TestStopsAtFirstFailure() {
+  const auto before = MakeEntries(5);
+  auto after = before;
+  std::ranges::reverse(after);
+  const auto edits = DiffLayerStore(before, after);
+  CHECK(edits.size() > 2);
+
+  CountingLayerStoreBackend backend {before};
+  backend.mFailAfter = 2;
+  CHECK(!ApplyLayerStoreEdits(backend, edits));
+  CHECK(backend.GetOperationCount() == 2);
+}
+
+void TestTSVBackend() {
+  const auto path = std::filesystem::temp_directory_path()
+    / std::format(
+      "layer-store-backend-tests-{}.tsv", std::random_device {}());
+  auto before = MakeEntries(4);
+  // Not a DWORD; must be preserved unless moved
+  before.at(1).mDisabled = std::nullopt;
+  CHECK(TSVLayerStoreBackend::Write(path, before));
+
+  TSVLayerStoreBackend backend {path};
+  CHECK(backend.Read() == before);
+
+  auto after = before;
+  after.at(3).mDisabled = 1;
+  CHECK(ApplyLayerStoreEdits(backend, DiffLayerStore(before, after)));
+  CHECK(backend.Read() == after);
+
+  std::filesystem::remove(path);
+}
+
+}// namespace
+}// namespace FredEmmott::OpenXRLayers::Tests
+
+int main() {
+  using namespace FredEmmott::OpenXRLayers::Tests;
+  RUN_TEST(TestUnchanged);
+  RUN_TEST(TestToggle);
+  RUN_TEST(TestMoveToBottom);
+  RUN_TEST(TestMoveToTop);
+  RUN_TEST(TestAddAndRemove);
+  RUN_TEST(TestStopsAtFirstFailure);
+  RUN_TEST(TestTSVBackend);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,279 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <optional>
+#include <random>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "Check.hpp"
+#include "LoaderDataFormat.hpp"
+
+/** Round-trips randomly-generated `LoaderData` through `LoaderDataFormat`,
+ * and checks that corrupt payloads are rejected rather than crashing.
+ *
+ * The seed is fixed so failures can be reproduced; set
+ * `LOADER_DATA_FORMAT_TESTS_SEED` to try others.
+ */
+namespace FredEmmott::OpenXRLayers::Tests {
+namespace {
+
+using namespace LoaderDataFormat;
+
+constexpr std::size_t RoundTripCount = 500;
+// Each is mutated `MutationCount / MutatedPayloadCount` times
+constexpr std::size_t MutatedPayloadCount = 50;
+constexpr std::size_t MutationCount = 20000;
+
+std::mt19937_64 gRandom;
+
+std::size_t RandomSize(const std::size_t max) {
+  return std::uniform_int_distribution<std::size_t> {0, max}(gRandom);
+}
+
+bool RandomBool() {
+  return std::bernoulli_distribution {0.5}(gRandom);
+}
+
+/// Any bytes, including NUL and invalid UTF-8; usually short, and often
+/// repeated, so the string table is shared
+std::string RandomString() {
+  static const std::array<std::string, 3> Common {"", "1", "XR_common"};
+  if (RandomSize(4) == 0) {
+    return Common.at(RandomSize(Common.size() - 1));
+  }
+  std::string ret(RandomSize(RandomSize(8) == 0 ? 300 : 20), '\0');
+  std::ranges::generate(
+    ret, [] { return static_cast<char>(RandomSize(255)); });
+  return ret;
+}
+
+std::vector<std::string> RandomStrings(const std::size_t maxCount) {
+  std::vector<std::string> ret(RandomSize(maxCount));
+  std::ranges::generate(ret, &RandomString);
+  return ret;
+}
+
+std::optional<std::string> RandomOptionalString() {
+  if (RandomBool()) {
+    return std::nullopt;
+  }
+  return RandomString();
+}
+
+LoaderData RandomLoaderData() {
+  constexpr std::array Architectures {
+    Architecture::Invalid,
+    Architecture::x86,
+    Architecture::x64,
+  };
+
+  LoaderData ret {
+    .mArchitecture = Architectures.at(RandomSize(Architectures.size() - 1)),
+    // Results are negative for errors, so check the sign survives
+    .mQueryExtensionsResult = static_cast<XrResult>(
+      std::uniform_int_distribution<int32_t> {}(gRandom)),
+    .mQueryLayersResult = RandomBool() ? XR_SUCCESS : XR_ERROR_RUNTIME_FAILURE,
+    .mEnabledLayerNames = RandomStrings(20),
+    .mAvailableExtensionNames = RandomStrings(60),
+    .mIsComplete = RandomBool(),
+  };
+
+  // Sorted and unique, as the format requires
+  std::map<std::string, std::string> variables;
+  for (std::size_t i = RandomSize(150); i > 0; --i) {
+    variables.insert_or_assign(RandomString(), RandomString());
+  }
+  ret.mEnvironmentVariablesBeforeLoader = Environment {variables};
+
+  std::map<std::string, EnvironmentChange> changes;
+  for (std::size_t i = RandomSize(5); i > 0; --i) {
+    auto name = RandomString();
+    EnvironmentChange change {
+      .mName = name,
+      .mBefore = RandomOptionalString(),
+      .mAfter = RandomOptionalString(),
+    };
+    if (!(change.mBefore || change.mAfter)) {
+      change.mAfter.emplace();
+    }
+    changes.insert_or_assign(std::move(name), std::move(change));
+  }
+  for (auto&& change: changes | std::views::values) {
+    ret.mEnvironmentVariableChanges.push_back(std::move(change));
+  }
+  return ret;
+}
+
+/// The payload of a frame, checking the header
+std::string GetPayload(std::string frame) {
+  const auto frameSize = frame.size();
+  const auto payload = TakeFrame(frame);
+  CHECK(payload.has_value());
+  CHECK(payload->has_value());
+  CHECK(frame.empty());
+  CHECK((*payload)->size() + FrameHeaderSize == frameSize);
+  return std::move(**payload);
+}
+
+void TestRoundTrip() {
+  for (std::size_t i = 0; i < RoundTripCount; ++i) {
+    const auto data = RandomLoaderData();
+    const auto& environment = data.mEnvironmentVariablesBeforeLoader;
+
+    const auto full = GetPayload(EncodeFrame(data, EnvironmentEncoding::Full));
+    const auto decoded = Decode(full, nullptr);
+    CHECK(decoded.has_value());
+    CHECK(*decoded == data);
+
+    const auto hashOnly
+      = GetPayload(EncodeFrame(data, EnvironmentEncoding::HashOnly));
+    CHECK(hashOnly.size() <= full.size());
+    const auto withKnown = Decode(hashOnly, &environment);
+    CHECK(withKnown.has_value());
+    CHECK(*withKnown == data);
+    CHECK(!Decode(hashOnly, nullptr).has_value());
+
+    // A different environment must not be substituted
+    if (!environment.empty()) {
+      const Environment other;
+      CHECK(!Decode(hashOnly, &other).has_value());
+    }
+  }
+}
+
+/// Frames split across reads at arbitrary points, as from a pipe
+void TestSplitFrames() {
+  std::vector<LoaderData> sent;
+  std::string stream;
+  for (std::size_t i = 0; i < 50; ++i) {
+    sent.push_back(RandomLoaderData());
+    stream += EncodeFrame(sent.back(), EnvironmentEncoding::Full);
+  }
+
+  std::vector<LoaderData> received;
+  std::string buffer;
+  std::size_t offset = 0;
+  while (offset < stream.size()) {
+    const auto chunk = std::min(RandomSize(4096) + 1, stream.size() - offset);
+    buffer.append(stream, offset, chunk);
+    offset += chunk;
+    while (true) {
+      auto frame = TakeFrame(buffer);
+      CHECK(frame.has_value());
+      if (!*frame) {
+        break;
+      }
+      auto decoded = Decode(**frame, nullptr);
+      CHECK(decoded.has_value());
+      received.push_back(std::move(*decoded));
+    }
+  }
+  CHECK(buffer.empty());
+  CHECK(received == sent);
+}
+
+/// Corrupt payloads must be rejected or decoded, not crash or hang
+void TestMutations() {
+  std::vector<std::pair<LoaderData, std::string>> valid;
+  for (std::size_t i = 0; i < MutatedPayloadCount; ++i) {
+    auto data = RandomLoaderData();
+    auto payload = GetPayload(EncodeFrame(
+      data,
+      RandomBool() ? EnvironmentEncoding::Full
+                   : EnvironmentEncoding::HashOnly));
+    valid.emplace_back(std::move(data), std::move(payload));
+  }
+
+  std::size_t rejected {};
+  for (std::size_t i = 0; i < MutationCount; ++i) {
+    const auto& [data, validPayload] = valid.at(i % valid.size());
+    auto payload = validPayload;
+
+    switch (RandomSize(3)) {
+      case 0:
+        payload.resize(RandomSize(payload.size()));
+        break;
+      case 1:
+        for (std::size_t j = RandomSize(8) + 1; j > 0; --j) {
+          payload.at(RandomSize(payload.size() - 1))
+            = static_cast<char>(RandomSize(255));
+        }
+        break;
+      case 2:
+        payload.insert(
+          RandomSize(payload.size()), 1, static_cast<char>(RandomSize(255)));
+        break;
+      case 3:
+        payload.erase(RandomSize(payload.size() - 1), 1);
+        break;
+    }
+
+    const auto& environment = data.mEnvironmentVariablesBeforeLoader;
+    const auto decoded
+      = Decode(payload, RandomBool() ? &environment : nullptr);
+    if (!decoded) {
+      ++rejected;
+    }
+  }
+  std::fprintf(
+    stderr,
+    "\t%zu of %zu corrupt payloads rejected\n",
+    rejected,
+    MutationCount);
+  // Most mutations should be detected; not all are, e.g. changing a string
+  CHECK(rejected > MutationCount / 2);
+}
+
+/// Payloads that were never valid, e.g. text written by a runtime
+void TestGarbage() {
+  const auto valid
+    = GetPayload(EncodeFrame(LoaderData {}, EnvironmentEncoding::Full));
+  // The magic and version, so decoding gets past them
+  const auto prefix = valid.substr(0, Magic.size() + 1);
+  for (std::size_t i = 0; i < MutationCount; ++i) {
+    const auto garbage = RandomString();
+    CHECK(!Decode(garbage, nullptr).has_value());
+    // Whatever this decodes to, if anything, it must not crash
+    std::ignore = Decode(prefix + garbage, nullptr);
+  }
+
+  std::string empty(FrameHeaderSize, '\0');
+  const auto emptyFrame = TakeFrame(empty);
+  CHECK(emptyFrame.has_value() && emptyFrame->has_value());
+  CHECK(!Decode(**emptyFrame, nullptr).has_value());
+
+  std::string tooLarge(FrameHeaderSize, '\xff');
+  CHECK(!TakeFrame(tooLarge).has_value());
+}
+
+}// namespace
+}// namespace FredEmmott::OpenXRLayers::Tests
+
+int main() {
+  using namespace FredEmmott::OpenXRLayers::Tests;
+
+  uint64_t seed = 0x4c6f61646572;
+  if (const auto value = std::getenv("LOADER_DATA_FORMAT_TESTS_SEED")) {
+    seed = std::strtoull(value, nullptr, 0);
+  }
+  std::fprintf(
+    stderr, "Seed: %llu\n", static_cast<unsigned long long>(seed));
+  gRandom.seed(seed);
+
+  RUN_TEST(TestRoundTrip);
+  RUN_TEST(TestSplitFrames);
+  RUN_TEST(TestMutations);
+  RUN_TEST(TestGarbage);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,297 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <memory>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <variant>
+
+#include <unistd.h>
+
+#include "Check.hpp"
+#include "LoaderDataService.hpp"
+#include "Platform.hpp"
+#include "posix/PosixLoaderDataSpawner.hpp"
+
+/** Runs `LoaderDataService` against `LoaderDataStubHelper`, with the real
+ * POSIX spawner.
+ *
+ * The stub is linked into a temporary directory under each architecture's
+ * helper name.
+ */
+namespace FredEmmott::OpenXRLayers::Tests {
+namespace {
+
+using namespace std::chrono_literals;
+using Clock = LoaderDataService::Clock;
+
+constexpr auto Arch = Platform::GetBuildArchitecture();
+// Generous, as CI machines can be slow; the helpers are killed after this
+constexpr auto Timeout = 5s;
+// Queries should be much faster than `Timeout`; this is what we're testing
+constexpr auto MaxLatency = 2s;
+
+class StubHelperDirectory final {
+ public:
+  StubHelperDirectory()
+    : mPath(
+        std::filesystem::temp_directory_path()
+        / std::format("loader-data-service-tests-{}", getpid())) {
+    std::filesystem::create_directories(mPath);
+    std::filesystem::create_symlink(
+      STUB_HELPER_PATH, mPath / LoaderDataSpawner::GetHelperFileName(Arch));
+  }
+
+  ~StubHelperDirectory() {
+    std::error_code ec;
+    std::filesystem::remove_all(mPath, ec);
+  }
+
+  StubHelperDirectory(const StubHelperDirectory&) = delete;
+  StubHelperDirectory& operator=(const StubHelperDirectory&) = delete;
+
+  [[nodiscard]]
+  const std::filesystem::path& GetPath() const noexcept {
+    return mPath;
+  }
+
+ private:
+  std::filesystem::path mPath;
+};
+
+StubHelperDirectory* gHelperDirectory {nullptr};
+
+/// Set the stub's behavior before starting a service; see the stub
+void SetStubEnvironment(
+  const std::string_view mode,
+  const std::chrono::milliseconds delay = {}) {
+  setenv("STUB_LOADER_DATA_MODE", std::string {mode}.c_str(), 1);
+  setenv(
+    "STUB_LOADER_DATA_DELAY_MS", std::to_string(delay.count()).c_str(), 1);
+}
+
+std::unique_ptr<LoaderDataService> MakeService(
+  const std::filesystem::path& helperDirectory) {
+  return std::make_unique<LoaderDataService>(
+    std::make_unique<PosixLoaderDataSpawner>(helperDirectory),
+    nullptr,
+    Architectures {Arch},
+    Timeout,
+    /* debounce = */ 0ms,
+    /* maxConcurrentRuntimeQueries = */ 2);
+}
+
+std::unique_ptr<LoaderDataService> MakeService() {
+  return MakeService(gHelperDirectory->GetPath());
+}
+
+/// The value of the stub's `<prefix>:<value>` layer name
+std::string GetStubValue(const LoaderData& data, const std::string_view key) {
+  const auto prefix = std::format("{}:", key);
+  const auto it = std::ranges::find_if(
+    data.mEnabledLayerNames, [&prefix](const std::string_view name) {
+      return name.starts_with(prefix);
+    });
+  CHECK(it != data.mEnabledLayerNames.end());
+  return it->substr(prefix.size());
+}
+
+void PrintLatency(const std::string_view what, const Clock::duration latency) {
+  std::fprintf(
+    stderr,
+    "\t%.*s: %lldms\n",
+    static_cast<int>(what.size()),
+    what.data(),
+    static_cast<long long>(
+      std::chrono::duration_cast<std::chrono::milliseconds>(latency).count()));
+}
+
+void TestFirstQuery() {
+  SetStubEnvironment("respond");
+  const auto started = Clock::now();
+  const auto service = MakeService();
+  const auto result = service->Wait(Arch, started + Timeout);
+  const auto latency = Clock::now() - started;
+  PrintLatency("first complete result", latency);
+
+  CHECK(result.has_value());
+  const auto& data = **result;
+  CHECK(data.mIsComplete);
+  CHECK(!data.mIsRefreshing);
+  CHECK(data.mArchitecture == Arch);
+  CHECK(GetStubValue(data, "query") == "1");
+  CHECK(data.mAvailableExtensionNames.size() == 1);
+  CHECK(latency < MaxLatency);
+}
+
+void TestRefreshReusesHelper() {
+  SetStubEnvironment("respond");
+  const auto service = MakeService();
+  const auto first = service->Wait(Arch, Clock::now() + Timeout);
+  CHECK(first.has_value());
+
+  const auto started = Clock::now();
+  service->Invalidate(Arch);
+  const auto second = service->Wait(Arch, started + Timeout);
+  PrintLatency("refresh", Clock::now() - started);
+
+  CHECK(second.has_value());
+  CHECK(GetStubValue(**second, "query") == "2");
+  // Same helper, so no spawn or runtime load
+  CHECK(GetStubValue(**first, "pid") == GetStubValue(**second, "pid"));
+  CHECK(Clock::now() - started < MaxLatency);
+}
+
+void TestRefreshPublishesFirstPhase() {
+  SetStubEnvironment("respond", /* delay = */ 500ms);
+  const auto service = MakeService();
+  const auto first = service->Wait(Arch, Clock::now() + Timeout);
+  CHECK(first.has_value());
+
+  service->Invalidate(Arch);
+  // Long enough for the first phase, but not the second
+  std::this_thread::sleep_for(250ms);
+  const auto partial = service->Get(Arch);
+  CHECK(partial.has_value());
+  // What linters use is already up to date, so they don't wait for the
+  // runtime to load
+  CHECK(!(*partial)->mIsRefreshing);
+  CHECK(GetStubValue(**partial, "query") == "2");
+  // ... but the extensions need the runtime, so are from the first query
+  CHECK(!(*partial)->mIsComplete);
+  CHECK((*partial)->mAvailableExtensionNames.size() == 1);
+
+  const auto second = service->Wait(Arch, Clock::now() + Timeout);
+  CHECK(second.has_value());
+  CHECK((*second)->mIsComplete);
+  CHECK(!(*second)->mIsRefreshing);
+  CHECK(GetStubValue(**second, "query") == "2");
+}
+
+void TestCancelledQueryKeepsHelper() {
+  SetStubEnvironment("respond", /* delay = */ 500ms);
+  const auto service = MakeService();
+  const auto first = service->Wait(Arch, Clock::now() + Timeout);
+  CHECK(first.has_value());
+
+  service->Invalidate(Arch);
+  // Cancel the second query between its two frames
+  std::this_thread::sleep_for(100ms);
+  service->Invalidate(Arch);
+
+  const auto third = service->Wait(Arch, Clock::now() + Timeout);
+  CHECK(third.has_value());
+  CHECK((*third)->mIsComplete);
+  CHECK(GetStubValue(**first, "pid") == GetStubValue(**third, "pid"));
+  // The rest of the second response was skipped
+  CHECK(GetStubValue(**third, "query") == "3");
+}
+
+void TestSetRuntimesKeepsHelper() {
+  SetStubEnvironment("respond", /* delay = */ 500ms);
+  const auto service = MakeService();
+  const auto first = service->Wait(Arch, Clock::now() + Timeout);
+  CHECK(first.has_value());
+  const auto pid = GetStubValue(**first, "pid");
+
+  service->Invalidate(Arch);
+  // Change the runtimes while the main query is in flight
+  std::this_thread::sleep_for(100ms);
+  const std::array<std::filesystem::path, 2> paths {
+    "/stub/runtime-a.json",
+    "/stub/runtime-b.json",
+  };
+  service->SetRuntimes(
+    Arch,
+    {
+      {.mRuntime = paths.at(0), .mName = "A"},
+      {.mRuntime = paths.at(1), .mName = "B"},
+    });
+
+  const auto second = service->Wait(Arch, Clock::now() + Timeout);
+  CHECK(second.has_value());
+  // Neither cancelled nor restarted
+  CHECK(GetStubValue(**second, "pid") == pid);
+  CHECK(GetStubValue(**second, "query") == "2");
+
+  const auto runtimes = service->WaitForRuntimes(Arch, Clock::now() + Timeout);
+  CHECK(runtimes->size() == 2);
+  for (auto&& [runtime, expected]: std::views::zip(*runtimes, paths)) {
+    CHECK(runtime.mRuntime == expected);
+    CHECK(runtime.mResult.has_value());
+    const auto& data = **runtime.mResult;
+    CHECK(data.mIsComplete);
+    CHECK(!data.mIsRefreshing);
+    CHECK(GetStubValue(data, "runtime") == expected.string());
+    CHECK(GetStubValue(data, "pid") != pid);
+  }
+}
+
+void TestHelperTimesOut() {
+  SetStubEnvironment("hang");
+  const auto service = std::make_unique<LoaderDataService>(
+    std::make_unique<PosixLoaderDataSpawner>(gHelperDirectory->GetPath()),
+    nullptr,
+    Architectures {Arch},
+    /* timeout = */ 500ms,
+    /* debounce = */ 0ms,
+    /* maxConcurrentRuntimeQueries = */ 2);
+  const auto started = Clock::now();
+  const auto result = service->Wait(Arch, started + Timeout);
+  PrintLatency("timeout", Clock::now() - started);
+
+  CHECK(!result.has_value());
+  CHECK(holds_alternative<LoaderData::TimeoutError>(result.error()));
+  CHECK(Clock::now() - started < MaxLatency);
+}
+
+void TestHelperExits() {
+  SetStubEnvironment("exit");
+  const auto service = MakeService();
+  const auto result = service->Wait(Arch, Clock::now() + Timeout);
+
+  CHECK(!result.has_value());
+  const auto error = std::get_if<LoaderData::BadExitCodeError>(&result.error());
+  CHECK(error != nullptr);
+  CHECK(error->mExitCode == 3);
+}
+
+void TestMissingHelper() {
+  SetStubEnvironment("respond");
+  const auto service
+    = MakeService(gHelperDirectory->GetPath() / "does-not-exist");
+  const auto result = service->Wait(Arch, Clock::now() + Timeout);
+
+  CHECK(!result.has_value());
+  CHECK(
+    holds_alternative<LoaderData::CanNotFindHelperExecutableError>(
+      result.error()));
+}
+
+}// namespace
+}// namespace FredEmmott::OpenXRLayers::Tests
+
+int main() {
+  using namespace FredEmmott::OpenXRLayers::Tests;
+  StubHelperDirectory helperDirectory;
+  gHelperDirectory = &helperDirectory;
+
+  RUN_TEST(TestFirstQuery);
+  RUN_TEST(TestRefreshReusesHelper);
+  RUN_TEST(TestRefreshPublishesFirstPhase);
+  RUN_TEST(TestCancelledQueryKeepsHelper);
+  RUN_TEST(TestSetRuntimesKeepsHelper);
+  RUN_TEST(TestHelperTimesOut);
+  RUN_TEST(TestHelperExits);
+  RUN_TEST(TestMissingHelper);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,111 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <chrono>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+
+#include <unistd.h>
+
+#include "Environment.hpp"
+#include "LoaderData.hpp"
+#include "LoaderDataFormat.hpp"
+#include "LoaderDataService.hpp"
+
+extern char** environ;
+
+/** Stands in for `loader-data` in server mode, without the OpenXR loader.
+ *
+ * Each response's enabled layers identify the helper and the query:
+ * `pid:<pid>`, `query:<count>`, and `runtime:<XR_RUNTIME_JSON>`. The complete
+ * frame also lists `StubExtension`.
+ *
+ * Behavior is controlled by environment variables:
+ * - `STUB_LOADER_DATA_MODE`: `respond` (the default), `hang` to never
+ *   respond, or `exit` to exit with `ExitCode` when queried
+ * - `STUB_LOADER_DATA_DELAY_MS`: wait this long before the complete frame
+ */
+namespace FredEmmott::OpenXRLayers::Tests {
+namespace {
+
+constexpr auto StubExtension = "XR_STUB_extension";
+constexpr int ExitCode = 3;
+
+std::string GetEnv(const char* name) {
+  const auto value = std::getenv(name);
+  return value ? value : "";
+}
+
+Environment GetEnvironment() {
+  std::map<std::string, std::string> variables;
+  for (auto it = environ; it && *it; ++it) {
+    const std::string_view entry {*it};
+    const auto separator = entry.find('=');
+    if (separator != std::string_view::npos) {
+      variables.emplace(
+        entry.substr(0, separator), entry.substr(separator + 1));
+    }
+  }
+  return Environment {variables};
+}
+
+void WriteFrame(
+  const LoaderData& data,
+  const LoaderDataFormat::EnvironmentEncoding encoding) {
+  const auto frame = LoaderDataFormat::EncodeFrame(data, encoding);
+  std::cout.write(frame.data(), frame.size());
+  std::cout.flush();
+}
+
+int Main() {
+  const auto mode = GetEnv("STUB_LOADER_DATA_MODE");
+  const auto delayString = GetEnv("STUB_LOADER_DATA_DELAY_MS");
+  const std::chrono::milliseconds delay {
+    delayString.empty() ? 0 : std::stoi(delayString)};
+  const auto environment = GetEnvironment();
+  auto encoding = LoaderDataFormat::EnvironmentEncoding::Full;
+
+  std::string request;
+  for (int count = 1; std::getline(std::cin, request); ++count) {
+    if (request != LoaderDataServer::QueryRequest) {
+      continue;
+    }
+    if (mode == "exit") {
+      return ExitCode;
+    }
+    if (mode == "hang") {
+      while (true) {
+        std::this_thread::sleep_for(std::chrono::hours(1));
+      }
+    }
+
+    LoaderData data {
+      .mEnabledLayerNames = {
+        std::format("pid:{}", getpid()),
+        std::format("query:{}", count),
+        std::format("runtime:{}", GetEnv("XR_RUNTIME_JSON")),
+      },
+      .mEnvironmentVariablesBeforeLoader = environment,
+      .mIsComplete = false,
+    };
+    WriteFrame(data, encoding);
+    encoding = LoaderDataFormat::EnvironmentEncoding::HashOnly;
+
+    std::this_thread::sleep_for(delay);
+    data.mAvailableExtensionNames = {StubExtension};
+    data.mIsComplete = true;
+    WriteFrame(data, encoding);
+  }
+  return EXIT_SUCCESS;
+}
+
+}// namespace
+}// namespace FredEmmott::OpenXRLayers::Tests
+
+int main() {
+  return FredEmmott::OpenXRLayers::Tests::Main();
+}
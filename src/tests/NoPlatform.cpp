@@ -0,0 +1,21 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <cstdlib>
+
+#include "APILayerStore.hpp"
+#include "Platform.hpp"
+
+// There is no POSIX `Platform`, or stores. The tests and benchmarks only use
+// code that does not reach these.
+namespace FredEmmott::OpenXRLayers {
+
+Platform& Platform::Get() {
+  std::abort();
+}
+
+std::span<APILayerStore*> APILayerStore::Get() noexcept {
+  return {};
+}
+
+}// namespace FredEmmott::OpenXRLayers
@@ -0,0 +1,209 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <cstdint>
+#include <cstdlib>
+#include <string_view>
+#include <vector>
+
+#include "Check.hpp"
+#include "Version.hpp"
+
+/** Checks `Version::Parse()`, and how `VersionRange::Parse()` compiles
+ * expressions to intervals.
+ */
+namespace FredEmmott::OpenXRLayers::Tests {
+namespace {
+
+using Interval = VersionRange::Interval;
+
+constexpr uint16_t MaxMinor = 0xffff;
+constexpr uint32_t MaxPatch = 0xffffffff;
+constexpr auto MaxPacked = Version {0xffff, MaxMinor, MaxPatch}.GetPacked();
+
+VersionRange Parse(const std::string_view expression) {
+  const auto ret = VersionRange::Parse(expression);
+  CHECK(ret.has_value());
+  return *ret;
+}
+
+std::vector<Interval> GetIntervals(const std::string_view expression) {
+  const auto range = Parse(expression);
+  const auto intervals = range.GetIntervals();
+  return {intervals.begin(), intervals.end()};
+}
+
+constexpr Interval MakeInterval(const Version min, const Version max) {
+  return {min.GetPacked(), max.GetPacked()};
+}
+
+void TestParseVersion() {
+  CHECK(Version::Parse("1") == Version {1});
+  CHECK(Version::Parse("1.2") == Version {1, 2});
+  CHECK(Version::Parse("1.0.32") == Version {1, 0, 32});
+  CHECK(Version::Parse(" 1.2.3\t") == Version {1, 2, 3});
+  CHECK(
+    Version::Parse("65535.65535.4294967295")
+    == Version::FromPacked(MaxPacked));
+
+  for (auto&& invalid: {
+         "",
+         " ",
+         "1.",
+         ".1",
+         "1..2",
+         "1.2.3.4",
+         "a",
+         "1.a",
+         "-1",
+         "+1",
+         "1 .2",
+         "65536",
+         "1.65536",
+         "1.0.4294967296",
+         // Only ranges have wildcards
+         "1.*",
+       }) {
+    CHECK(!Version::Parse(invalid));
+  }
+}
+
+void TestVersionToString() {
+  CHECK(Version {1}.ToString() == "1.0.0");
+  CHECK(Version {1, 2, 3}.ToString() == "1.2.3");
+}
+
+void TestBoundaries() {
+  const auto lessThan = Parse("<1.2");
+  CHECK(lessThan.Contains({0}));
+  CHECK(lessThan.Contains({1, 1, MaxPatch}));
+  CHECK(!lessThan.Contains({1, 2}));
+
+  const auto lessOrEqual = Parse("<=1.2");
+  CHECK(lessOrEqual.Contains({1, 2}));
+  // Missing components are wildcards, so this includes every 1.2.x
+  CHECK(lessOrEqual.Contains({1, 2, MaxPatch}));
+  CHECK(!lessOrEqual.Contains({1, 3}));
+
+  const auto greaterThan = Parse(">1.2");
+  CHECK(!greaterThan.Contains({1, 2}));
+  CHECK(!greaterThan.Contains({1, 2, MaxPatch}));
+  CHECK(greaterThan.Contains({1, 3}));
+  CHECK(greaterThan.Contains(Version::FromPacked(MaxPacked)));
+
+  const auto greaterOrEqual = Parse(">=1.2");
+  CHECK(!greaterOrEqual.Contains({1, 1, MaxPatch}));
+  CHECK(greaterOrEqual.Contains({1, 2}));
+
+  const auto exact = Parse("=1.2.3");
+  CHECK(!exact.Contains({1, 2, 2}));
+  CHECK(exact.Contains({1, 2, 3}));
+  CHECK(!exact.Contains({1, 2, 4}));
+
+  // Space-separated comparisons must all match
+  const auto between = Parse(">=1.2 <2");
+  CHECK(
+    GetIntervals(">=1.2 <2")
+    == std::vector {MakeInterval({1, 2}, {1, MaxMinor, MaxPatch})});
+  CHECK(!between.Contains({1, 1}));
+  CHECK(between.Contains({1, 9}));
+  CHECK(!between.Contains({2}));
+
+  // Nothing is below the lowest version, or above the highest
+  CHECK(GetIntervals("<0").empty());
+  CHECK(GetIntervals(">65535.65535.4294967295").empty());
+  CHECK(GetIntervals(">2 <1").empty());
+  CHECK(!Parse("<0").Contains({0}));
+}
+
+void TestWildcards() {
+  const auto minor = std::vector {MakeInterval({1, 2}, {1, 2, MaxPatch})};
+  CHECK(GetIntervals("1.2") == minor);
+  CHECK(GetIntervals("=1.2") == minor);
+  CHECK(GetIntervals("1.2.*") == minor);
+
+  const auto major = std::vector {MakeInterval({1}, {1, MaxMinor, MaxPatch})};
+  CHECK(GetIntervals("1") == major);
+  CHECK(GetIntervals("1.*") == major);
+  CHECK(GetIntervals("1.*.*") == major);
+
+  CHECK(GetIntervals("*") == std::vector {Interval {0, MaxPacked}});
+  CHECK(GetIntervals("<2.*") == GetIntervals("<2"));
+  CHECK(
+    GetIntervals("<2")
+    == std::vector {MakeInterval({0}, {1, MaxMinor, MaxPatch})});
+}
+
+void TestAlternatives() {
+  // Overlapping
+  CHECK(GetIntervals("<2 || <3") == GetIntervals("<3"));
+  CHECK(GetIntervals("1.2 || 1") == GetIntervals("1"));
+  // Adjacent
+  CHECK(
+    GetIntervals("=1 || =2")
+    == std::vector {MakeInterval({1}, {2, MaxMinor, MaxPatch})});
+  CHECK(GetIntervals("<1.2 || >=1.2") == GetIntervals("*"));
+  CHECK(GetIntervals(">=1.2 || <1.2") == GetIntervals("*"));
+  // Disjoint, and sorted whatever order they're written in
+  const std::vector disjoint {
+    MakeInterval({1}, {1, MaxMinor, MaxPatch}),
+    MakeInterval({3}, {3, MaxMinor, MaxPatch}),
+  };
+  CHECK(GetIntervals("=1 || =3") == disjoint);
+  CHECK(GetIntervals("=3 || =1") == disjoint);
+  CHECK(GetIntervals("=3||=1") == disjoint);
+  // Empty alternatives don't affect the others
+  CHECK(GetIntervals("<0 || =1") == GetIntervals("=1"));
+
+  const auto range = Parse("<1.2.0 || =2.0.*");
+  CHECK(range.Contains({1, 1}));
+  CHECK(!range.Contains({1, 2}));
+  CHECK(range.Contains({2, 0, 5}));
+  CHECK(!range.Contains({2, 1}));
+}
+
+void TestMalformedRanges() {
+  for (auto&& invalid: {
+         "",
+         " ",
+         "||",
+         "1 ||",
+         "|| 1",
+         "1 || || 2",
+         "1 | 2",
+         "<",
+         "<=",
+         "< 1",
+         "=>1",
+         "<<1",
+         "!=1",
+         "1.x",
+         "abc",
+         "1.2.3.4",
+         "1.*.3",
+         "*.1",
+         "65536",
+       }) {
+    const auto parsed = VersionRange::Parse(invalid);
+    CHECK(!parsed.has_value());
+    CHECK(!parsed.error().empty());
+  }
+
+  // Errors identify the problem
+  CHECK(VersionRange::Parse("1 || <1.x").error().contains("'1.x'"));
+}
+
+}// namespace
+}// namespace FredEmmott::OpenXRLayers::Tests
+
+int main() {
+  using namespace FredEmmott::OpenXRLayers::Tests;
+
+  RUN_TEST(TestParseVersion);
+  RUN_TEST(TestVersionToString);
+  RUN_TEST(TestBoundaries);
+  RUN_TEST(TestWildcards);
+  RUN_TEST(TestAlternatives);
+  RUN_TEST(TestMalformedRanges);
+  return EXIT_SUCCESS;
+}
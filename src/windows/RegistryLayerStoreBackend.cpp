@@ -0,0 +1,85 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "RegistryLayerStoreBackend.hpp"
+
+namespace FredEmmott::OpenXRLayers {
+
+RegistryLayerStoreBackend::RegistryLayerStoreBackend(const HKEY key)
+  : mKey(key) {}
+
+std::vector<LayerStoreBackend::Entry> RegistryLayerStoreBackend::Read() const {
+  if (!mKey) {
+    return {};
+  }
+
+  // https://docs.microsoft.com/en-us/windows/win32/sysinfo/registry-element-size-limits
+  constexpr DWORD maxNameSize {16383};
+  wchar_t nameBuffer[maxNameSize];
+  DWORD nameSize {maxNameSize};
+  DWORD dataType {};
+  DWORD disabled {1};
+  DWORD disabledSize {sizeof(disabled)};
+
+  DWORD index = 0;
+
+  std::vector<Entry> entries;
+  bool moreItems = true;
+  while (moreItems) {
+    const auto result = RegEnumValueW(
+      mKey,
+      index++,
+      nameBuffer,
+      &nameSize,
+      nullptr,
+      &dataType,
+      reinterpret_cast<LPBYTE>(&disabled),
+      &disabledSize);
+    switch (result) {
+      case ERROR_SUCCESS:
+        break;
+      case ERROR_NO_MORE_ITEMS:
+        moreItems = false;
+        continue;
+      case ERROR_MORE_DATA:
+        // Bigger than a DWORD means not a DWORD< so handled by dataType check
+        break;
+      default:
+#ifndef NDEBUG
+        __debugbreak();
+#endif
+        break;
+    }
+
+    entries.push_back({std::wstring_view {nameBuffer, nameSize}});
+    if (dataType == REG_DWORD) {
+      entries.back().mDisabled = disabled;
+    }
+
+    nameSize = maxNameSize;
+    disabledSize = sizeof(disabled);
+  }
+  return entries;
+}
+
+bool RegistryLayerStoreBackend::Set(
+  const std::filesystem::path& manifestPath,
+  const uint32_t disabled) {
+  const DWORD value {disabled};
+  return RegSetValueExW(
+           mKey,
+           manifestPath.wstring().c_str(),
+           NULL,
+           REG_DWORD,
+           reinterpret_cast<const BYTE*>(&value),
+           sizeof(value))
+    == ERROR_SUCCESS;
+}
+
+bool RegistryLayerStoreBackend::Delete(
+  const std::filesystem::path& manifestPath) {
+  return RegDeleteValueW(mKey, manifestPath.wstring().c_str())
+    == ERROR_SUCCESS;
+}
+
+}// namespace FredEmmott::OpenXRLayers
@@ -0,0 +1,29 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <Windows.h>
+
+#include "LayerStoreBackend.hpp"
+
+namespace FredEmmott::OpenXRLayers {
+
+/** The values of an OpenXR `ApiLayers` registry key.
+ *
+ * Each value is named after the manifest path, with a DWORD that is 0 if the
+ * layer is enabled. Does not own the key.
+ */
+class RegistryLayerStoreBackend final : public LayerStoreBackend {
+ public:
+  RegistryLayerStoreBackend() = delete;
+  explicit RegistryLayerStoreBackend(HKEY key);
+
+  std::vector<Entry> Read() const override;
+  bool Set(const std::filesystem::path&, uint32_t disabled) override;
+  bool Delete(const std::filesystem::path&) override;
+
+ private:
+  HKEY mKey {};
+};
+
+}// namespace FredEmmott::OpenXRLayers
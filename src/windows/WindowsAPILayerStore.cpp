@@ -5,12 +5,9 @@
 
 #include <Windows.h>
 
-#include <fmt/chrono.h>
 #include <fmt/core.h>
 
-#include <chrono>
 #include <filesystem>
-#include <fstream>
 
 #include <ShlObj.h>
 
@@ -18,7 +15,8 @@
 #include "Config.hpp"
 #include "EnabledExplicitAPILayerStore.hpp"
 #include "OverridePathsAPILayerStore.hpp"
-#include "windows/GetKnownFolderPath.hpp"
+#include "Platform.hpp"
+#include "RegistryLayerStoreBackend.hpp"
 
 namespace FredEmmott::OpenXRLayers {
 
@@ -82,64 +80,9 @@ std::string WindowsAPILayerStore::GetDisplayName() const noexcept {
 }
 
 std::vector<APILayer> WindowsAPILayerStore::GetAPILayers() const noexcept {
-  if (!mKey) {
-    return {};
-  }
-
-  // https://docs.microsoft.com/en-us/windows/win32/sysinfo/registry-element-size-limits
-  constexpr DWORD maxNameSize {16383};
-  wchar_t nameBuffer[maxNameSize];
-  DWORD nameSize {maxNameSize};
-  DWORD dataType {};
-  DWORD disabled {1};
-  DWORD disabledSize {sizeof(disabled)};
-
-  DWORD index = 0;
-
-  std::vector<APILayer> layers;
-  bool moreItems = true;
-  while (moreItems) {
-    using Value = APILayer::Value;
-    const auto result = RegEnumValueW(
-      mKey.get(),
-      index++,
-      nameBuffer,
-      &nameSize,
-      nullptr,
-      &dataType,
-      reinterpret_cast<LPBYTE>(&disabled),
-      &disabledSize);
-    switch (result) {
-      case ERROR_SUCCESS:
-        break;
-      case ERROR_NO_MORE_ITEMS:
-        moreItems = false;
-        continue;
-      case ERROR_MORE_DATA:
-        // Bigger than a DWORD means not a DWORD< so handled by dataType check
-        break;
-      default:
-#ifndef NDEBUG
-        __debugbreak();
-#endif
-        break;
-    }
-
-    if (dataType == REG_DWORD) {
-      layers.emplace_back(
-        this,
-        std::wstring_view {nameBuffer, nameSize},
-        disabled ? Value::Disabled : Value::Enabled);
-    } else {
-      layers.emplace_back(
-        this, std::wstring_view {nameBuffer, nameSize}, Value::Win32_NotDWORD);
-    }
-
-    nameSize = maxNameSize;
-    disabledSize = sizeof(disabled);
-  }
-  return layers;
+  return ToAPILayers(this, RegistryLayerStoreBackend {mKey.get()}.Read());
 }
+
 Architectures WindowsAPILayerStore::GetArchitectures() const noexcept {
   constexpr auto BuiltFor = Platform::GetBuildArchitecture();
   using enum Architecture;
@@ -180,61 +123,39 @@ class ReadWriteWindowsAPILayerStore final : public WindowsAPILayerStore,
 
   bool SetAPILayers(
     const std::vector<APILayer>& newLayers) const noexcept override {
-    BackupAPILayers();
-
-    const auto oldLayers = GetAPILayers();
-    if (oldLayers == newLayers) {
-      return false;
-    }
-
     if (!mKey) {
       return false;
     }
-
-    for (const auto& layer: oldLayers) {
-      RegDeleteValueW(mKey.get(), layer.mManifestPath.wstring().c_str());
-    }
-
-    for (const auto& layer: newLayers) {
-      DWORD disabled = layer.IsEnabled() ? 0 : 1;
-      RegSetValueExW(
-        mKey.get(),
-        layer.mManifestPath.wstring().c_str(),
-        NULL,
-        REG_DWORD,
-        reinterpret_cast<BYTE*>(&disabled),
-        sizeof(disabled));
+    RegistryLayerStoreBackend backend {mKey.get()};
+    const auto edits
+      = DiffLayerStore(backend.Read(), ToLayerStoreEntries(newLayers));
+    if (edits.empty()) {
+      return false;
     }
-    return true;
+    const auto ok = ApplyLayerStoreEdits(backend, edits);
+    // Don't wait for the registry watcher; callers may read the layers
+    // immediately
+    InvalidateSnapshot();
+    return ok;
   }
 
- private:
-  mutable bool mHaveBackup {false};
-
-  void BackupAPILayers() const {
-    if (mHaveBackup) {
-      return;
+  bool WriteAPILayers(
+    const std::vector<APILayer>& before,
+    const std::vector<APILayer>& after) const noexcept override {
+    if (!mKey) {
+      return false;
     }
-
-    const auto backupFolder = GetKnownFolderPath<FOLDERID_LocalAppData>()
-      / "OpenXR API Layers GUI" / "Backups";
-    if (!std::filesystem::is_directory(backupFolder)) {
-      std::filesystem::create_directories(backupFolder);
+    // Only touch the values that need to change, so that toggling a layer
+    // triggers one registry notification, not one per layer
+    const auto edits = DiffLayerStore(
+      ToLayerStoreEntries(before), ToLayerStoreEntries(after));
+    if (edits.empty()) {
+      return true;
     }
-
-    const auto path = backupFolder
-      / fmt::format("{:%F-%H-%M-%S}-{}.tsv",
-                    std::chrono::time_point_cast<std::chrono::seconds>(
-                      std::chrono::system_clock::now()),
-                    this->GetDisplayName());
-
-    std::ofstream f(path);
-    for (const auto& layer: GetAPILayers()) {
-      f << (layer.IsEnabled() ? "0" : "1") << "\t"
-        << layer.mManifestPath.string() << "\n";
-    }
-
-    mHaveBackup = true;
+    RegistryLayerStoreBackend backend {mKey.get()};
+    const auto ok = ApplyLayerStoreEdits(backend, edits);
+    InvalidateSnapshot();
+    return ok;
   }
 };
 
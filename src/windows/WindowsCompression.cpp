@@ -0,0 +1,94 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "Compression.hpp"
+
+#include <Windows.h>
+
+#include <wil/resource.h>
+
+#include <utility>
+
+#include <compressapi.h>
+
+namespace FredEmmott::OpenXRLayers::Compression {
+
+namespace {
+
+using unique_compressor = wil::unique_any<
+  COMPRESSOR_HANDLE,
+  decltype(&CloseCompressor),
+  CloseCompressor>;
+using unique_decompressor = wil::unique_any<
+  DECOMPRESSOR_HANDLE,
+  decltype(&CloseDecompressor),
+  CloseDecompressor>;
+
+}// namespace
+
+Compressed Compress(const std::string_view data) {
+  const Compressed stored {Algorithm::None, std::string {data}};
+
+  unique_compressor compressor;
+  if (!CreateCompressor(
+        COMPRESS_ALGORITHM_XPRESS_HUFF, nullptr, compressor.put())) {
+    return stored;
+  }
+
+  SIZE_T size {};
+  if (
+    !::Compress(
+      compressor.get(), data.data(), data.size(), nullptr, 0, &size)
+    && GetLastError() != ERROR_INSUFFICIENT_BUFFER) {
+    return stored;
+  }
+  std::string ret(size, '\0');
+  if (!::Compress(
+        compressor.get(),
+        data.data(),
+        data.size(),
+        ret.data(),
+        ret.size(),
+        &size)) {
+    return stored;
+  }
+  ret.resize(size);
+  return {Algorithm::XpressHuff, std::move(ret)};
+}
+
+std::optional<std::string> Decompress(
+  const Algorithm algorithm,
+  const std::string_view data,
+  const std::size_t decompressedSize) {
+  if (algorithm == Algorithm::None) {
+    if (data.size() != decompressedSize) {
+      return std::nullopt;
+    }
+    return std::string {data};
+  }
+  if (algorithm != Algorithm::XpressHuff) {
+    return std::nullopt;
+  }
+
+  unique_decompressor decompressor;
+  if (!CreateDecompressor(
+        COMPRESS_ALGORITHM_XPRESS_HUFF, nullptr, decompressor.put())) {
+    return std::nullopt;
+  }
+  std::string ret(decompressedSize, '\0');
+  SIZE_T size {};
+  if (
+    !::Decompress(
+      decompressor.get(),
+      data.data(),
+      data.size(),
+      ret.data(),
+      ret.size(),
+      &size)
+    || size != decompressedSize) {
+    return std::nullopt;
+  }
+  return ret;
+}
+
+}// namespace FredEmmott::OpenXRLayers::Compression
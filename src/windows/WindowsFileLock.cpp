@@ -0,0 +1,52 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "FileLock.hpp"
+
+#include <Windows.h>
+
+#include <wil/resource.h>
+
+#include <utility>
+
+namespace FredEmmott::OpenXRLayers {
+
+struct FileLock::Impl {
+  wil::unique_hfile mFile;
+};
+
+FileLock::FileLock(const std::filesystem::path& path) {
+  wil::unique_hfile file {CreateFileW(
+    path.c_str(),
+    GENERIC_READ | GENERIC_WRITE,
+    FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+    nullptr,
+    OPEN_ALWAYS,
+    FILE_ATTRIBUTE_NORMAL,
+    nullptr)};
+  if (!file) {
+    return;
+  }
+  // The whole file, even though it is empty; this is only used as a mutex
+  OVERLAPPED overlapped {};
+  if (!LockFileEx(
+        file.get(),
+        LOCKFILE_EXCLUSIVE_LOCK,
+        0,
+        MAXDWORD,
+        MAXDWORD,
+        &overlapped)) {
+    return;
+  }
+  mImpl.reset(new Impl {std::move(file)});
+}
+
+FileLock::~FileLock() {
+  if (!mImpl) {
+    return;
+  }
+  OVERLAPPED overlapped {};
+  UnlockFileEx(mImpl->mFile.get(), 0, MAXDWORD, MAXDWORD, &overlapped);
+}
+
+}// namespace FredEmmott::OpenXRLayers
@@ -0,0 +1,431 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "windows/WindowsLoaderDataSpawner.hpp"
+
+#include <Windows.h>
+
+#include <wil/resource.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cwchar>
+#include <format>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include <userenv.h>
+
+#include "LoaderDataFormat.hpp"
+#include "Platform.hpp"
+#include "windows/check.hpp"
+
+namespace FredEmmott::OpenXRLayers {
+
+namespace {
+
+template <class T>
+std::unexpected<T> UnexpectedHRESULT(HRESULT value) {
+  return std::unexpected {
+    T {{value, std::system_category()}},
+  };
+}
+
+template <class T>
+std::unexpected<T> UnexpectedGetLastError() {
+  return UnexpectedHRESULT<T>(HRESULT_FROM_WIN32(GetLastError()));
+}
+
+/** Copy an environment block, setting `XR_RUNTIME_JSON`.
+ *
+ * Blocks must be sorted case-insensitively by name, so this is inserted in
+ * order rather than appended.
+ */
+std::wstring OverrideRuntime(
+  const wchar_t* environment,
+  const std::filesystem::path& runtime) {
+  constexpr std::wstring_view Name {L"XR_RUNTIME_JSON"};
+  const auto entry = std::format(L"{}={}", Name, runtime.wstring());
+
+  std::wstring ret;
+  bool inserted = false;
+  for (auto it = environment; it && *it; it += wcslen(it) + 1) {
+    const std::wstring_view existing {it};
+    const auto existingName = existing.substr(0, existing.find(L'=', 1));
+    const auto order = CompareStringOrdinal(
+      existingName.data(),
+      static_cast<int>(existingName.size()),
+      Name.data(),
+      static_cast<int>(Name.size()),
+      /* ignore case = */ TRUE);
+    if (order == CSTR_EQUAL) {
+      continue;
+    }
+    if (order == CSTR_GREATER_THAN && !inserted) {
+      ret += entry;
+      ret += L'\0';
+      inserted = true;
+    }
+    ret += existing;
+    ret += L'\0';
+  }
+  if (!inserted) {
+    ret += entry;
+    ret += L'\0';
+  }
+  // Double-terminated
+  ret += L'\0';
+  return ret;
+}
+
+class WindowsLoaderDataServer final : public LoaderDataServer {
+ public:
+  WindowsLoaderDataServer(
+    wil::unique_handle process,
+    wil::unique_handle thread,
+    wil::unique_handle stdinWritePipe,
+    wil::unique_handle stdoutReadPipe)
+    : mProcess(std::move(process)),
+      mThread(std::move(thread)),
+      mStdinWritePipe(std::move(stdinWritePipe)),
+      mStdoutReadPipe(std::move(stdoutReadPipe)) {}
+
+  ~WindowsLoaderDataServer() override {
+    if (mProcess) {
+      TerminateProcess(mProcess.get(), 0);
+    }
+  }
+
+  std::expected<void, LoaderData::Error> SendQuery() override {
+    ThrowIfExited();
+    const auto request = std::format("{}\n", QueryRequest);
+    DWORD bytesWritten {};
+    if (!WriteFile(
+          mStdinWritePipe.get(),
+          request.data(),
+          static_cast<DWORD>(request.size()),
+          &bytesWritten,
+          nullptr)) {
+      return std::unexpected {Exited()};
+    }
+    return {};
+  }
+
+  std::expected<std::string, LoaderData::Error> ReadResponse(
+    const std::chrono::steady_clock::time_point deadline,
+    const std::stop_token cancel) override {
+    ThrowIfExited();
+
+    // Reads from anonymous pipes can not time out, so kill the helper from
+    // another thread instead; that closes the pipe, unblocking `ReadFile()`.
+    //
+    // Cancellation aborts the read instead, so the helper can be reused
+    const auto timeout = std::chrono::ceil<std::chrono::milliseconds>(
+      deadline - std::chrono::steady_clock::now());
+    wil::unique_event responded;
+    responded.create();
+    wil::unique_event cancelled;
+    cancelled.create();
+    const std::stop_callback onCancel(
+      cancel, [&cancelled] { cancelled.SetEvent(); });
+    const wil::unique_handle reader {
+      OpenThread(THREAD_TERMINATE, FALSE, GetCurrentThreadId())};
+    bool timedOut = false;
+    std::atomic_bool wasCancelled {false};
+    std::jthread watchdog {[&, process = mProcess.get()] {
+      const HANDLE events[] {responded.get(), cancelled.get()};
+      const auto result = WaitForMultipleObjects(
+        std::size(events),
+        events,
+        /* wait all = */ FALSE,
+        static_cast<DWORD>(std::max<int64_t>(timeout.count(), 0)));
+      if (result == WAIT_TIMEOUT) {
+        timedOut = true;
+        TerminateProcess(process, ERROR_TIMEOUT);
+      } else if (result == WAIT_OBJECT_0 + 1) {
+        wasCancelled = true;
+        // Repeated, as the reader may be just about to call `ReadFile()`
+        do {
+          CancelSynchronousIo(reader.get());
+        } while (WaitForSingleObject(responded.get(), 10) == WAIT_TIMEOUT);
+      }
+    }};
+    const auto stopWatchdog = wil::scope_exit([&] {
+      responded.SetEvent();
+      watchdog.join();
+    });
+
+    // Responses are usually tens of kilobytes
+    char buffer[64 * 1024];
+    DWORD bytesRead;
+    while (true) {
+      auto frame = LoaderDataFormat::TakeFrame(mBuffer);
+      if (!frame) {
+        return std::unexpected {std::move(frame).error()};
+      }
+      if (*frame) {
+        return std::move(**frame);
+      }
+      if (wasCancelled) {
+        break;
+      }
+      if (!(ReadFile(
+              mStdoutReadPipe.get(),
+              buffer,
+              sizeof(buffer),
+              &bytesRead,
+              nullptr)
+            && bytesRead > 0)) {
+        break;
+      }
+      mBuffer.append(buffer, bytesRead);
+    }
+
+    // The helper is only killed on timeout; if it exited instead, the next
+    // call will find out
+    if (wasCancelled) {
+      // Anything already read stays in `mBuffer` for the next call
+      stopWatchdog.reset();
+      return std::unexpected {LoaderData::PendingError {}};
+    }
+
+    WaitForSingleObject(mProcess.get(), INFINITE);
+    stopWatchdog.reset();
+    const auto exited = Exited();
+    if (timedOut) {
+      return std::unexpected {LoaderData::TimeoutError {timeout}};
+    }
+    return std::unexpected {exited};
+  }
+
+ private:
+  wil::unique_handle mProcess;
+  wil::unique_handle mThread;
+  wil::unique_handle mStdinWritePipe;
+  wil::unique_handle mStdoutReadPipe;
+  // Output after the last complete response
+  std::string mBuffer;
+
+  void ThrowIfExited() const {
+    if (!(mProcess && mStdinWritePipe && mStdoutReadPipe)) {
+      throw std::logic_error("LoaderDataServer used after the helper exited");
+    }
+  }
+
+  LoaderData::BadExitCodeError Exited() {
+    mStdinWritePipe.reset();
+    mStdoutReadPipe.reset();
+    WaitForSingleObject(mProcess.get(), INFINITE);
+    DWORD exitCode {};
+    GetExitCodeProcess(mProcess.get(), &exitCode);
+    mProcess.reset();
+    return {exitCode};
+  }
+};
+
+}// namespace
+
+WindowsLoaderDataSpawner::WindowsLoaderDataSpawner() {
+  // Get the shell token to de-elevate
+  {
+    wil::unique_handle processToken;
+    // Gain SE_DEBUG_NAME so we can attach to explorer; we need this because
+    // the loader will ignore XR_API_LAYER_PATHS if elevated
+    OpenProcessToken(
+      GetCurrentProcess(),
+      TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY,
+      processToken.put());
+    LUID luid {};
+    LookupPrivilegeValueW(NULL, SE_DEBUG_NAME, &luid);
+    TOKEN_PRIVILEGES tp {};
+    tp.PrivilegeCount = 1;
+    tp.Privileges[0].Luid = luid;
+    tp.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+    AdjustTokenPrivileges(
+      processToken.get(), FALSE, &tp, sizeof(tp), nullptr, nullptr);
+  }
+  {
+    DWORD processId;
+    GetWindowThreadProcessId(GetShellWindow(), &processId);
+    wil::unique_handle shell {
+      OpenProcess(PROCESS_QUERY_INFORMATION, FALSE, processId)};
+    wil::unique_handle token;
+    OpenProcessToken(shell.get(), TOKEN_DUPLICATE, token.put());
+    DuplicateTokenEx(
+      token.get(),
+      TOKEN_ALL_ACCESS,
+      nullptr,
+      SecurityImpersonation,
+      TokenPrimary,
+      mToken.put());
+  }
+
+  mJob.reset(CreateJobObjectW(nullptr, nullptr));
+  {
+    JOBOBJECT_EXTENDED_LIMIT_INFORMATION limit {};
+    limit.BasicLimitInformation.LimitFlags = JOB_OBJECT_LIMIT_KILL_ON_JOB_CLOSE;
+    CheckHRESULT(SetInformationJobObject(
+      mJob.get(), JobObjectExtendedLimitInformation, &limit, sizeof(limit)));
+  };
+}
+
+WindowsLoaderDataSpawner::~WindowsLoaderDataSpawner() = default;
+
+std::expected<std::unique_ptr<LoaderDataServer>, LoaderData::Error>
+WindowsLoaderDataSpawner::SpawnServer(
+  const Architecture arch,
+  const std::optional<std::filesystem::path>& runtime) {
+  SECURITY_ATTRIBUTES saAttr {
+    .nLength = sizeof(SECURITY_ATTRIBUTES),
+    .bInheritHandle = TRUE,
+  };
+
+  wil::unique_handle stdinRead;
+  wil::unique_handle stdinWrite;
+  wil::unique_handle stdoutRead;
+  wil::unique_handle stdoutWrite;
+  if (
+    !CreatePipe(stdinRead.put(), stdinWrite.put(), &saAttr, 0)
+    || !CreatePipe(stdoutRead.put(), stdoutWrite.put(), &saAttr, 0)) {
+    return UnexpectedGetLastError<LoaderData::PipeCreationError>();
+  }
+  if (
+    !SetHandleInformation(stdinWrite.get(), HANDLE_FLAG_INHERIT, 0)
+    || !SetHandleInformation(stdoutRead.get(), HANDLE_FLAG_INHERIT, 0)) {
+    return UnexpectedGetLastError<LoaderData::PipeAttributeError>();
+  }
+
+  constexpr auto MaxPathExtended = 32768;
+  wchar_t modulePath[MaxPathExtended];
+  if (!GetModuleFileNameW(nullptr, modulePath, MaxPathExtended)) {
+    return UnexpectedGetLastError<
+      LoaderData::CanNotFindCurrentExecutableError>();
+  }
+
+  STARTUPINFOW si {
+    .cb = sizeof(STARTUPINFOW),
+    .dwFlags = STARTF_USESTDHANDLES,
+    .hStdInput = stdinRead.get(),
+    .hStdOutput = stdoutWrite.get(),
+  };
+  PROCESS_INFORMATION pi {};
+
+  const auto helper = std::filesystem::path {modulePath}.parent_path()
+    / GetHelperFileName(arch);
+  if (!exists(helper)) {
+    return std::unexpected {
+      LoaderData::CanNotFindHelperExecutableError {helper}};
+  }
+  if (const auto signature = Platform::Get().GetSharedLibrarySignature(helper);
+      !signature) {
+    constexpr auto AllowUnsigned =
+#ifdef ALLOW_UNSIGNED_LOADER_DATA_HELPERS
+      true;
+#else
+      false;
+#endif
+    if constexpr (AllowUnsigned) {
+      OutputDebugStringW(
+        std::format(L"⚠️ Allowing unsigned helper: {}", helper.wstring())
+          .c_str());
+    } else {
+      static std::once_flag sWarnOnce;
+      std::call_once(sWarnOnce, [helper] {
+        MessageBoxW(
+          nullptr,
+          std::format(
+            L"{} has been tampered with; you should check your system for "
+            L"malware.",
+            helper.filename().wstring())
+            .c_str(),
+          L"OpenXR API Layers GUI",
+          MB_OK | MB_ICONEXCLAMATION);
+      });
+      return std::unexpected {
+        LoaderData::UnsignedHelperError {helper, signature.error()}};
+    }
+  }
+
+  void* environment {};
+  CreateEnvironmentBlock(&environment, mToken.get(), /* INHERIT = */ TRUE);
+  const auto freeEnvironment
+    = wil::scope_exit([environment] { DestroyEnvironmentBlock(environment); });
+  std::wstring overriddenEnvironment;
+  if (runtime) {
+    overriddenEnvironment
+      = OverrideRuntime(static_cast<const wchar_t*>(environment), *runtime);
+  }
+  // Must be writable
+  auto commandLine = std::format(
+    L"\"{}\" {}",
+    helper.wstring(),
+    std::wstring {
+      LoaderDataServer::CommandLineFlag.begin(),
+      LoaderDataServer::CommandLineFlag.end()});
+  if (!CreateProcessWithTokenW(
+        mToken.get(),
+        LOGON_WITH_PROFILE,
+        helper.wstring().c_str(),
+        commandLine.data(),
+        CREATE_NO_WINDOW | CREATE_UNICODE_ENVIRONMENT,
+        runtime ? overriddenEnvironment.data() : environment,
+        nullptr,
+        &si,
+        &pi)) {
+    return UnexpectedGetLastError<LoaderData::CanNotSpawnError>();
+  }
+  AssignProcessToJobObject(mJob.get(), pi.hProcess);
+  stdinRead.reset();
+  stdoutWrite.reset();
+
+  return std::make_unique<WindowsLoaderDataServer>(
+    wil::unique_handle {pi.hProcess},
+    wil::unique_handle {pi.hThread},
+    std::move(stdinWrite),
+    std::move(stdoutRead));
+}
+
+std::size_t WindowsLoaderDataSpawner::GetServerFingerprint(
+  const Architecture arch) {
+  // The same environment the helper would be started with
+  std::wstring fingerprint;
+  void* environment {};
+  if (CreateEnvironmentBlock(
+        &environment, mToken.get(), /* INHERIT = */ TRUE)) {
+    const auto freeEnvironment = wil::scope_exit(
+      [environment] { DestroyEnvironmentBlock(environment); });
+    for (auto it = static_cast<const wchar_t*>(environment); *it;
+         it += wcslen(it) + 1) {
+      fingerprint += it;
+      fingerprint += L'\0';
+    }
+  }
+
+  auto& platform = Platform::Get();
+  const auto appendFile = [&](const std::filesystem::path& path) {
+    fingerprint += path.wstring();
+    fingerprint += L'\0';
+    fingerprint += std::to_wstring(
+      platform.GetFileChangeTime(path).time_since_epoch().count());
+    fingerprint += L'\0';
+  };
+
+  if (const auto runtime = platform.GetActiveRuntime(arch)) {
+    appendFile(runtime->mPath);
+    if (runtime->mManifestData) {
+      appendFile(runtime->mManifestData->mLibraryPath);
+    }
+  }
+  // e.g. if the app has been updated while running
+  appendFile(platform.GetExecutableDirectory() / GetHelperFileName(arch));
+
+  return std::hash<std::wstring> {}(fingerprint);
+}
+
+}// namespace FredEmmott::OpenXRLayers
@@ -0,0 +1,33 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <wil/resource.h>
+
+#include "LoaderDataService.hpp"
+
+namespace FredEmmott::OpenXRLayers {
+
+/** Runs the helpers de-elevated, as the shell's user.
+ *
+ * The loader ignores `XR_API_LAYER_PATH` when elevated, so the helpers use
+ * the shell's token. They are also in a job object, so they are killed if we
+ * exit first.
+ */
+class WindowsLoaderDataSpawner final : public LoaderDataSpawner {
+ public:
+  WindowsLoaderDataSpawner();
+  ~WindowsLoaderDataSpawner() override;
+
+  std::expected<std::unique_ptr<LoaderDataServer>, LoaderData::Error>
+  SpawnServer(
+    Architecture,
+    const std::optional<std::filesystem::path>& runtime) override;
+  std::size_t GetServerFingerprint(Architecture) override;
+
+ private:
+  wil::unique_handle mToken;
+  wil::unique_handle mJob;
+};
+
+}// namespace FredEmmott::OpenXRLayers
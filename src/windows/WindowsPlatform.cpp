@@ -9,12 +9,14 @@
 #include <SoftPub.h>
 
 #include <wil/com.h>
+#include <wil/filesystem.h>
 #include <wil/registry.h>
 #include <wil/resource.h>
 
 #include <fmt/format.h>
 #include <nlohmann/json.hpp>
 
+#include <algorithm>
 #include <bit>
 #include <chrono>
 #include <format>
@@ -29,14 +31,17 @@
 #include <imgui_impl_win32.h>
 #include <shellapi.h>
 #include <shtypes.h>
-#include <userenv.h>
 
 #include "APILayerStore.hpp"
 #include "CheckForUpdates.hpp"
 #include "Config.hpp"
 #include "LoaderData.hpp"
+#include "LoaderDataCache.hpp"
+#include "LoaderDataService.hpp"
 #include "Platform.hpp"
+#include "UserLayerRules.hpp"
 #include "windows/GetKnownFolderPath.hpp"
+#include "windows/WindowsLoaderDataSpawner.hpp"
 
 extern IMGUI_IMPL_API LRESULT ImGui_ImplWin32_WndProcHandler(
   HWND hWnd,
@@ -205,6 +210,11 @@ void WindowsPlatform::GUIMain(const std::function<void()> drawFrame) {
   this->MainLoop(drawFrame);
 }
 
+void WindowsPlatform::RequestFrame(
+  const std::chrono::steady_clock::time_point when) {
+  mRequestedFrame = std::min(mRequestedFrame, when);
+}
+
 void WindowsPlatform::MainLoop(const std::function<void()>& drawFrame) {
   constexpr auto Interval
     = std::chrono::microseconds(1000000 / Config::MAX_FPS);
@@ -212,17 +222,15 @@ void WindowsPlatform::MainLoop(const std::function<void()>& drawFrame) {
   mNewFrameEvent.create();
   const auto changeSubscriptions = APILayerStore::Get()
     | std::views::transform([e = mNewFrameEvent.get(), this](const auto store) {
-                                     return store->OnChange([e, this] {
-                                       {
-                                         const std::unique_lock lock(mMutex);
-                                         mLoaderDataIsStale = true;
-                                         mLoaderData.clear();
-                                       }
-                                       mLoaderDataCondition.notify_all();
+                                     return store->OnChange([e, store, this] {
+                                       GetLoaderDataService().Invalidate(
+                                         store->GetArchitectures());
                                        SetEvent(e);
                                      });
                                    })
     | std::ranges::to<std::vector>();
+  const auto rulesSubscription = UserLayerRules::Get().OnChange(
+    [e = mNewFrameEvent.get()] { SetEvent(e); });
 
   while (true) {
     const auto earliestNextFrame = std::chrono::steady_clock::now() + Interval;
@@ -237,6 +245,7 @@ void WindowsPlatform::MainLoop(const std::function<void()>& drawFrame) {
     }
 
     mNewFrameEvent.ResetEvent();
+    mRequestedFrame = std::chrono::steady_clock::time_point::max();
 
     {
       this->BeforeFrame();
@@ -245,8 +254,14 @@ void WindowsPlatform::MainLoop(const std::function<void()>& drawFrame) {
     }
 
     {
+      DWORD timeout = INFINITE;
+      if (mRequestedFrame != std::chrono::steady_clock::time_point::max()) {
+        const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(
+          mRequestedFrame - std::chrono::steady_clock::now());
+        timeout = static_cast<DWORD>(std::max<int64_t>(remaining.count(), 0));
+      }
       const auto e = mNewFrameEvent.get();
-      MsgWaitForMultipleObjects(1, &e, FALSE, INFINITE, QS_ALLINPUT);
+      MsgWaitForMultipleObjects(1, &e, FALSE, timeout, QS_ALLINPUT);
     }
     const auto sleepFor = earliestNextFrame - std::chrono::steady_clock::now();
     if (sleepFor > std::chrono::steady_clock::duration::zero()) {
@@ -258,9 +273,7 @@ void WindowsPlatform::MainLoop(const std::function<void()>& drawFrame) {
 
 void WindowsPlatform::Initialize() {
   static std::string sIniPath;
-  sIniPath = (GetKnownFolderPath<FOLDERID_LocalAppData>()
-              / "OpenXR API Layers GUI" / "imgui.ini")
-               .string();
+  sIniPath = (GetUserDataDirectory() / "imgui.ini").string();
 
   SetProcessDpiAwarenessContext(DPI_AWARENESS_CONTEXT_PER_MONITOR_AWARE_V2);
   CheckHRESULT(CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED));
@@ -335,6 +348,108 @@ void WindowsPlatform::ShowFolderContainingFile(
   SHOpenFolderAndSelectItems(pidl.get(), 0, nullptr, 0);
 }
 
+std::filesystem::path WindowsPlatform::GetUserDataDirectory() {
+  const auto path
+    = GetKnownFolderPath<FOLDERID_LocalAppData>() / "OpenXR API Layers GUI";
+  if (!std::filesystem::is_directory(path)) {
+    std::filesystem::create_directories(path);
+  }
+  return path;
+}
+
+namespace {
+class WindowsDirectoryWatcher final : public DirectoryWatcher {
+ public:
+  explicit WindowsDirectoryWatcher(wil::unique_folder_change_reader reader)
+    : mReader(std::move(reader)) {}
+  ~WindowsDirectoryWatcher() override = default;
+
+ private:
+  wil::unique_folder_change_reader mReader;
+};
+}// namespace
+
+std::unique_ptr<DirectoryWatcher> WindowsPlatform::WatchDirectory(
+  const std::filesystem::path& directory,
+  std::function<void(const std::filesystem::path&)> callback) {
+  using enum wil::FolderChangeEvents;
+  return std::make_unique<WindowsDirectoryWatcher>(
+    wil::make_folder_change_reader(
+      directory.c_str(),
+      /* isRecursive = */ false,
+      FileName | LastWriteTime,
+      [callback = std::move(callback)](wil::FolderChangeEvent, PCWSTR name) {
+        callback(std::filesystem::path {name});
+      }));
+}
+
+std::filesystem::path WindowsPlatform::GetExecutableDirectory() {
+  constexpr auto MaxPathExtended = 32768;
+  std::wstring modulePath(MaxPathExtended, L'\0');
+  const auto length
+    = GetModuleFileNameW(nullptr, modulePath.data(), MaxPathExtended);
+  if (!length) {
+    return {};
+  }
+  modulePath.resize(length);
+  return std::filesystem::path {modulePath}.parent_path();
+}
+
+namespace {
+class WindowsMappedFile final : public MappedFile {
+ public:
+  WindowsMappedFile(
+    wil::unique_mapview_ptr<std::byte> view,
+    const std::size_t size)
+    : mView(std::move(view)),
+      mSize(size) {}
+  ~WindowsMappedFile() override = default;
+
+  std::span<const std::byte> GetData() const noexcept override {
+    return {mView.get(), mSize};
+  }
+
+ private:
+  wil::unique_mapview_ptr<std::byte> mView;
+  std::size_t mSize {};
+};
+}// namespace
+
+std::unique_ptr<MappedFile> WindowsPlatform::MapFile(
+  const std::filesystem::path& path) {
+  const wil::unique_hfile file {CreateFileW(
+    path.c_str(),
+    GENERIC_READ,
+    FILE_SHARE_READ | FILE_SHARE_DELETE,
+    nullptr,
+    OPEN_EXISTING,
+    FILE_ATTRIBUTE_NORMAL,
+    nullptr)};
+  if (!file) {
+    return nullptr;
+  }
+
+  LARGE_INTEGER size {};
+  if (!GetFileSizeEx(file.get(), &size) || size.QuadPart == 0) {
+    return nullptr;
+  }
+
+  // The view keeps the mapping alive, so we don't need to keep these
+  const wil::unique_handle mapping {
+    CreateFileMappingW(file.get(), nullptr, PAGE_READONLY, 0, 0, nullptr)};
+  if (!mapping) {
+    return nullptr;
+  }
+  wil::unique_mapview_ptr<std::byte> view {static_cast<std::byte*>(
+    MapViewOfFile(mapping.get(), FILE_MAP_READ, 0, 0, 0))};
+  if (!view) {
+    return nullptr;
+  }
+
+  return std::make_unique<WindowsMappedFile>(
+    std::move(view), static_cast<std::size_t>(size.QuadPart));
+}
+
 std::map<std::string, std::string> WindowsPlatform::GetEnvironmentVariables() {
   std::map<std::string, std::string> ret;
 
@@ -704,287 +819,67 @@ std::vector<std::filesystem::path> WindowsPlatform::GetNewAPILayerJSONPaths() {
   return ret;
 }
 
-template <class T>
-static std::unexpected<T> UnexpectedHRESULT(HRESULT value) {
-  return std::unexpected {
-    T {{value, std::system_category()}},
-  };
-}
-
-template <class T>
-static std::unexpected<T> UnexpectedGetLastError() {
-  return UnexpectedHRESULT<T>(HRESULT_FROM_WIN32(GetLastError()));
+LoaderDataService& WindowsPlatform::GetLoaderDataService() {
+  // Linters may be running concurrently, e.g. for fix previews
+  std::call_once(mLoaderDataServiceOnce, [this] {
+    mLoaderDataService = std::make_unique<LoaderDataService>(
+      std::make_unique<WindowsLoaderDataSpawner>(),
+      std::make_unique<LoaderDataCache>(GetUserDataDirectory() / "Cache"),
+      GetArchitectures(),
+      Config::LOADER_DATA_TIMEOUT,
+      Config::STORE_CHANGE_DEBOUNCE,
+      Config::MAX_CONCURRENT_RUNTIME_QUERIES);
+    mLoaderDataConnection = mLoaderDataService->OnUpdate([this] {
+      mOnLoaderDataSignal();
+      mNewFrameEvent.SetEvent();
+    });
+  });
+  return *mLoaderDataService;
 }
 
-std::expected<LoaderData, LoaderData::Error> WindowsPlatform::GetLoaderData(
-  const Architecture arch) {
+std::expected<std::shared_ptr<const LoaderData>, LoaderData::Error>
+WindowsPlatform::GetLoaderData(const Architecture arch) {
   assert(GetArchitectures().contains(arch));
-  EnsureLoaderDataThread();
-  const std::unique_lock lock(mMutex);
-  if (mLoaderDataIsStale || !mLoaderData.contains(arch)) {
-    return std::unexpected {LoaderData::PendingError {}};
-  }
-  return mLoaderData.at(arch);
+  return GetLoaderDataService().Get(arch);
 }
-std::expected<LoaderData, LoaderData::Error> WindowsPlatform::WaitForLoaderData(
+
+std::expected<std::shared_ptr<const LoaderData>, LoaderData::Error>
+WindowsPlatform::WaitForLoaderData(
   const Architecture arch,
   const std::chrono::steady_clock::time_point timeout) {
   assert(GetArchitectures().contains(arch));
-  EnsureLoaderDataThread();
-
-  std::unique_lock lock(mMutex);
-  if (mLoaderData.contains(arch)) {
-    const auto& data = mLoaderData.at(arch);
-    if (data) {
-      return data;
-    }
-    if (!holds_alternative<LoaderData::PendingError>(data.error())) {
-      return data;
-    }
-  }
-
-  const auto completed = mLoaderDataCondition.wait_until(
-    lock, timeout, [&] { return mLoaderData.contains(arch); });
-  if (!completed) {
-    return std::unexpected {LoaderData::PendingError {}};
-  }
-
-  return mLoaderData.at(arch);
-}
-
-void WindowsPlatform::EnsureLoaderDataThread() {
-  if (mLoaderDataThread.joinable()) {
-    return;
-  }
-  mLoaderDataThread = std::jthread {
-    std::bind_front(&WindowsPlatform::LoaderDataThreadMain, this)};
-}
-void WindowsPlatform::LoaderDataThreadMain(const std::stop_token token) {
-  SetThreadDescription(GetCurrentThread(), L"LoaderData Thread");
-
-  // Get the shell token to de-elevate
-  {
-    wil::unique_handle processToken;
-    // Gain SE_DEBUG_NAME so we can attach to explorer; we need this because
-    // the loader will ignore XR_API_LAYER_PATHS if elevated
-    OpenProcessToken(
-      GetCurrentProcess(),
-      TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY,
-      processToken.put());
-    LUID luid {};
-    LookupPrivilegeValueW(NULL, SE_DEBUG_NAME, &luid);
-    TOKEN_PRIVILEGES tp {};
-    tp.PrivilegeCount = 1;
-    tp.Privileges[0].Luid = luid;
-    tp.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
-    AdjustTokenPrivileges(
-      processToken.get(), FALSE, &tp, sizeof(tp), nullptr, nullptr);
-  }
-  wil::unique_handle subprocessToken;
-  {
-    DWORD processId;
-    GetWindowThreadProcessId(GetShellWindow(), &processId);
-    wil::unique_handle shell {
-      OpenProcess(PROCESS_QUERY_INFORMATION, FALSE, processId)};
-    wil::unique_handle token;
-    OpenProcessToken(shell.get(), TOKEN_DUPLICATE, token.put());
-    DuplicateTokenEx(
-      token.get(),
-      TOKEN_ALL_ACCESS,
-      nullptr,
-      SecurityImpersonation,
-      TokenPrimary,
-      subprocessToken.put());
-  }
-
-  mLoaderDataJob.reset(CreateJobObjectW(nullptr, nullptr));
-  {
-    JOBOBJECT_EXTENDED_LIMIT_INFORMATION limit {};
-    limit.BasicLimitInformation.LimitFlags = JOB_OBJECT_LIMIT_KILL_ON_JOB_CLOSE;
-    CheckHRESULT(SetInformationJobObject(
-      mLoaderDataJob.get(),
-      JobObjectExtendedLimitInformation,
-      &limit,
-      sizeof(limit)));
-  };
-
-  while (true) {
-    {
-      std::unique_lock lock(mMutex);
-      const auto stopped = !mLoaderDataCondition.wait(
-        lock, token, [&] { return mLoaderDataIsStale; });
-      if (stopped)
-        return;
-
-      mLoaderDataIsStale = false;
-    }
-
-    std::unordered_map<Architecture, LoaderDataProcess> pending;
-    decltype(mLoaderData) newLoaderData;
-    for (const auto arch: GetArchitectures().enumerate()) {
-      auto subprocess = [&] {
-        return SpawnLoaderData(
-          mLoaderDataJob.get(), subprocessToken.get(), arch);
-      }();
-      if (!subprocess) {
-        newLoaderData.emplace(
-          arch, std::unexpected {std::move(subprocess).error()});
-        continue;
-      }
-      pending.emplace(arch, std::move(*subprocess));
-    }
-
-    for (auto&& [arch, process]: pending) {
-      newLoaderData.emplace(arch, std::move(process).Wait());
-#ifndef NDEBUG
-      if (
-        newLoaderData.at(arch) && newLoaderData.at(arch)->mArchitecture != arch)
-        [[unlikely]] {
-        throw std::runtime_error(
-          fmt::format(
-            "Architecture mismatch on loader data - got {}, expected {}",
-            magic_enum::enum_name(newLoaderData.at(arch)->mArchitecture),
-            magic_enum::enum_name(arch)));
-      }
-#endif
-    }
-
-    {
-      std::unique_lock lock(mMutex);
-      mLoaderData = std::move(newLoaderData);
-    }
-
-    mLoaderDataCondition.notify_all();
-    mOnLoaderDataSignal();
-    mNewFrameEvent.SetEvent();
-  }
-}
-
-std::expected<WindowsPlatform::LoaderDataProcess, LoaderData::Error>
-WindowsPlatform::SpawnLoaderData(
-  HANDLE const hJob,
-  HANDLE const token,
-  Architecture const arch) {
-  SECURITY_ATTRIBUTES saAttr {
-    .nLength = sizeof(SECURITY_ATTRIBUTES),
-    .bInheritHandle = TRUE,
-  };
-
-  wil::unique_handle stdoutRead;
-  wil::unique_handle stdoutWrite;
-  if (!CreatePipe(stdoutRead.put(), stdoutWrite.put(), &saAttr, 0)) {
-    return UnexpectedGetLastError<LoaderData::PipeCreationError>();
-  }
-  if (!SetHandleInformation(stdoutRead.get(), HANDLE_FLAG_INHERIT, 0)) {
-    return UnexpectedGetLastError<LoaderData::PipeAttributeError>();
-  }
-
-  constexpr auto MaxPathExtended = 32768;
-  wchar_t modulePath[MaxPathExtended];
-  if (!GetModuleFileNameW(nullptr, modulePath, MaxPathExtended)) {
-    return UnexpectedGetLastError<
-      LoaderData::CanNotFindCurrentExecutableError>();
-  }
-
-  STARTUPINFOW si {
-    .cb = sizeof(STARTUPINFOW),
-    .dwFlags = STARTF_USESTDHANDLES,
-    .hStdOutput = stdoutWrite.get(),
-  };
-  PROCESS_INFORMATION pi {};
-
-  const auto helper
-    = (std::filesystem::path {modulePath}.parent_path() / std::format("openxr-loader-data-{}.dll", magic_enum::enum_name(arch)));
-  if (!exists(helper)) {
-    return std::unexpected {
-      LoaderData::CanNotFindHelperExecutableError {helper}};
-  }
-  if (const auto signature = Get().GetSharedLibrarySignature(helper);
-      !signature) {
-    constexpr auto AllowUnsigned =
-#ifdef ALLOW_UNSIGNED_LOADER_DATA_HELPERS
-      true;
-#else
-      false;
-#endif
-    if constexpr (AllowUnsigned) {
-      OutputDebugStringW(
-        std::format(L"⚠️ Allowing unsigned helper: {}", helper.wstring())
-          .c_str());
-    } else {
-      static std::once_flag sWarnOnce;
-      std::call_once(sWarnOnce, [helper] {
-        MessageBoxW(
-          nullptr,
-          std::format(
-            L"{} has been tampered with; you should check your system for "
-            L"malware.",
-            helper.filename().wstring())
-            .c_str(),
-          L"OpenXR API Layers GUI",
-          MB_OK | MB_ICONEXCLAMATION);
+  return GetLoaderDataService().Wait(arch, timeout);
+}
+
+void WindowsPlatform::QueryAvailableRuntimes() {
+  auto& service = GetLoaderDataService();
+  for (const auto arch: GetArchitectures().enumerate()) {
+    LoaderDataService::RuntimeResults runtimes;
+    for (auto&& runtime: GetAvailableRuntimes(arch)) {
+      const auto& manifest = runtime.mManifestData;
+      runtimes.push_back({
+        .mRuntime = runtime.mPath,
+        .mName = (manifest && !manifest->mName.empty())
+          ? manifest->mName
+          : runtime.mPath.string(),
       });
-      return std::unexpected {
-        LoaderData::UnsignedHelperError {helper, signature.error()}};
     }
+    service.SetRuntimes(arch, std::move(runtimes));
   }
-
-  void* environment {};
-  CreateEnvironmentBlock(&environment, token, /* INHERIT = */ TRUE);
-  const auto freeEnvironment
-    = wil::scope_exit([environment] { DestroyEnvironmentBlock(environment); });
-  if (!CreateProcessWithTokenW(
-        token,
-        LOGON_WITH_PROFILE,
-        helper.wstring().c_str(),
-        nullptr,
-        CREATE_NO_WINDOW | CREATE_UNICODE_ENVIRONMENT,
-        environment,
-        nullptr,
-        &si,
-        &pi)) {
-    return UnexpectedGetLastError<LoaderData::CanNotSpawnError>();
-  }
-  AssignProcessToJobObject(hJob, pi.hProcess);
-  stdoutWrite.reset();
-
-  return LoaderDataProcess {
-    .mProcess = wil::unique_handle {pi.hProcess},
-    .mThread = wil::unique_handle {pi.hThread},
-    .mStdoutReadPipe = std::move(stdoutRead),
-  };
 }
 
-std::expected<LoaderData, LoaderData::Error>
-WindowsPlatform::LoaderDataProcess::Wait() && {
-  if (!(mProcess && mStdoutReadPipe)) {
-    throw std::logic_error(
-      "LoaderDataProcess::Wait() called with invalid handles - maybe moved?");
-  }
-  // We take a move-reference to self, so let's clean up when we're done
-  const auto release = wil::scope_exit([this] { *this = {}; });
-  std::string output;
-  char buffer[4096];
-  DWORD bytesRead;
-
-  while (
-    ReadFile(mStdoutReadPipe.get(), buffer, sizeof(buffer), &bytesRead, nullptr)
-    && bytesRead > 0) {
-    output.append(buffer, bytesRead);
-  }
-
-  WaitForSingleObject(mProcess.get(), INFINITE);
-
-  DWORD exitCode;
-  if (!GetExitCodeProcess(mProcess.get(), &exitCode) || exitCode != 0) {
-    return std::unexpected {LoaderData::BadExitCodeError {exitCode}};
-  }
+std::shared_ptr<const std::vector<RuntimeLoaderData>>
+WindowsPlatform::GetAvailableRuntimesLoaderData(const Architecture arch) {
+  assert(GetArchitectures().contains(arch));
+  return GetLoaderDataService().GetRuntimes(arch);
+}
 
-  try {
-    return static_cast<LoaderData>(nlohmann::json::parse(output));
-  } catch (const nlohmann::json::exception& e) {
-    return std::unexpected {LoaderData::InvalidJSONError {e.what()}};
-  }
+std::shared_ptr<const std::vector<RuntimeLoaderData>>
+WindowsPlatform::WaitForAvailableRuntimesLoaderData(
+  const Architecture arch,
+  const std::chrono::steady_clock::time_point timeout) {
+  assert(GetArchitectures().contains(arch));
+  return GetLoaderDataService().WaitForRuntimes(arch, timeout);
 }
 
 void WindowsPlatform::InitializeFonts(ImGuiIO* io) {
@@ -5,33 +5,56 @@
 #include <wil/com.h>
 #include <wil/resource.h>
 
-#include <condition_variable>
+#include <memory>
 #include <mutex>
 
 #include <d3d11.h>
 #include <dxgi1_2.h>
+#include <imgui.h>
 
 #include "CheckForUpdates.hpp"
 #include "Config.hpp"
 #include "LoaderData.hpp"
+#include "LoaderDataService.hpp"
 #include "Platform.hpp"
 
 namespace FredEmmott::OpenXRLayers {
+
+struct DPIChangeInfo {
+  float mDPIScaling {};
+  std::optional<ImVec2> mRecommendedSize;
+};
+
 class WindowsPlatform final : public Platform {
  public:
   void GUIMain(std::function<void()> drawFrame) override;
+  void RequestFrame(std::chrono::steady_clock::time_point when) override;
 
   std::optional<std::filesystem::path> GetExportFilePath() override;
   std::vector<std::filesystem::path> GetNewAPILayerJSONPaths() override;
-  std::expected<LoaderData, LoaderData::Error> GetLoaderData(
-    Architecture) override;
-  std::expected<LoaderData, LoaderData::Error> WaitForLoaderData(
+  std::expected<std::shared_ptr<const LoaderData>, LoaderData::Error>
+  GetLoaderData(Architecture) override;
+  std::expected<std::shared_ptr<const LoaderData>, LoaderData::Error>
+  WaitForLoaderData(
+    Architecture,
+    std::chrono::steady_clock::time_point timeout) override;
+  void QueryAvailableRuntimes() override;
+  std::shared_ptr<const std::vector<RuntimeLoaderData>>
+  GetAvailableRuntimesLoaderData(Architecture) override;
+  std::shared_ptr<const std::vector<RuntimeLoaderData>>
+  WaitForAvailableRuntimesLoaderData(
     Architecture,
     std::chrono::steady_clock::time_point timeout) override;
 
   float GetDPIScaling() override {
     return mDPIScaling;
   }
+  std::filesystem::path GetUserDataDirectory() override;
+  std::unique_ptr<DirectoryWatcher> WatchDirectory(
+    const std::filesystem::path& directory,
+    std::function<void(const std::filesystem::path&)> callback) override;
+  std::filesystem::path GetExecutableDirectory() override;
+  std::unique_ptr<MappedFile> MapFile(const std::filesystem::path&) override;
   void ShowFolderContainingFile(const std::filesystem::path& path) override;
   std::map<std::string, std::string> GetEnvironmentVariables() override;
 
@@ -66,19 +89,18 @@ class WindowsPlatform final : public Platform {
   wil::com_ptr<ID3D11RenderTargetView> mRenderTargetView;
   bool mWindowClosed = false;
   wil::unique_event mNewFrameEvent;
+  // Only used on the GUI thread
+  std::chrono::steady_clock::time_point mRequestedFrame {
+    std::chrono::steady_clock::time_point::max()};
 
   size_t mFrameCounter = 0;
   ImVec2 mWindowSize {
     Config::MINIMUM_WINDOW_WIDTH,
     Config::MINIMUM_WINDOW_HEIGHT,
   };
-  std::mutex mMutex;
-  bool mLoaderDataIsStale = true;
-  std::condition_variable_any mLoaderDataCondition;
-  std::unordered_map<Architecture, std::expected<LoaderData, LoaderData::Error>>
-    mLoaderData;
-  std::jthread mLoaderDataThread;
-  wil::unique_handle mLoaderDataJob;
+  std::once_flag mLoaderDataServiceOnce;
+  std::unique_ptr<LoaderDataService> mLoaderDataService;
+  boost::signals2::scoped_connection mLoaderDataConnection;
 
   HWND CreateAppWindow();
   void InitializeFonts(ImGuiIO* io);
@@ -91,19 +113,7 @@ class WindowsPlatform final : public Platform {
   void MainLoop(const std::function<void()>& drawFrame);
   void Shutdown();
 
-  struct LoaderDataProcess {
-    wil::unique_handle mProcess;
-    wil::unique_handle mThread;
-    wil::unique_handle mStdoutReadPipe;
-    [[nodiscard]]
-    std::expected<LoaderData, LoaderData::Error> Wait() &&;
-  };
-
-  [[nodiscard]]
-  static std::expected<LoaderDataProcess, LoaderData::Error>
-  SpawnLoaderData(HANDLE hJob, HANDLE hToken, Architecture);
-  void EnsureLoaderDataThread();
-  void LoaderDataThreadMain(std::stop_token);
+  LoaderDataService& GetLoaderDataService();
 
   static LRESULT CALLBACK
   WindowProc(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
@@ -3,8 +3,25 @@
 
 #include "LoaderDataMain.hpp"
 
+#include <fcntl.h>
+#include <io.h>
+
+#include <cstdio>
+#include <string_view>
+
+#include "LoaderDataService.hpp"
+
 // console app, so not actually wWinMain
-int main() {
-  FredEmmott::OpenXRLayers::LoaderDataMain();
+int main(int argc, char** argv) {
+  using namespace FredEmmott::OpenXRLayers;
+  if (
+    argc > 1
+    && std::string_view {argv[1]} == LoaderDataServer::CommandLineFlag) {
+    // Responses are binary, so don't translate '\n' to "\r\n"
+    _setmode(_fileno(stdout), _O_BINARY);
+    LoaderDataServerMain();
+    return 0;
+  }
+  LoaderDataMain();
   return 0;
 }